@@ -14,6 +14,7 @@ let writer = null;
 let readBuffer = '';
 let connected = false;
 let connectionMode = '';
+const telemetry = {};   // reused by the binary frame decoder
 
 // --- DOM Elements ---
 const connectBtn = document.getElementById('connect-btn');
@@ -26,6 +27,10 @@ const upS = document.getElementById('up-s');
 const threadCount = document.getElementById('thread-count');
 const memBar = document.getElementById('mem-bar');
 const memValue = document.getElementById('mem-value');
+const cpuLoad = document.getElementById('cpu-load');
+const wdgStatus = document.getElementById('wdg-status');
+const fwVersion = document.getElementById('fw-version');
+const tempHist = document.getElementById('temp-hist');
 const ledDot = document.getElementById('led-dot');
 const ledState = document.getElementById('led-state');
 const blinkRate = document.getElementById('blink-rate');
@@ -126,6 +131,32 @@ function drawGauge(temp) {
 
 drawGauge(0);
 
+// --- Temperature History (sparkline, one sample per second) ---
+const HIST_MAX = 60;
+const histCtx = tempHist.getContext('2d');
+let histTemps = [];
+let lastTemp = null;
+
+function drawHistory() {
+    const w = tempHist.width;
+    const h = tempHist.height;
+    histCtx.clearRect(0, 0, w, h);
+    if (histTemps.length < 2) return;
+
+    const lo = Math.min(...histTemps) - 0.5;
+    const hi = Math.max(...histTemps) + 0.5;
+    histCtx.beginPath();
+    histTemps.forEach((t, i) => {
+        const x = w - (histTemps.length - 1 - i) * (w / (HIST_MAX - 1));
+        const y = h - 2 - ((t - lo) / (hi - lo)) * (h - 4);
+        if (i === 0) histCtx.moveTo(x, y);
+        else histCtx.lineTo(x, y);
+    });
+    histCtx.strokeStyle = '#ff8c00';
+    histCtx.lineWidth = 1.5;
+    histCtx.stroke();
+}
+
 // --- Terminal ---
 function termLog(text, cls = '') {
     const line = document.createElement('div');
@@ -159,6 +190,7 @@ async function connectWebSocket() {
     try {
         termLog('[ Connecting to ' + WS_URL + '... ]', 'system');
         ws = new WebSocket(WS_URL);
+        ws.binaryType = 'arraybuffer';
 
         ws.onopen = () => {
             connected = true;
@@ -170,13 +202,26 @@ async function connectWebSocket() {
         };
 
         ws.onmessage = (event) => {
+            if (event.data instanceof ArrayBuffer) {
+                // Binary telemetry frame (bridge.py --binary)
+                const view = new DataView(event.data);
+                if (TelemetrySchema.check(view, 0)) {
+                    updateDashboard(TelemetrySchema.decodeInto(view, 0, telemetry));
+                }
+                return;
+            }
             const line = event.data.trim();
             if (line) {
-                termLog(line);
+                let data = null;
                 try {
-                    const data = JSON.parse(line);
-                    updateDashboard(data);
+                    data = JSON.parse(line);
                 } catch (e) { /* not JSON */ }
+                if (data && data.snap !== undefined) {
+                    applySnapshot(data);
+                    return;
+                }
+                termLog(line);
+                if (data) updateDashboard(data);
             }
         };
 
@@ -215,19 +260,43 @@ async function disconnect() {
 }
 
 // --- Update Dashboard ---
+
+// Frames are sent on change (at least every MAX_SILENT_MS), so uptime is
+// counted on locally between them
+let upBase = null;
+let upAt = 0;
+
+function showUptime(up) {
+    const h = Math.floor(up / 3600);
+    const m = Math.floor((up % 3600) / 60);
+    const s = up % 60;
+    upH.textContent = String(h).padStart(2, '0');
+    upM.textContent = String(m).padStart(2, '0');
+    upS.textContent = String(s).padStart(2, '0');
+}
+
+setInterval(() => {
+    if (connected && upBase !== null) {
+        showUptime(upBase + Math.floor((Date.now() - upAt) / 1000));
+    }
+    if (connected && lastTemp !== null) {
+        histTemps.push(lastTemp);
+        if (histTemps.length > HIST_MAX) histTemps.shift();
+        drawHistory();
+    }
+}, 1000);
+
 function updateDashboard(data) {
     if (data.temp !== undefined) {
+        lastTemp = data.temp;
         tempValue.textContent = data.temp.toFixed(1);
         drawGauge(data.temp);
     }
 
     if (data.up !== undefined) {
-        const h = Math.floor(data.up / 3600);
-        const m = Math.floor((data.up % 3600) / 60);
-        const s = data.up % 60;
-        upH.textContent = String(h).padStart(2, '0');
-        upM.textContent = String(m).padStart(2, '0');
-        upS.textContent = String(s).padStart(2, '0');
+        upBase = data.up;
+        upAt = Date.now();
+        showUptime(data.up);
     }
 
     if (data.thds !== undefined) {
@@ -249,6 +318,63 @@ function updateDashboard(data) {
     }
 }
 
+// --- Resync ---
+
+// The whole device state in one message: the bridge's cache on connect,
+// or the board's reply to 'snapshot'.  Sections that did not fit the
+// board's line are simply missing.
+let lastLogSeq = -1;
+let lastSnapT = 0;
+
+function applySnapshot(snap) {
+    // Log entries already shown by an earlier snapshot are skipped,
+    // unless the board has rebooted since
+    if (snap.t < lastSnapT) lastLogSeq = -1;
+    lastSnapT = snap.t;
+
+    const from = snap.board ? 'bridge cache, ' + snap.board : 'board';
+    termLog('[ Resync #' + snap.snap + ' from ' + from + ' ]', 'system');
+
+    if (snap.sys) {
+        const sys = snap.sys;
+        if (sys.heap_total) {
+            const pct = Math.round(sys.heap_used * 100 / sys.heap_total);
+            memBar.style.width = pct + '%';
+            memValue.textContent = pct + '%';
+        }
+        if (sys.cpu !== undefined) cpuLoad.textContent = sys.cpu + '%';
+        if (sys.fw) fwVersion.textContent = sys.fw;
+    }
+
+    if (snap.wdg && snap.wdg.slots) {
+        const slots = snap.wdg.slots;
+        const bad = slots.filter(s => s.state !== 'HEALTHY' && s.state !== 'IDLE');
+        wdgStatus.textContent = (slots.length - bad.length) + '/' + slots.length +
+            (bad.length ? ' ' + bad[0].state : ' OK');
+    }
+
+    if (snap.hist && snap.hist.temp) {
+        histTemps = snap.hist.temp.slice(-HIST_MAX);
+        drawHistory();
+    }
+
+    if (snap.log && snap.log.entries) {
+        snap.log.entries.forEach(e => {
+            if (e.seq <= lastLogSeq) return;
+            lastLogSeq = e.seq;
+            const msg = e.kv ? JSON.stringify(e.kv) : e.msg;
+            termLog('[' + (e.t / 1000).toFixed(3).padStart(9) + '] [' + e.l + '] ' +
+                    e.m + ' ' + msg);
+        });
+    }
+    if (snap.lines) {
+        snap.lines.forEach(l => termLog(l));
+    }
+
+    // Last, so uptime is taken from the freshest values
+    if (snap.telem) updateDashboard(snap.telem);
+}
+
 // --- Send Command ---
 async function sendCommand(cmd, val) {
     if (!connected) return;
@@ -0,0 +1,308 @@
+#!/usr/bin/env python3
+"""
+ShrikeOS Monitor — Board Simulator
+
+Stands in for a Shrike-lite on a PTY pair, so bridge.py can be run and
+load-tested without hardware.  The simulator speaks the firmware's
+serial protocol:
+
+  - telemetry as JSON lines, or as binary frames after 'telem bin'
+    (layout from telemetry_schema.py, generated from the same schema
+    as the firmware), at a fixed rate instead of on change;
+  - dashboard commands ({"cmd":"led"|"blink"|"page"|"oled_msg",...}),
+    answered with a telemetry frame at once like the firmware's
+    send-on-delta filter;
+  - the 'snapshot', 'telem' and 'help' text commands, and the firmware's
+    reply to anything else.  --missing makes it answer some of them the
+    same way, like a firmware without them, so a load test also covers
+    a bridge that cannot resync.
+
+Faults can be injected: bursts of back-to-back frames, stalls in which
+the board neither reads nor writes, and garbage bytes (including stray
+sync bytes) between lines.
+
+In load mode 'up' carries a frame sequence number instead of the
+uptime, so a receiver can match each frame to the time it was sent
+(see loadtest.py).
+
+Usage:
+    python3 board_sim.py [--rate 2] [--binary] [--burst-every S --burst-len N]
+                         [--stall-every S --stall-for S] [--garbage-every S]
+                         [--missing snapshot telem]
+
+It prints the PTY to pass to the bridge:
+    python3 bridge.py --port /dev/pts/N
+"""
+
+import argparse
+import json
+import os
+import random
+import threading
+import time
+import tty
+
+import telemetry_schema as telem
+
+TEXT_COMMANDS = ("snapshot", "telem", "help")
+
+
+class Faults:
+    """Fault injection schedule; 0 disables a fault.  missing lists the
+    text commands answered with "Unknown command"."""
+
+    def __init__(self, burst_every=0, burst_len=20, stall_every=0,
+                 stall_for=1.0, garbage_every=0, missing=()):
+        self.burst_every = burst_every
+        self.burst_len = burst_len
+        self.stall_every = stall_every
+        self.stall_for = stall_for
+        self.garbage_every = garbage_every
+        self.missing = tuple(missing)
+
+
+class SimBoard:
+    """One simulated board on the master side of a PTY pair.
+
+    on_frame(board, seq, t_sent) is called for every telemetry frame
+    written, with the send time (time.monotonic()).
+    """
+
+    def __init__(self, name="sim", rate=2.0, binary=False, faults=None,
+                 load=False, on_frame=None):
+        self.name = name
+        self.rate = rate
+        self.binary = binary
+        self.faults = faults or Faults()
+        self.load = load
+        self.on_frame = on_frame
+
+        self.master, slave = os.openpty()
+        tty.setraw(slave)
+        self.port = os.ttyname(slave)
+        self.slave = slave      # kept open so the PTY survives reopens
+
+        self.t0 = time.monotonic()
+        self.state = {"temp": 30.0, "up": 0, "thds": 9, "led": 1,
+                      "blink": 250}
+        self.seq = 0
+        self.snap_seq = 0
+        self.stalled_until = 0.0
+        self.lock = threading.Lock()    # one writer at a time
+        self.running = False
+
+        self.frames = 0
+        self.commands = 0       # dashboard JSON commands
+        self.requests = 0       # text commands
+        self.unknown = 0        # ...answered "Unknown command"
+        self.garbage = 0
+        self.stalls = 0
+
+    # --- Output ---
+
+    def _write(self, data):
+        with self.lock:
+            while data:
+                n = os.write(self.master, data)
+                data = data[n:]
+
+    def send_line(self, line):
+        self._write((line + "\n").encode("utf-8"))
+
+    def send_frame(self):
+        with self.lock:
+            self.seq += 1
+            values = dict(self.state)
+            values["up"] = (self.seq if self.load else
+                            int(time.monotonic() - self.t0))
+            if self.binary:
+                data = telem.pack(values)
+            else:
+                values["temp"] = round(values["temp"], 1)
+                data = (json.dumps(values, separators=(",", ":")) +
+                        "\n").encode("utf-8")
+            # Recorded first, so a fast receiver never sees it unknown
+            if self.on_frame:
+                self.on_frame(self, values["up"], time.monotonic())
+            while data:
+                n = os.write(self.master, data)
+                data = data[n:]
+            self.frames += 1
+
+    def send_snapshot(self):
+        self.snap_seq += 1
+        t_ms = int((time.monotonic() - self.t0) * 1000)
+        telem_now = dict(self.state, up=t_ms // 1000)
+        snap = {
+            "snap": self.snap_seq, "t": t_ms, "telem": telem_now,
+            "wdg": {"enabled": 1, "timeouts": 0, "recoveries": 0,
+                    "overruns": 0,
+                    "slots": [{"name": n, "state": "HEALTHY",
+                               "timeout_ms": 2000, "beats": t_ms // 500,
+                               "fails": 0, "over": 0}
+                              for n in ("sensor", "display", "heartbeat")]},
+            "sys": {"board": self.name, "fw": "sim", "up": t_ms // 1000,
+                    "cpu": random.randint(5, 20), "heap_total": 16384,
+                    "heap_used": 2048, "threads": self.state["thds"]},
+            "log": {"log_count": 0, "total": 0, "dropped": 0,
+                    "entries": []},
+        }
+        self.send_line(json.dumps(snap, separators=(",", ":")))
+
+    # --- Input ---
+
+    def handle(self, line):
+        if line.startswith("{"):
+            try:
+                msg = json.loads(line)
+            except ValueError:
+                return
+            self.commands += 1
+            cmd, val = msg.get("cmd"), msg.get("val")
+            if cmd == "led":
+                self.state["led"] = 1 if val else 0
+            elif cmd == "blink" and isinstance(val, int) and 50 <= val <= 2000:
+                self.state["blink"] = val
+            elif cmd not in ("page", "oled_msg"):
+                return
+            self.send_frame()
+            return
+
+        words = line.split()
+        self.requests += 1
+        if words[0] in self.faults.missing or words[0] not in TEXT_COMMANDS:
+            self.unknown += 1
+            self.send_line(f"Unknown command: '{words[0]}'. Type 'help'.")
+        elif words == ["snapshot"]:
+            self.send_snapshot()
+        elif words[:1] == ["telem"]:
+            if words[1:] == ["bin"]:
+                self.binary = True
+            elif words[1:] == ["json"]:
+                self.binary = False
+            self.send_line(f"Telemetry: {'binary' if self.binary else 'json'}, "
+                           f"schema v{telem.SCHEMA_VERSION}, simulated "
+                           f"({self.rate:g} Hz)")
+            self.send_frame()
+        elif words == ["help"]:
+            known = [c for c in TEXT_COMMANDS if c not in self.faults.missing]
+            self.send_line(f"Commands: {' '.join(known)} (simulated board)")
+
+    def _reader(self):
+        buf = b""
+        while self.running:
+            if time.monotonic() < self.stalled_until:
+                time.sleep(0.01)
+                continue
+            try:
+                data = os.read(self.master, 256)
+            except OSError:
+                return
+            buf += data
+            while b"\n" in buf:
+                line, buf = buf.split(b"\n", 1)
+                line = line.decode("utf-8", errors="replace").strip()
+                if line:
+                    self.handle(line)
+
+    # --- Telemetry and faults ---
+
+    def _writer(self):
+        f = self.faults
+        period = 1.0 / self.rate
+        now = time.monotonic()
+        next_frame = now
+        next_burst = now + f.burst_every if f.burst_every else None
+        next_stall = now + f.stall_every if f.stall_every else None
+        next_garbage = now + f.garbage_every if f.garbage_every else None
+
+        while self.running:
+            now = time.monotonic()
+            if now < self.stalled_until:
+                time.sleep(min(0.01, self.stalled_until - now))
+                continue
+
+            if next_stall and now >= next_stall:
+                self.stalls += 1
+                self.stalled_until = now + f.stall_for
+                next_stall += f.stall_every
+                continue
+
+            if next_burst and now >= next_burst:
+                for _ in range(f.burst_len):
+                    self.send_frame()
+                next_burst += f.burst_every
+
+            if next_garbage and now >= next_garbage:
+                junk = bytes(random.getrandbits(8) for _ in range(32))
+                junk += bytes([telem.SYNC, 0xA6]) + b"\n"
+                self._write(junk)
+                self.garbage += 1
+                next_garbage += f.garbage_every
+
+            if now >= next_frame:
+                self.state["temp"] = min(65.0, max(15.0, self.state["temp"] +
+                                                    random.uniform(-0.2, 0.2)))
+                self.send_frame()
+                # Skip missed periods instead of bursting
+                while next_frame <= now:
+                    next_frame += period
+
+            wake = [next_frame]
+            wake += [t for t in (next_burst, next_stall, next_garbage) if t]
+            time.sleep(max(0.0, min(wake) - time.monotonic()))
+
+    def start(self):
+        self.running = True
+        for fn in (self._reader, self._writer):
+            threading.Thread(target=fn, daemon=True).start()
+
+    def stop(self):
+        self.running = False
+
+    def summary(self):
+        return (f"{self.name}: {self.frames} frames, {self.commands} "
+                f"commands, {self.requests} text commands ({self.unknown} "
+                f"unknown), {self.stalls} stalls, {self.garbage} garbage")
+
+
+def add_fault_args(parser):
+    parser.add_argument("--burst-every", type=float, default=0,
+                        help="Seconds between bursts of back-to-back frames")
+    parser.add_argument("--burst-len", type=int, default=20,
+                        help="Frames per burst")
+    parser.add_argument("--stall-every", type=float, default=0,
+                        help="Seconds between stalls (no reads or writes)")
+    parser.add_argument("--stall-for", type=float, default=1.0,
+                        help="Length of a stall in seconds")
+    parser.add_argument("--garbage-every", type=float, default=0,
+                        help="Seconds between bursts of garbage bytes")
+    parser.add_argument("--missing", nargs="+", default=[],
+                        choices=[c for c in TEXT_COMMANDS if c != "help"],
+                        help="Text commands the firmware lacks")
+
+
+def faults_from_args(args):
+    return Faults(args.burst_every, args.burst_len, args.stall_every,
+                  args.stall_for, args.garbage_every, args.missing)
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="ShrikeOS board simulator")
+    parser.add_argument("--rate", type=float, default=2.0,
+                        help="Telemetry frames per second")
+    parser.add_argument("--binary", action="store_true",
+                        help="Start with binary telemetry frames")
+    add_fault_args(parser)
+    args = parser.parse_args()
+
+    board = SimBoard(rate=args.rate, binary=args.binary,
+                     faults=faults_from_args(args))
+    board.start()
+    print(f"[SIM] Board on {board.port}; run: python3 bridge.py --port {board.port}")
+    try:
+        while True:
+            time.sleep(1)
+    except KeyboardInterrupt:
+        board.stop()
+        print(f"\n[SIM] {board.summary()}")
@@ -6,23 +6,72 @@ Bridges the Shrike-lite USB serial port to a WebSocket server
 so any browser (including Chromium) can communicate with the board.
 
 Usage:
-    python3 bridge.py [--port /dev/ttyACM0] [--ws-port 8765]
+    python3 bridge.py [--port /dev/ttyACM0] [--ws-port 8765] [--binary]
+                      [--export log|hist ...] [--export-dir DIR]
+
+With --binary the board is switched to fixed-layout binary telemetry
+frames (see telemetry_schema.py, generated from schema/telemetry.json).
+The bridge validates them and forwards them to the dashboard as binary
+WebSocket messages; everything else is still forwarded line by line.
+
+The bridge keeps the latest full state of each board: the board's last
+'snapshot' line (telemetry, sysinfo, watchdog, supervisor, recent
+history and log) with the telemetry and console lines that arrived
+since folded in.  A dashboard that connects, or reconnects, gets it as
+its first message instead of waiting for the traffic to come by.
+
+Writes to the board go through a queue per board and are done off the
+event loop, so a slow or stalled port never holds up the WebSocket
+clients or the serial reader.  Dashboard commands that set a value
+(led, blink, page) are latest-value: while one is waiting, a newer one
+replaces it in its place in the queue, so dragging the blink slider
+sends only the value it ends on.  Everything else is sent once, in
+order.
+
+--export fetches the board's log ring and/or sensor history as
+compressed chunks (see export_stream.py) and writes them to text files,
+resuming by itself after lost chunks.  Exports started from the
+dashboard with the 'export' command are saved the same way.
 
 Then open the dashboard — it will auto-connect to ws://localhost:8765
 """
 
 import asyncio
 import argparse
+import collections
 import json
+import os
+import queue
 import signal
 import sys
+import threading
+import time
 
 import serial
 import websockets
 
+import export_stream as export
+import telemetry_schema as telem
+
+WRITE_QUEUE_MAX = 64    # lines waiting per board, coalesced ones aside
+COALESCE_CMDS = {"led", "blink", "page"}   # latest value wins
+COALESCE_LINES = {"snapshot"}              # idempotent requests
+
+RESYNC_LINES = 50       # console lines kept for a new dashboard
+RESYNC_MAX_AGE = 10     # s; older snapshots are refreshed on connect
+RESYNC_MIN_GAP = 1      # s between snapshot requests
+RESYNC_RETRIES = 3      # unanswered requests before waiting for a client
+UNKNOWN_CMD = "Unknown command: '"         # firmware's reply prefix
+
+TELEM_KEYS = {name for name, _, _ in telem.FIELDS}
+
 # Global state
 serial_port = None
 ws_clients = set()
+boards = {}             # serial port name -> BoardState
+transfers = {}          # stream name -> export.Transfer
+export_queue = []       # streams waiting; the board runs one export at a time
+export_dir = "."
 
 
 def open_serial(port_name, baud=115200):
@@ -37,28 +86,280 @@ def open_serial(port_name, baud=115200):
         sys.exit(1)
 
 
+def coalesce_key(line):
+    """Key under which a newer line replaces a waiting one, or None."""
+    if line in COALESCE_LINES:
+        return line
+    if line.startswith("{"):
+        try:
+            cmd = json.loads(line).get("cmd")
+        except (ValueError, AttributeError):
+            return None
+        if cmd in COALESCE_CMDS:
+            return "cmd:" + cmd
+    return None
+
+
+class SerialWriter:
+    """Write queue of one board; the only writer of its port.
+
+    put() never blocks.  run() hands the lines one at a time, in queue
+    order, to a thread that does the blocking write; until that returns
+    the next line stays in the queue, where it can still be coalesced.
+    A line with a coalesce key replaces the waiting line with the same
+    key, keeping that line's place, so it still goes out before
+    anything queued after it.
+    """
+
+    def __init__(self, ser):
+        self.ser = ser
+        self.queue = collections.deque()    # [key, line]
+        self.waiting = {}                   # key -> its entry in queue
+        self.wake = asyncio.Event()
+        self.handoff = queue.SimpleQueue()
+        self.written = 0
+        self.coalesced = 0
+        self.dropped = 0
+        self.peak = 0
+
+    def put(self, line):
+        key = coalesce_key(line)
+        entry = self.waiting.get(key) if key else None
+        if entry:
+            entry[1] = line
+            self.coalesced += 1
+            return
+        if len(self.queue) - len(self.waiting) >= WRITE_QUEUE_MAX and not key:
+            self.dropped += 1
+            print(f"[BRIDGE] Write queue full, dropped: {line}")
+            return
+        entry = [key, line]
+        self.queue.append(entry)
+        if key:
+            self.waiting[key] = entry
+        self.peak = max(self.peak, len(self.queue))
+        self.wake.set()
+
+    def _write_thread(self, loop):
+        # Daemon: a board that stopped reading must not hold up exit
+        while True:
+            data, done = self.handoff.get()
+            try:
+                self.ser.write(data)
+                err = None
+            except Exception as e:
+                err = e
+            loop.call_soon_threadsafe(done.set_result, err)
+
+    async def run(self):
+        loop = asyncio.get_running_loop()
+        threading.Thread(target=self._write_thread, args=(loop,),
+                         daemon=True).start()
+        while True:
+            if not self.queue:
+                self.wake.clear()
+                await self.wake.wait()
+                continue
+            key, line = self.queue.popleft()
+            if key:
+                del self.waiting[key]
+            done = loop.create_future()
+            self.handoff.put(((line + "\n").encode("utf-8"), done))
+            err = await done
+            if err:
+                self.dropped += 1
+                print(f"[BRIDGE] Serial write error: {err}")
+            else:
+                self.written += 1
+
+    def summary(self):
+        return (f"{self.written} lines written, {self.coalesced} coalesced, "
+                f"{self.dropped} dropped, queue peak {self.peak}")
+
+
+class BoardState:
+    """Latest known state of one board, for dashboards that connect late.
+
+    Starts from the board's last snapshot line and folds in what came
+    after it: telemetry, as JSON lines or binary frames, and console
+    lines (the snapshot's own log covers those before it).
+    """
+
+    def __init__(self, name, writer):
+        self.name = name
+        self.writer = writer
+        self.snap = None
+        self.snap_at = 0.0
+        self.requested = 0.0
+        self.unanswered = 0
+        self.unsupported = False    # firmware without 'snapshot'
+        self.telem = {}
+        self.lines = collections.deque(maxlen=RESYNC_LINES)
+
+    def feed(self, item):
+        """Fold an item into the state; False if it is the board's
+        answer to the bridge's own request and not for the clients."""
+        if isinstance(item, bytes):
+            telem.decode_into(item, 0, self.telem)
+            return True
+        if item.startswith(UNKNOWN_CMD + "snapshot'"):
+            if not self.unsupported:
+                print(f"[BRIDGE] {self.name}: firmware has no 'snapshot' "
+                      f"command, dashboards resync from telemetry only")
+            self.unsupported = True
+            return False
+        if item.startswith(UNKNOWN_CMD + "telem'"):
+            print(f"[BRIDGE] {self.name}: firmware has no 'telem' command, "
+                  f"telemetry stays JSON")
+            return True
+        try:
+            data = json.loads(item)
+        except ValueError:
+            data = None
+        if isinstance(data, dict) and "snap" in data:
+            self.snap = data
+            self.snap_at = time.monotonic()
+            self.unanswered = 0
+            self.telem = dict(data.get("telem", {}))
+            self.lines.clear()
+        elif isinstance(data, dict) and data and data.keys() <= TELEM_KEYS:
+            self.telem.update(data)
+        else:
+            self.lines.append(item)
+        return True
+
+    def request(self):
+        """Ask the board for a fresh snapshot unless one is on its way
+        or recent."""
+        if self.unsupported:
+            return
+        now = time.monotonic()
+        if now - self.requested < RESYNC_MIN_GAP:
+            return
+        if self.snap is not None and now - self.snap_at < RESYNC_MAX_AGE:
+            return
+        self.requested = now
+        self.unanswered += 1
+        self.writer.put("snapshot")
+
+    def retry(self):
+        """Repeat a request the board was not up to answer yet."""
+        if self.snap is None and 0 < self.unanswered < RESYNC_RETRIES:
+            self.request()
+
+    def resync_message(self):
+        """Everything known, shaped like a snapshot line, or None."""
+        if self.snap is None and not self.telem:
+            return None
+        msg = dict(self.snap or {})
+        msg["board"] = self.name
+        msg["telem"] = dict(self.telem)
+        msg["lines"] = list(self.lines)
+        return json.dumps(msg)
+
+
+def split_stream(buf, items):
+    """Move complete items from the front of buf into items.
+
+    An item is either a binary telemetry frame (bytes) or export chunk
+    (export.Chunk), recognised by their sync bytes at an item boundary,
+    or a text line (str).  Returns the unconsumed remainder.
+    """
+    pos = 0
+    while pos < len(buf):
+        if buf[pos] == export.SYNC:
+            total = export.frame_len(buf, pos)
+            if total == 0:
+                break
+            if total > 0 and export.check_frame(buf, pos, total):
+                try:
+                    items.append(export.Chunk(bytes(buf[pos:pos + total])))
+                except ValueError as e:
+                    print(f"[BRIDGE] Dropped undecodable export chunk: {e}")
+                pos += total
+                continue
+            print("[BRIDGE] Dropped corrupt export chunk")
+            pos += 1
+            continue
+
+        if buf[pos] == telem.SYNC:
+            if len(buf) - pos < telem.FRAME_LEN:
+                break
+            if telem.check_frame(buf, pos):
+                items.append(bytes(buf[pos:pos + telem.FRAME_LEN]))
+                pos += telem.FRAME_LEN
+                continue
+            print("[BRIDGE] Dropped corrupt telemetry frame")
+            pos += 1
+            continue
+
+        nl = buf.find(b"\n", pos)
+        if nl < 0:
+            break
+        line_str = buf[pos:nl].decode("utf-8", errors="replace").strip()
+        if line_str:
+            items.append(line_str)
+        pos = nl + 1
+    return buf[pos:]
+
+
+def serial_request(line):
+    if serial_port and serial_port.is_open:
+        boards[serial_port.port].writer.put(line)
+
+
+def start_export(stream, start=0, send=True):
+    stamp = time.strftime("%Y%m%d-%H%M%S")
+    path = os.path.join(export_dir, f"{stream}-{stamp}.txt")
+    t = export.Transfer(stream, path, serial_request, start)
+    transfers[stream] = t
+    if send:
+        t.begin()
+    return t
+
+
+def export_chunk(chunk):
+    """Hand a chunk to its transfer; one started elsewhere (e.g. by a
+    dashboard command) gets a transfer from its first chunk on."""
+    t = transfers.get(chunk.stream)
+    if (t is None or t.done) and chunk.start:
+        t = start_export(chunk.stream, chunk.first, send=False)
+    if t:
+        t.feed(chunk)
+
+
 async def serial_reader(ser):
-    """Read lines from serial and broadcast to all WebSocket clients."""
+    """Read lines and frames from serial and broadcast to all WebSocket clients."""
     loop = asyncio.get_event_loop()
+    board = boards[ser.port]
     buf = b""
+    items = []
 
     while True:
         try:
             data = await loop.run_in_executor(None, ser.read, 256)
             if data:
-                buf += data
-                while b"\n" in buf:
-                    line, buf = buf.split(b"\n", 1)
-                    line_str = line.decode("utf-8", errors="replace").strip()
-                    if line_str:
-                        # Broadcast to all connected WebSocket clients
-                        if ws_clients:
-                            await asyncio.gather(
-                                *[client.send(line_str) for client in ws_clients],
-                                return_exceptions=True,
-                            )
+                buf = split_stream(buf + data, items)
+                for item in items:
+                    if isinstance(item, export.Chunk):
+                        export_chunk(item)
+                        continue
+                    if not board.feed(item):
+                        continue
+                    # Broadcast to all connected WebSocket clients
+                    if ws_clients:
+                        await asyncio.gather(
+                            *[client.send(item) for client in ws_clients],
+                            return_exceptions=True,
+                        )
+                items.clear()
+                board.retry()
             else:
                 await asyncio.sleep(0.05)
+            for t in transfers.values():
+                t.poll()
+            if export_queue and all(t.done for t in transfers.values()):
+                start_export(export_queue.pop(0))
         except Exception as e:
             print(f"[BRIDGE] Serial read error: {e}")
             await asyncio.sleep(1)
@@ -70,12 +371,21 @@ async def ws_handler(websocket):
     remote = websocket.remote_address
     print(f"[BRIDGE] Dashboard connected from {remote}")
 
+    # Frames are sent on change only; seed the client with everything
+    # known, and refresh that from the board if it is getting old
+    for board in boards.values():
+        msg = board.resync_message()
+        if msg:
+            await websocket.send(msg)
+        board.unanswered = 0
+        board.request()
+
     try:
         async for message in websocket:
             # Forward commands from browser to serial
             msg = message.strip()
-            if msg and serial_port and serial_port.is_open:
-                serial_port.write((msg + "\n").encode("utf-8"))
+            if msg:
+                serial_request(msg)
                 print(f"[BRIDGE] TX → Board: {msg}")
     except websockets.exceptions.ConnectionClosed:
         pass
@@ -84,10 +394,18 @@ async def ws_handler(websocket):
         print(f"[BRIDGE] Dashboard disconnected from {remote}")
 
 
-async def main(serial_dev, ws_port):
+async def main(serial_dev, ws_port, binary, exports):
     global serial_port
 
     serial_port = open_serial(serial_dev)
+    writer = SerialWriter(serial_port)
+    board = boards[serial_port.port] = BoardState(serial_port.port, writer)
+    if binary:
+        writer.put("telem bin")
+        print(f"[BRIDGE] Binary telemetry, schema v{telem.SCHEMA_VERSION} "
+              f"({telem.FRAME_LEN} bytes/frame)")
+    board.request()
+    export_queue.extend(exports)
 
     # Start WebSocket server
     print(f"[BRIDGE] WebSocket server on ws://localhost:{ws_port}")
@@ -95,18 +413,31 @@ async def main(serial_dev, ws_port):
     print(f"[BRIDGE] Press Ctrl+C to stop\n")
 
     async with websockets.serve(ws_handler, "localhost", ws_port):
-        await serial_reader(serial_port)
+        await asyncio.gather(serial_reader(serial_port), writer.run())
 
 
 if __name__ == "__main__":
     parser = argparse.ArgumentParser(description="ShrikeOS Serial-WebSocket Bridge")
     parser.add_argument("--port", default="/dev/ttyACM0", help="Serial port")
     parser.add_argument("--ws-port", type=int, default=8765, help="WebSocket port")
+    parser.add_argument("--binary", action="store_true",
+                        help="Switch the board to binary telemetry frames")
+    parser.add_argument("--export", action="append", default=[],
+                        choices=["log", "hist"],
+                        help="Fetch the log ring or sensor history to a file")
+    parser.add_argument("--export-dir", default=".",
+                        help="Directory for exported files")
     args = parser.parse_args()
+    export_dir = args.export_dir
 
     try:
-        asyncio.run(main(args.port, args.ws_port))
+        asyncio.run(main(args.port, args.ws_port, args.binary, args.export))
     except KeyboardInterrupt:
         print("\n[BRIDGE] Stopped.")
+        for board in boards.values():
+            print(f"[BRIDGE] {board.name}: {board.writer.summary()}")
         if serial_port:
+            if args.binary:
+                # Leave the board readable from a plain terminal
+                serial_port.write(b"telem json\n")
             serial_port.close()
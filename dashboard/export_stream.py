@@ -0,0 +1,206 @@
+"""
+ShrikeOS Monitor — Bulk Export Decoder
+
+Parses the compressed export chunks sent by the firmware's 'export'
+command (layout in src/export.h), decompresses their LZ4 blocks and
+reassembles each stream by record number, asking the board to resume
+from the last good chunk when one is lost or corrupted.
+"""
+
+import time
+
+SYNC = 0xA6
+HDR_LEN = 15
+CRC_LEN = 2
+CHUNK_RAW_MAX = 1024
+
+F_LZ4 = 0x01
+F_LAST = 0x02
+F_START = 0x04
+
+STREAMS = {ord("L"): "log", ord("H"): "hist"}
+
+
+def crc16_ccitt(buf, start, end, seed=0):
+    """CRC-16, reflected poly 0x8408 (Zephyr crc16_ccitt)."""
+    crc = seed
+    for i in range(start, end):
+        e = (crc ^ buf[i]) & 0xFF
+        f = (e ^ (e << 4)) & 0xFF
+        crc = ((crc >> 8) ^ (f << 8) ^ (f << 3) ^ (f >> 4)) & 0xFFFF
+    return crc
+
+
+def _lz4_length(src, i, base):
+    """Extend a 4-bit length field with 255-runs; return (length, i)."""
+    n = base
+    if base == 15:
+        while True:
+            if i >= len(src):
+                raise ValueError("LZ4 length runs past end of block")
+            b = src[i]
+            i += 1
+            n += b
+            if b != 255:
+                break
+    return n, i
+
+
+def lz4_block_decode(src, raw_len):
+    """Decompress one LZ4 block whose decoded size is raw_len.
+
+    Malformed input (truncated fields, bad offsets, output overrunning
+    raw_len) raises ValueError, never IndexError.
+    """
+    out = bytearray()
+    i, n = 0, len(src)
+
+    while i < n:
+        token = src[i]
+        i += 1
+
+        lit, i = _lz4_length(src, i, token >> 4)
+        if i + lit > n:
+            raise ValueError("LZ4 literals run past end of block")
+        out += src[i:i + lit]
+        i += lit
+        if i >= n:
+            break               # last sequence has no match
+
+        if i + 2 > n:
+            raise ValueError("LZ4 match offset truncated")
+        off = src[i] | (src[i + 1] << 8)
+        i += 2
+        mlen, i = _lz4_length(src, i, token & 0x0F)
+        mlen += 4
+
+        start = len(out) - off
+        if off == 0 or start < 0:
+            raise ValueError("LZ4 offset out of range")
+        if len(out) + mlen > raw_len:
+            raise ValueError("LZ4 output exceeds expected length")
+        if off >= mlen:
+            out += out[start:start + mlen]
+        else:
+            for k in range(mlen):   # overlapping copy repeats a pattern
+                out.append(out[start + k])
+
+    if len(out) != raw_len:
+        raise ValueError(f"LZ4 decoded {len(out)} bytes, expected {raw_len}")
+    return bytes(out)
+
+
+def frame_len(buf, off=0):
+    """Total length of the chunk at off, 0 if more bytes are needed,
+    or -1 if the header cannot be a chunk."""
+    if len(buf) - off < HDR_LEN:
+        return 0
+    raw_len = buf[off + 11] | (buf[off + 12] << 8)
+    pay_len = buf[off + 13] | (buf[off + 14] << 8)
+    if (buf[off + 1] not in STREAMS or raw_len > CHUNK_RAW_MAX
+            or pay_len > CHUNK_RAW_MAX):
+        return -1
+    total = HDR_LEN + pay_len + CRC_LEN
+    return total if len(buf) - off >= total else 0
+
+
+def check_frame(buf, off, total):
+    end = off + total - CRC_LEN
+    crc = buf[end] | (buf[end + 1] << 8)
+    return crc16_ccitt(buf, off + 1, end) == crc
+
+
+class Chunk:
+    """One validated export chunk."""
+
+    def __init__(self, frame):
+        self.stream = STREAMS[frame[1]]
+        flags = frame[2]
+        self.last = bool(flags & F_LAST)
+        self.start = bool(flags & F_START)
+        self.first = int.from_bytes(frame[3:7], "little")
+        self.next = int.from_bytes(frame[7:11], "little")
+        self.raw_len = frame[11] | (frame[12] << 8)
+        self.wire_len = len(frame)
+        payload = frame[HDR_LEN:len(frame) - CRC_LEN]
+        if flags & F_LZ4:
+            self.text = lz4_block_decode(payload, self.raw_len)
+        else:
+            self.text = bytes(payload)
+
+
+class Transfer:
+    """Reassembles one export stream into a file.
+
+    request(cmd) sends a command line to the board.  After each request
+    the bridge waits for a chunk flagged START, so chunks still in
+    flight from an earlier request are ignored.  A gap after that means
+    a chunk was lost or corrupted and the transfer resumes from the last
+    good record; a START chunk beginning later than requested means the
+    ring had already overwritten those records, which are counted as
+    lost.
+    """
+
+    STALL_S = 3.0
+
+    def __init__(self, stream, path, request, start=0):
+        self.stream = stream
+        self.path = path
+        self.request = request
+        self.expect = start
+        self.data = bytearray()
+        self.wire = 0
+        self.lost = 0
+        self.resumes = 0
+        self.awaiting_start = True
+        self.done = False
+        self.t0 = time.monotonic()
+        self.last_rx = self.t0
+
+    def begin(self):
+        self.awaiting_start = True
+        self.last_rx = time.monotonic()
+        self.request(f"export {self.stream} {self.expect}")
+
+    def resume(self, why):
+        self.resumes += 1
+        print(f"[EXPORT] {self.stream}: {why}, resuming from {self.expect}")
+        self.begin()
+
+    def feed(self, chunk):
+        if self.done or chunk.stream != self.stream:
+            return
+        self.last_rx = time.monotonic()
+        self.wire += chunk.wire_len
+
+        if self.awaiting_start:
+            if not chunk.start or chunk.first < self.expect:
+                return          # left over from an earlier request
+            self.awaiting_start = False
+            self.lost += chunk.first - self.expect
+        elif chunk.first > self.expect:
+            self.resume(f"gap before record {chunk.first}")
+            return
+        elif chunk.first < self.expect:
+            return
+
+        self.data += chunk.text
+        self.expect = chunk.next
+        if chunk.last:
+            self.finish()
+
+    def poll(self):
+        """Call periodically; resumes a transfer that went quiet."""
+        if not self.done and time.monotonic() - self.last_rx > self.STALL_S:
+            self.resume("stalled")
+
+    def finish(self):
+        self.done = True
+        secs = time.monotonic() - self.t0
+        with open(self.path, "wb") as f:
+            f.write(self.data)
+        ratio = self.wire / len(self.data) * 100 if self.data else 0
+        print(f"[EXPORT] {self.stream}: {len(self.data)} B text in "
+              f"{self.wire} B on the wire ({ratio:.0f}%), {secs:.2f} s, "
+              f"{self.resumes} resumes, {self.lost} records already "
+              f"overwritten -> {self.path}")
@@ -0,0 +1,263 @@
+#!/usr/bin/env python3
+"""
+ShrikeOS Monitor — Bridge Load Test
+
+Runs N simulated boards (board_sim.py), one bridge.py process per board
+as in a real deployment, and M WebSocket clients per bridge, then
+reports:
+
+  - telemetry frames sent and delivered, per second;
+  - end-to-end latency percentiles, from the board writing a frame to a
+    client receiving it;
+  - dashboard commands sent and reaching the boards (the bridge
+    coalesces latest-value commands), both counted over the measured
+    window;
+  - text commands the boards answered "Unknown command" to over the
+    whole run, with --missing;
+  - CPU and peak memory of the bridge processes (Linux /proc).
+
+Usage:
+    python3 loadtest.py [--boards 1] [--clients 1] [--rate 2] [--duration 10]
+                        [--binary] [--cmd-rate 0] [fault options, see
+                        board_sim.py]
+
+For example, 4 boards at 50 frames/s with 3 dashboards each, the
+clients dragging the blink slider at 20 Hz and the boards stalling
+for 0.5 s every 5 s:
+
+    python3 loadtest.py --boards 4 --clients 3 --rate 50 --cmd-rate 20 \\
+                        --stall-every 5 --stall-for 0.5
+"""
+
+import argparse
+import asyncio
+import json
+import os
+import signal
+import subprocess
+import sys
+import time
+
+import websockets
+
+import board_sim
+import telemetry_schema as telem
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+BRIDGE = os.path.join(HERE, "bridge.py")
+BASE_WS_PORT = 18765
+CLK_TCK = os.sysconf("SC_CLK_TCK")
+
+
+class Stats:
+    """What the simulated boards sent and what the clients received."""
+
+    def __init__(self):
+        self.sent = {}          # (board name, seq) -> send time
+        self.counting = False
+        self.frames_sent = 0
+        self.frames_recv = 0
+        self.latencies = []
+        self.cmds_sent = 0
+        self.garbage_recv = 0
+
+    def on_frame(self, board, seq, t):
+        if self.counting:
+            self.sent[(board.name, seq)] = t
+            self.frames_sent += 1
+
+    def on_recv(self, board, seq):
+        t = self.sent.get((board, seq))
+        if t is not None:
+            self.latencies.append(time.monotonic() - t)
+            self.frames_recv += 1
+
+
+def percentile(values, p):
+    if not values:
+        return float("nan")
+    values = sorted(values)
+    return values[min(len(values) - 1, int(len(values) * p / 100))]
+
+
+def proc_times(pid):
+    """CPU seconds used by a process so far."""
+    with open(f"/proc/{pid}/stat") as f:
+        fields = f.read().rsplit(")", 1)[1].split()
+    return (int(fields[11]) + int(fields[12])) / CLK_TCK
+
+
+def proc_peak_rss(pid):
+    """Peak resident memory of a process in bytes."""
+    with open(f"/proc/{pid}/status") as f:
+        for line in f:
+            if line.startswith("VmHWM:"):
+                return int(line.split()[1]) * 1024
+    return 0
+
+
+async def wait_for_port(port, timeout=10.0):
+    end = time.monotonic() + timeout
+    while time.monotonic() < end:
+        try:
+            _, w = await asyncio.open_connection("localhost", port)
+            w.close()
+            return True
+        except OSError:
+            await asyncio.sleep(0.1)
+    return False
+
+
+async def client(board, ws_port, stats, cmd_rate, stop):
+    """One dashboard: decode telemetry and optionally drag the slider."""
+    frame = {}
+    async with websockets.connect(f"ws://localhost:{ws_port}",
+                                  max_size=None) as ws:
+
+        async def commands():
+            blink = 50
+            while not stop.is_set():
+                await asyncio.sleep(1.0 / cmd_rate)
+                blink = 50 if blink >= 2000 else blink + 10
+                await ws.send(json.dumps({"cmd": "blink", "val": blink}))
+                if stats.counting:
+                    stats.cmds_sent += 1
+
+        sender = asyncio.create_task(commands()) if cmd_rate else None
+        try:
+            while not stop.is_set():
+                try:
+                    msg = await asyncio.wait_for(ws.recv(), 0.2)
+                except asyncio.TimeoutError:
+                    continue
+                if isinstance(msg, bytes):
+                    if telem.check_frame(msg, 0):
+                        telem.decode_into(msg, 0, frame)
+                        stats.on_recv(board, frame["up"])
+                    continue
+                try:
+                    data = json.loads(msg)
+                except ValueError:
+                    stats.garbage_recv += 1
+                    continue
+                if isinstance(data, dict) and "snap" not in data \
+                        and "up" in data:
+                    stats.on_recv(board, data["up"])
+        finally:
+            if sender:
+                sender.cancel()
+
+
+async def run(args):
+    stats = Stats()
+    faults = board_sim.faults_from_args(args)
+    boards, bridges = [], []
+
+    for i in range(args.boards):
+        b = board_sim.SimBoard(name=f"sim{i}", rate=args.rate, load=True,
+                               faults=faults, on_frame=stats.on_frame)
+        cmd = [sys.executable, BRIDGE, "--port", b.port,
+               "--ws-port", str(BASE_WS_PORT + i)]
+        if args.binary:
+            cmd.append("--binary")
+        bridges.append(subprocess.Popen(cmd, cwd=HERE,
+                                        stdout=subprocess.DEVNULL,
+                                        stderr=subprocess.DEVNULL))
+        boards.append(b)
+
+    try:
+        for i in range(args.boards):
+            if not await wait_for_port(BASE_WS_PORT + i):
+                print(f"[LOAD] Bridge {i} did not come up")
+                return 1
+
+        for b in boards:
+            b.start()
+        stop = asyncio.Event()
+        clients = [asyncio.create_task(
+                       client(b.name, BASE_WS_PORT + i, stats,
+                              args.cmd_rate, stop))
+                   for i, b in enumerate(boards)
+                   for _ in range(args.clients)]
+
+        # Let the clients connect and take their resync message first
+        await asyncio.sleep(1.0)
+        cpu0 = [proc_times(p.pid) for p in bridges]
+        cmds0 = sum(b.commands for b in boards)
+        t0 = time.monotonic()
+        stats.counting = True
+        await asyncio.sleep(args.duration)
+        stats.counting = False
+        elapsed = time.monotonic() - t0
+        cpu1 = [proc_times(p.pid) for p in bridges]
+        cmds1 = sum(b.commands for b in boards)
+
+        # Frames still in flight
+        await asyncio.sleep(1.0)
+        stop.set()
+        for b in boards:
+            b.stop()
+        await asyncio.gather(*clients, return_exceptions=True)
+        rss = [proc_peak_rss(p.pid) for p in bridges]
+    finally:
+        for p in bridges:
+            p.send_signal(signal.SIGINT)
+        for p in bridges:
+            try:
+                p.wait(5)
+            except subprocess.TimeoutExpired:
+                p.kill()
+
+    expected = stats.frames_sent * args.clients
+    lat = [x * 1000 for x in stats.latencies]
+    cpu = [(c1 - c0) * 100 / elapsed for c0, c1 in zip(cpu0, cpu1)]
+    faults_on = [n for n in ("burst", "stall", "garbage")
+                 if getattr(faults, n + "_every")]
+    faults_on += [f"no {c}" for c in faults.missing]
+
+    print(f"Boards     : {args.boards} x {args.rate:g} frames/s, "
+          f"{'binary' if args.binary else 'json'}, "
+          f"faults: {', '.join(faults_on) or 'none'}")
+    print(f"Clients    : {args.clients} per board, {elapsed:.1f} s")
+    print(f"Sent       : {stats.frames_sent} frames "
+          f"({stats.frames_sent / elapsed:.1f}/s)")
+    print(f"Delivered  : {stats.frames_recv} of {expected} "
+          f"({stats.frames_recv * 100 / max(expected, 1):.1f}%), "
+          f"{stats.frames_recv / elapsed:.1f}/s")
+    print(f"Latency ms : p50 {percentile(lat, 50):.2f}  "
+          f"p90 {percentile(lat, 90):.2f}  p99 {percentile(lat, 99):.2f}  "
+          f"max {max(lat, default=float('nan')):.2f}")
+    if args.cmd_rate:
+        print(f"Commands   : {stats.cmds_sent} sent, {cmds1 - cmds0} "
+              f"reached the boards")
+    # Over the whole run: the bridge asks for a snapshot as it connects
+    unknown = sum(b.unknown for b in boards)
+    if unknown:
+        print(f"Unknown    : {unknown} of {sum(b.requests for b in boards)} "
+              f"text commands rejected by the boards (no resync)")
+    if stats.garbage_recv:
+        print(f"Non-JSON   : {stats.garbage_recv} lines forwarded")
+    print(f"Bridge CPU : {sum(cpu) / len(cpu):.1f}% avg, {max(cpu):.1f}% "
+          f"max per process")
+    print(f"Bridge RSS : {max(rss) / 1e6:.1f} MB peak per process")
+    return 0
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="ShrikeOS bridge load test")
+    parser.add_argument("--boards", type=int, default=1,
+                        help="Simulated boards, one bridge each")
+    parser.add_argument("--clients", type=int, default=1,
+                        help="WebSocket clients per bridge")
+    parser.add_argument("--rate", type=float, default=2.0,
+                        help="Telemetry frames per second per board")
+    parser.add_argument("--duration", type=float, default=10.0,
+                        help="Measured seconds")
+    parser.add_argument("--binary", action="store_true",
+                        help="Binary telemetry frames (bridge --binary)")
+    parser.add_argument("--cmd-rate", type=float, default=0,
+                        help="Blink commands per second per client")
+    board_sim.add_fault_args(parser)
+    args = parser.parse_args()
+
+    sys.exit(asyncio.run(run(args)))
@@ -0,0 +1,57 @@
+/* ============================================================
+   ShrikeOS Monitor — Telemetry Schema
+   Generated by scripts/gen_telemetry.py from schema/telemetry.json.  Do not edit.
+   ============================================================ */
+
+const TelemetrySchema = (() => {
+    const VERSION = 1;
+    const PERIOD_MS = 500;
+    const MAX_SILENT_MS = 5000;
+    const SYNC = 0xA5;
+    const PAYLOAD_LEN = 10;
+    const FRAME_LEN = 14;
+
+    // Wire order
+    const FIELDS = Object.freeze([
+        { name: 'temp', unit: 'C', scale: 10 },
+        { name: 'up', unit: 's', scale: 1 },
+        { name: 'thds', unit: '', scale: 1 },
+        { name: 'led', unit: '', scale: 1 },
+        { name: 'blink', unit: 'ms', scale: 1 },
+    ]);
+
+    // CRC-8, poly 0x07, init 0 (Zephyr crc8_ccitt)
+    function crc8(view, start, end) {
+        let crc = 0;
+        for (let i = start; i < end; i++) {
+            crc ^= view.getUint8(i);
+            for (let b = 0; b < 8; b++) {
+                crc = (crc & 0x80) ? ((crc << 1) ^ 0x07) & 0xFF : (crc << 1) & 0xFF;
+            }
+        }
+        return crc;
+    }
+
+    // True if a complete, valid frame starts at view[off]
+    function check(view, off = 0) {
+        return view.byteLength - off >= FRAME_LEN &&
+            view.getUint8(off) === SYNC &&
+            view.getUint8(off + 1) === VERSION &&
+            view.getUint8(off + 2) === PAYLOAD_LEN &&
+            crc8(view, off + 1, off + FRAME_LEN - 1) === view.getUint8(off + FRAME_LEN - 1);
+    }
+
+    // Decode into a caller-owned object; nothing is allocated
+    function decodeInto(view, off, out) {
+        out.temp = view.getInt16(off + 3, true) / 10;
+        out.up = view.getUint32(off + 5, true);
+        out.thds = view.getUint8(off + 9);
+        out.led = view.getUint8(off + 10);
+        out.blink = view.getUint16(off + 11, true);
+        return out;
+    }
+
+    return Object.freeze({ VERSION, PERIOD_MS, MAX_SILENT_MS, SYNC, FRAME_LEN, FIELDS, check, decodeInto });
+})();
+
+if (typeof module !== 'undefined') module.exports = TelemetrySchema;
@@ -0,0 +1,74 @@
+"""
+ShrikeOS Monitor — Telemetry Schema
+
+Generated by scripts/gen_telemetry.py from schema/telemetry.json.  Do not edit.
+"""
+
+import struct
+
+SCHEMA_VERSION = 1
+PERIOD_MS = 500
+MAX_SILENT_MS = 5000
+
+SYNC = 0xA5
+HDR_LEN = 3
+PAYLOAD_LEN = 10
+FRAME_LEN = 14
+
+# (name, unit, scale) in wire order
+FIELDS = (
+    ('temp', 'C', 10),
+    ('up', 's', 1),
+    ('thds', '', 1),
+    ('led', '', 1),
+    ('blink', 'ms', 1),
+)
+
+# Payload layout after the 3-byte header, in wire order
+PAYLOAD = struct.Struct("<hIBBH")
+
+
+def crc8(buf, start, end):
+    """CRC-8, poly 0x07, init 0 (Zephyr crc8_ccitt)."""
+    crc = 0
+    for i in range(start, end):
+        crc ^= buf[i]
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def check_frame(buf, off=0):
+    """True if a complete, valid frame starts at buf[off]."""
+    return (len(buf) - off >= FRAME_LEN
+            and buf[off] == SYNC
+            and buf[off + 1] == SCHEMA_VERSION
+            and buf[off + 2] == PAYLOAD_LEN
+            and crc8(buf, off + 1, off + FRAME_LEN - 1) == buf[off + FRAME_LEN - 1])
+
+
+def decode_into(buf, off, out):
+    """Decode the frame at buf[off] into the caller's dict (no copies of buf)."""
+    v = PAYLOAD.unpack_from(buf, off + HDR_LEN)
+    out['temp'] = v[0] / 10
+    out['up'] = v[1]
+    out['thds'] = v[2]
+    out['led'] = v[3]
+    out['blink'] = v[4]
+    return out
+
+
+def pack(values):
+    """Encode a frame from a dict of decoded field values (telemetry_pack())."""
+    buf = bytearray(FRAME_LEN)
+    buf[0] = SYNC
+    buf[1] = SCHEMA_VERSION
+    buf[2] = PAYLOAD_LEN
+    PAYLOAD.pack_into(buf, HDR_LEN,
+                      round(values['temp'] * 10),
+                      values['up'],
+                      values['thds'],
+                      1 if values['led'] else 0,
+                      values['blink'])
+    buf[-1] = crc8(buf, 1, FRAME_LEN - 1)
+    return bytes(buf)
@@ -0,0 +1,176 @@
+#!/usr/bin/env python3
+"""
+ShrikeOS Monitor — RAM Table Generator
+
+Reads the section headers and symbol tables of the application library
+(libapp.a) with objdump and writes a C table of the RAM each module
+takes statically, for the 'ram' command:
+
+    <out>/ram_table.c    per-module .data/.bss/.noinit sizes and the
+                         largest RAM symbols, declared in src/ram.h
+
+A section counts as RAM when it is allocated, writable and not code.
+.noinit sections (thread stacks, the log ring) are counted apart from
+.bss, since the kernel does not clear them.  The table is compiled into
+its own library after libapp.a is built, so it never describes itself.
+
+    python3 scripts/gen_ram_table.py --lib build/app/libapp.a --out /tmp
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+BANNER = "Generated by scripts/gen_ram_table.py from libapp.a.  Do not edit."
+TOP_SYMBOLS = 12
+
+MEMBER_RE = re.compile(r"^(\S+):\s+file format")
+SECTION_RE = re.compile(r"^\s*\d+\s+(\S+)\s+([0-9a-fA-F]+)\s")
+# value, 7 flag characters, section, size, name
+SYMBOL_RE = re.compile(r"^[0-9a-fA-F]+ (.{7}) (\S+)\t([0-9a-fA-F]+)\s+(\S+)$")
+
+
+def module_name(member):
+    name = os.path.basename(member)
+    for ext in (".c.obj", ".obj", ".o"):
+        if name.endswith(ext):
+            return name[:-len(ext)]
+    return name
+
+
+def ram_class(name, flags):
+    """'data', 'bss', 'noinit', or None for sections not in RAM."""
+    if "ALLOC" not in flags or "READONLY" in flags or "CODE" in flags:
+        return None
+    if name.startswith(".noinit"):
+        return "noinit"
+    if "LOAD" not in flags:
+        return "bss"
+    return "data"
+
+
+def parse(text):
+    """Return ({module: {class: bytes}}, [(size, symbol, module)])."""
+    modules = {}
+    symbols = []
+    mod = None
+    sections = {}
+    pending = None          # section whose flags line comes next
+    in_symbols = False
+
+    for line in text.splitlines():
+        m = MEMBER_RE.match(line)
+        if m:
+            mod = module_name(m.group(1))
+            modules.setdefault(mod, {"data": 0, "bss": 0, "noinit": 0})
+            sections = {}
+            pending = None
+            in_symbols = False
+            continue
+        if mod is None:
+            continue
+        if line.startswith("SYMBOL TABLE:"):
+            in_symbols = True
+            continue
+
+        if in_symbols:
+            m = SYMBOL_RE.match(line)
+            if not m or "O" not in m.group(1):
+                continue
+            size = int(m.group(3), 16)
+            if size and (m.group(2) in sections or m.group(2) == "*COM*"):
+                symbols.append((size, m.group(4), mod))
+            if m.group(2) == "*COM*":
+                modules[mod]["bss"] += size
+            continue
+
+        if pending:
+            cls = ram_class(pending[0], line)
+            if cls:
+                sections[pending[0]] = cls
+                modules[mod][cls] += pending[1]
+            pending = None
+            continue
+        m = SECTION_RE.match(line)
+        if m:
+            pending = (m.group(1), int(m.group(2), 16))
+
+    symbols.sort(key=lambda s: (-s[0], s[1]))
+    return modules, symbols[:TOP_SYMBOLS]
+
+
+def gen_c_source(modules, symbols):
+    mods = sorted(((name, c) for name, c in modules.items()
+                   if c["data"] or c["bss"] or c["noinit"]),
+                  key=lambda m: -(m[1]["data"] + m[1]["bss"] + m[1]["noinit"]))
+
+    mod_rows = "\n".join(
+        f'\t{{ "{name}", {c["data"]}, {c["bss"]}, {c["noinit"]} }},'
+        for name, c in mods)
+    sym_rows = "\n".join(
+        f'\t{{ "{name}", "{mod}", {size} }},' for size, name, mod in symbols)
+
+    return f"""/*
+ * ShrikeOS Monitor — RAM Table
+ *
+ * {BANNER}
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ram.h"
+
+const struct ram_module ram_modules[] = {{
+{mod_rows}
+}};
+
+const struct ram_symbol ram_symbols[] = {{
+{sym_rows}
+}};
+
+const size_t ram_module_count = {len(mods)};
+const size_t ram_symbol_count = {len(symbols)};
+"""
+
+
+def write_if_changed(path, text):
+    try:
+        with open(path, encoding="utf-8") as f:
+            if f.read() == text:
+                # Still the build's output: left older than libapp.a it
+                # would send objdump round again on every build
+                os.utime(path)
+                return
+    except FileNotFoundError:
+        pass
+    with open(path, "w", encoding="utf-8") as f:
+        f.write(text)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[1])
+    ap.add_argument("--objdump", default="objdump")
+    ap.add_argument("--lib", required=True, help="application library")
+    ap.add_argument("--out", required=True, help="directory for ram_table.c")
+    args = ap.parse_args()
+
+    try:
+        text = subprocess.run([args.objdump, "-h", "-t", args.lib],
+                              check=True, capture_output=True,
+                              text=True).stdout
+    except (OSError, subprocess.CalledProcessError) as e:
+        sys.exit(f"gen_ram_table: {args.objdump} failed: {e}")
+
+    modules, symbols = parse(text)
+    if not modules:
+        sys.exit(f"gen_ram_table: no objects found in {args.lib}")
+
+    os.makedirs(args.out, exist_ok=True)
+    write_if_changed(os.path.join(args.out, "ram_table.c"),
+                     gen_c_source(modules, symbols))
+
+
+if __name__ == "__main__":
+    main()
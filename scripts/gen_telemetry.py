@@ -0,0 +1,474 @@
+#!/usr/bin/env python3
+"""
+ShrikeOS Monitor — Telemetry Schema Generator
+
+Reads schema/telemetry.json and generates every encoder/decoder for the
+telemetry frame, so field names, types and scaling live in one place:
+
+    <c-out>/telemetry_schema.h    frame struct, JSON descriptors, binary layout
+    <c-out>/telemetry_schema.c
+    dashboard/telemetry_schema.py decoder used by bridge.py, packer used
+                                  by board_sim.py
+    dashboard/telemetry_schema.js decoder used by app.js
+
+A field's "deadband" (in its own units) is how far it must move from the
+last value sent before the firmware sends a frame; fields without one
+never trigger a frame on their own.  "max_silent_ms" bounds the time
+between frames when nothing moves.
+
+The firmware build regenerates the C files on every schema change and
+runs with --check so a stale dashboard decoder fails the build.  After
+editing the schema, refresh the dashboard copies with:
+
+    python3 scripts/gen_telemetry.py --dashboard dashboard
+
+Binary frame layout (all multi-byte values little-endian):
+
+    [0]      sync byte 0xA5 (never the first byte of a UTF-8 text line)
+    [1]      schema version
+    [2]      payload length
+    [3..]    fields in schema order, packed, at fixed offsets
+    [last]   CRC-8 (poly 0x07, init 0) over bytes 1..last-1
+"""
+
+import argparse
+import json
+import os
+import sys
+
+SYNC = 0xA5
+HDR_LEN = 3
+
+# type -> (C type, struct format, size, JSON type, DataView getter)
+TYPES = {
+    "u8":   ("uint8_t",  "B", 1, "JSON_F_U8",   "getUint8"),
+    "u16":  ("uint16_t", "H", 2, "JSON_F_U16",  "getUint16"),
+    "u32":  ("uint32_t", "I", 4, "JSON_F_U32",  "getUint32"),
+    "i16":  ("int16_t",  "h", 2, "JSON_F_I16",  "getInt16"),
+    "i32":  ("int32_t",  "i", 4, "JSON_F_I32",  "getInt32"),
+    "bool": ("bool",     "B", 1, "JSON_F_BOOL", "getUint8"),
+}
+FIXED = {"i16": "JSON_F_FIXED16", "i32": "JSON_F_FIXED32"}
+
+BANNER = "Generated by scripts/gen_telemetry.py from schema/telemetry.json.  Do not edit."
+
+
+def load_schema(path):
+    with open(path, encoding="utf-8") as f:
+        schema = json.load(f)
+
+    offset = HDR_LEN
+    names = set()
+    for fld in schema["fields"]:
+        name, ftype = fld["name"], fld["type"]
+        if ftype not in TYPES:
+            sys.exit(f"{path}: field '{name}': unknown type '{ftype}'")
+        if name in names or not name.isidentifier():
+            sys.exit(f"{path}: field '{name}': bad or duplicate name")
+        names.add(name)
+
+        scale = fld.get("scale", 1)
+        decimals = len(str(scale)) - 1
+        if scale != 10 ** decimals:
+            sys.exit(f"{path}: field '{name}': scale must be a power of 10")
+        if decimals and ftype not in FIXED:
+            sys.exit(f"{path}: field '{name}': only i16/i32 can be scaled")
+
+        fld["scale"] = scale
+        fld["decimals"] = decimals
+        fld["offset"] = offset
+        offset += TYPES[ftype][2]
+
+        if "deadband" in fld:
+            band = round(fld["deadband"] * scale)
+            if band < 0 or abs(band - fld["deadband"] * scale) > 1e-9:
+                sys.exit(f"{path}: field '{name}': deadband must be >= 0 "
+                         f"with at most {decimals} decimals")
+            fld["band"] = band
+
+    schema.setdefault("max_silent_ms", schema["rate_ms"])
+    if schema["max_silent_ms"] < schema["rate_ms"]:
+        sys.exit(f"{path}: max_silent_ms is shorter than rate_ms")
+    schema["payload_len"] = offset - HDR_LEN
+    schema["frame_len"] = offset + 1
+    if schema["payload_len"] > 255:
+        sys.exit(f"{path}: payload exceeds 255 bytes")
+    return schema
+
+
+# --------------------------------------------------------------------
+# C
+# --------------------------------------------------------------------
+
+def gen_c_header(s):
+    members = []
+    for f in s["fields"]:
+        ctype = TYPES[f["type"]][0]
+        notes = []
+        if f["scale"] > 1:
+            notes.append(f"x{f['scale']}")
+        if "unit" in f:
+            notes.append(f["unit"])
+        decl = f"\t{ctype:<9}{f['name']};"
+        if notes:
+            decl = f"{decl:<20}/* {', '.join(notes)} */"
+        members.append(decl)
+
+    return f"""/*
+ * ShrikeOS Monitor — Telemetry Schema
+ *
+ * {BANNER}
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SHRIKE_TELEMETRY_SCHEMA_H
+#define SHRIKE_TELEMETRY_SCHEMA_H
+
+#include <zephyr/kernel.h>
+
+#include "json.h"
+
+#define TELEMETRY_SCHEMA_VERSION   {s['version']}
+#define TELEMETRY_PERIOD_MS        {s['rate_ms']}
+#define TELEMETRY_FIELD_COUNT      {len(s['fields'])}
+#define TELEMETRY_MAX_SILENT_MS    {s['max_silent_ms']}
+#define TELEMETRY_NO_DEADBAND      UINT32_MAX
+
+#define TELEMETRY_BIN_SYNC         0x{SYNC:02X}
+#define TELEMETRY_BIN_HDR_LEN      {HDR_LEN}
+#define TELEMETRY_BIN_PAYLOAD_LEN  {s['payload_len']}
+#define TELEMETRY_BIN_FRAME_LEN    {s['frame_len']}
+
+struct telemetry_frame {{
+{chr(10).join(members)}
+}};
+
+extern const struct json_field telemetry_fields[TELEMETRY_FIELD_COUNT];
+
+/* Default deadband per field, in wire units (scaled) */
+extern const uint32_t telemetry_deadbands[TELEMETRY_FIELD_COUNT];
+
+int      telemetry_encode_json(const struct telemetry_frame *f,
+			       char *buf, size_t len);
+void     telemetry_pack(const struct telemetry_frame *f,
+			uint8_t out[TELEMETRY_BIN_FRAME_LEN]);
+uint32_t telemetry_field_delta(const struct telemetry_frame *a,
+			       const struct telemetry_frame *b, int field);
+
+#endif /* SHRIKE_TELEMETRY_SCHEMA_H */
+"""
+
+
+def gen_c_source(s):
+    descs = []
+    packs = []
+    bands = []
+    deltas = []
+    for i, f in enumerate(s["fields"]):
+        name, ftype, off = f["name"], f["type"], f["offset"]
+        if f["decimals"]:
+            descs.append(f"\tJSON_FIELD_FIXED(struct telemetry_frame, {name}, "
+                         f"\"{name}\",\n\t\t\t {FIXED[ftype]}, {f['decimals']}),")
+        else:
+            descs.append(f"\tJSON_FIELD(struct telemetry_frame, {name}, "
+                         f"\"{name}\", {TYPES[ftype][3]}),")
+
+        size = TYPES[ftype][2]
+        if ftype == "bool":
+            packs.append(f"\tout[{off}] = f->{name} ? 1 : 0;")
+        elif size == 1:
+            packs.append(f"\tout[{off}] = (uint8_t)f->{name};")
+        else:
+            bits = size * 8
+            packs.append(f"\tsys_put_le{bits}((uint{bits}_t)f->{name}, &out[{off}]);")
+
+        band = f"{f['band']}," if "band" in f else "TELEMETRY_NO_DEADBAND,"
+        bands.append(f"\t{band:<24}/* {name} */")
+        deltas.append(f"\tcase {i}: d = (int64_t)a->{name} - (int64_t)b->{name}; break;")
+
+    last = s["frame_len"] - 1
+    return f"""/*
+ * ShrikeOS Monitor — Telemetry Schema
+ *
+ * {BANNER}
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/crc.h>
+
+#include "json.h"
+#include "telemetry_schema.h"
+
+const struct json_field telemetry_fields[TELEMETRY_FIELD_COUNT] = {{
+{chr(10).join(descs)}
+}};
+
+/**
+ * telemetry_encode_json — One newline-terminated JSON telemetry line.
+ *
+ * @return  Length excluding NUL, or -ENOMEM if @p buf is too small.
+ */
+int telemetry_encode_json(const struct telemetry_frame *f,
+			  char *buf, size_t len)
+{{
+	struct json_writer w;
+
+	json_init(&w, buf, len);
+	json_obj_begin(&w);
+	json_fields(&w, telemetry_fields, TELEMETRY_FIELD_COUNT, f);
+	json_obj_end(&w);
+	json_raw(&w, "\\n", 1);
+	return json_finish(&w);
+}}
+
+const uint32_t telemetry_deadbands[TELEMETRY_FIELD_COUNT] = {{
+{chr(10).join(bands)}
+}};
+
+/**
+ * telemetry_field_delta — |a - b| for field number @p field, in wire
+ * units.
+ */
+uint32_t telemetry_field_delta(const struct telemetry_frame *a,
+			       const struct telemetry_frame *b, int field)
+{{
+	int64_t d;
+
+	switch (field) {{
+{chr(10).join(deltas)}
+	default: return 0;
+	}}
+	return (uint32_t)(d < 0 ? -d : d);
+}}
+
+/**
+ * telemetry_pack — Fixed-layout binary telemetry frame.
+ */
+void telemetry_pack(const struct telemetry_frame *f,
+		    uint8_t out[TELEMETRY_BIN_FRAME_LEN])
+{{
+	out[0] = TELEMETRY_BIN_SYNC;
+	out[1] = TELEMETRY_SCHEMA_VERSION;
+	out[2] = TELEMETRY_BIN_PAYLOAD_LEN;
+{chr(10).join(packs)}
+	out[{last}] = crc8_ccitt(0, &out[1], {last - 1});
+}}
+"""
+
+
+# --------------------------------------------------------------------
+# Python
+# --------------------------------------------------------------------
+
+def gen_python(s):
+    fmt = "<" + "".join(TYPES[f["type"]][1] for f in s["fields"])
+    fields = "\n".join(
+        f"    ({f['name']!r}, {f.get('unit', '')!r}, {f['scale']}),"
+        for f in s["fields"])
+    assigns = []
+    for i, f in enumerate(s["fields"]):
+        if f["scale"] > 1:
+            assigns.append(f"    out[{f['name']!r}] = v[{i}] / {f['scale']}")
+        else:
+            assigns.append(f"    out[{f['name']!r}] = v[{i}]")
+    packs = []
+    for f in s["fields"]:
+        if f["type"] == "bool":
+            packs.append(f"1 if values[{f['name']!r}] else 0")
+        elif f["scale"] > 1:
+            packs.append(f"round(values[{f['name']!r}] * {f['scale']})")
+        else:
+            packs.append(f"values[{f['name']!r}]")
+
+    return f'''"""
+ShrikeOS Monitor — Telemetry Schema
+
+{BANNER}
+"""
+
+import struct
+
+SCHEMA_VERSION = {s["version"]}
+PERIOD_MS = {s["rate_ms"]}
+MAX_SILENT_MS = {s["max_silent_ms"]}
+
+SYNC = 0x{SYNC:02X}
+HDR_LEN = {HDR_LEN}
+PAYLOAD_LEN = {s["payload_len"]}
+FRAME_LEN = {s["frame_len"]}
+
+# (name, unit, scale) in wire order
+FIELDS = (
+{fields}
+)
+
+# Payload layout after the {HDR_LEN}-byte header, in wire order
+PAYLOAD = struct.Struct("{fmt}")
+
+
+def crc8(buf, start, end):
+    """CRC-8, poly 0x07, init 0 (Zephyr crc8_ccitt)."""
+    crc = 0
+    for i in range(start, end):
+        crc ^= buf[i]
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def check_frame(buf, off=0):
+    """True if a complete, valid frame starts at buf[off]."""
+    return (len(buf) - off >= FRAME_LEN
+            and buf[off] == SYNC
+            and buf[off + 1] == SCHEMA_VERSION
+            and buf[off + 2] == PAYLOAD_LEN
+            and crc8(buf, off + 1, off + FRAME_LEN - 1) == buf[off + FRAME_LEN - 1])
+
+
+def decode_into(buf, off, out):
+    """Decode the frame at buf[off] into the caller's dict (no copies of buf)."""
+    v = PAYLOAD.unpack_from(buf, off + HDR_LEN)
+{chr(10).join(assigns)}
+    return out
+
+
+def pack(values):
+    """Encode a frame from a dict of decoded field values (telemetry_pack())."""
+    buf = bytearray(FRAME_LEN)
+    buf[0] = SYNC
+    buf[1] = SCHEMA_VERSION
+    buf[2] = PAYLOAD_LEN
+    PAYLOAD.pack_into(buf, HDR_LEN,
+{(","+chr(10)).join(" " * 22 + p for p in packs)})
+    buf[-1] = crc8(buf, 1, FRAME_LEN - 1)
+    return bytes(buf)
+'''
+
+
+# --------------------------------------------------------------------
+# JavaScript
+# --------------------------------------------------------------------
+
+def gen_js(s):
+    fields = "\n".join(
+        f"        {{ name: '{f['name']}', unit: '{f.get('unit', '')}', scale: {f['scale']} }},"
+        for f in s["fields"])
+    reads = []
+    for f in s["fields"]:
+        getter = TYPES[f["type"]][4]
+        le = "" if TYPES[f["type"]][2] == 1 else ", true"
+        expr = f"view.{getter}(off + {f['offset']}{le})"
+        if f["scale"] > 1:
+            expr += f" / {f['scale']}"
+        reads.append(f"        out.{f['name']} = {expr};")
+
+    return f"""/* ============================================================
+   ShrikeOS Monitor — Telemetry Schema
+   {BANNER}
+   ============================================================ */
+
+const TelemetrySchema = (() => {{
+    const VERSION = {s["version"]};
+    const PERIOD_MS = {s["rate_ms"]};
+    const MAX_SILENT_MS = {s["max_silent_ms"]};
+    const SYNC = 0x{SYNC:02X};
+    const PAYLOAD_LEN = {s["payload_len"]};
+    const FRAME_LEN = {s["frame_len"]};
+
+    // Wire order
+    const FIELDS = Object.freeze([
+{fields}
+    ]);
+
+    // CRC-8, poly 0x07, init 0 (Zephyr crc8_ccitt)
+    function crc8(view, start, end) {{
+        let crc = 0;
+        for (let i = start; i < end; i++) {{
+            crc ^= view.getUint8(i);
+            for (let b = 0; b < 8; b++) {{
+                crc = (crc & 0x80) ? ((crc << 1) ^ 0x07) & 0xFF : (crc << 1) & 0xFF;
+            }}
+        }}
+        return crc;
+    }}
+
+    // True if a complete, valid frame starts at view[off]
+    function check(view, off = 0) {{
+        return view.byteLength - off >= FRAME_LEN &&
+            view.getUint8(off) === SYNC &&
+            view.getUint8(off + 1) === VERSION &&
+            view.getUint8(off + 2) === PAYLOAD_LEN &&
+            crc8(view, off + 1, off + FRAME_LEN - 1) === view.getUint8(off + FRAME_LEN - 1);
+    }}
+
+    // Decode into a caller-owned object; nothing is allocated
+    function decodeInto(view, off, out) {{
+{chr(10).join(reads)}
+        return out;
+    }}
+
+    return Object.freeze({{ VERSION, PERIOD_MS, MAX_SILENT_MS, SYNC, FRAME_LEN, FIELDS, check, decodeInto }});
+}})();
+
+if (typeof module !== 'undefined') module.exports = TelemetrySchema;
+"""
+
+
+# --------------------------------------------------------------------
+
+def write_if_changed(path, text):
+    try:
+        with open(path, encoding="utf-8") as f:
+            if f.read() == text:
+                # Still the build's output: left older than the script
+                # or the dashboard decoders it would be rerun every build
+                os.utime(path)
+                return
+    except FileNotFoundError:
+        pass
+    with open(path, "w", encoding="utf-8") as f:
+        f.write(text)
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[1])
+    ap.add_argument("--schema", default=os.path.join(here, "..", "schema", "telemetry.json"))
+    ap.add_argument("--c-out", help="directory for telemetry_schema.[ch]")
+    ap.add_argument("--dashboard", help="directory to write the Python/JS decoders to")
+    ap.add_argument("--check", metavar="DIR",
+                    help="fail if the decoders in DIR are out of date")
+    args = ap.parse_args()
+
+    s = load_schema(args.schema)
+    dash = {"telemetry_schema.py": gen_python(s), "telemetry_schema.js": gen_js(s)}
+
+    if args.c_out:
+        os.makedirs(args.c_out, exist_ok=True)
+        write_if_changed(os.path.join(args.c_out, "telemetry_schema.h"), gen_c_header(s))
+        write_if_changed(os.path.join(args.c_out, "telemetry_schema.c"), gen_c_source(s))
+
+    if args.dashboard:
+        for name, text in dash.items():
+            write_if_changed(os.path.join(args.dashboard, name), text)
+
+    if args.check:
+        stale = []
+        for name, text in dash.items():
+            try:
+                with open(os.path.join(args.check, name), encoding="utf-8") as f:
+                    if f.read() != text:
+                        stale.append(name)
+            except FileNotFoundError:
+                stale.append(name)
+        if stale:
+            sys.exit(f"gen_telemetry: {', '.join(stale)} out of date with the schema; "
+                     f"run: python3 scripts/gen_telemetry.py --dashboard dashboard")
+
+
+if __name__ == "__main__":
+    main()
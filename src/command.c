@@ -3,7 +3,9 @@
  *
  * Table-driven command parser for any transport (USB-CDC, UART, BLE).
  * Commands are registered at compile time and dispatched by name with
- * argument parsing, validation, and help output.
+ * argument parsing, validation, and help output.  Each transport owns
+ * a session carrying its output sink, history and statistics; only the
+ * engine-wide counters are shared, and those are per-CPU atomics.
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -15,28 +17,29 @@
 #include <stdlib.h>
 #include <ctype.h>
 
-#define CMD_MAX_COMMANDS   24
-#define CMD_MAX_ARGS       8
-#define CMD_MAX_LINE       128
-#define CMD_HISTORY_DEPTH  8
+#include "command.h"
+#include "frame_pool.h"
+#include "json.h"
+#include "logger.h"
+#include "smp.h"
+#include "sysinfo.h"
 
-enum cmd_arg_type {
-	CMD_ARG_NONE = 0,
-	CMD_ARG_INT,
-	CMD_ARG_STRING,
-	CMD_ARG_BOOL,
-};
-
-struct cmd_arg {
-	enum cmd_arg_type type;
-	union {
-		int         ival;
-		const char *sval;
-		bool        bval;
-	};
-};
-
-typedef int (*cmd_handler_t)(int argc, struct cmd_arg *argv);
+/* 31 registered as of this tree.  Every entry also costs a cmd_timing
+ * slot (~160 B), so keep this at the registered set plus one spare;
+ * a registration that does not fit is logged as an error at boot.
+ */
+#ifndef CMD_MAX_COMMANDS
+#define CMD_MAX_COMMANDS   32
+#endif
+#define CMD_MAX_SESSIONS   4
+#define CMD_FRAME_WAIT_MS  50     /* cmd_print wait for a pool frame */
+
+/* Per-command latency histograms (set to 0 to compile them out) */
+#ifndef CMD_TIMING
+#define CMD_TIMING         1
+#endif
+#define CMD_LAT_BUCKETS    20
+#define CMD_LAT_MIN_LOG2   4      /* bucket 0 holds < 2^5 cycles */
 
 struct cmd_entry {
 	const char    *name;
@@ -48,70 +51,220 @@ struct cmd_entry {
 	bool           hidden;
 };
 
-struct cmd_history {
-	char lines[CMD_HISTORY_DEPTH][CMD_MAX_LINE];
-	int  head;
-	int  count;
+enum cmd_phase {
+	CMD_PHASE_TOKENISE = 0,   /* trim, history, tokenise        */
+	CMD_PHASE_LOOKUP,         /* table lookup, arg checks/parse */
+	CMD_PHASE_HANDLER,
+	CMD_PHASE_COUNT,
+};
+
+static const char *const cmd_phase_names[] = {
+	[CMD_PHASE_TOKENISE] = "tok",
+	[CMD_PHASE_LOOKUP]   = "lookup",
+	[CMD_PHASE_HANDLER]  = "handler",
 };
 
+/* Timing for one command, indexed in parallel with cmd_table so the
+ * lookup scan stays on the small cmd_entry structs.  Bucket i counts
+ * samples in [2^(i+MIN), 2^(i+MIN+1)) cycles; the first and last
+ * buckets also absorb everything below and above.
+ */
+struct cmd_timing {
+	uint32_t calls;
+	uint32_t max_cyc[CMD_PHASE_COUNT];
+	uint64_t sum_cyc[CMD_PHASE_COUNT];
+	uint16_t hist[CMD_PHASE_COUNT][CMD_LAT_BUCKETS];
+};
+
+/* The table is append-only: entries are filled in before cmd_count is
+ * bumped, so dispatch reads it without taking cmd_mutex.
+ */
 static struct cmd_entry   cmd_table[CMD_MAX_COMMANDS];
-static int                cmd_count;
-static struct cmd_history cmd_hist;
+static atomic_t           cmd_count;
+static int                cmd_rejected;   /* registrations past the end */
 
+/* Engine-wide counters, updated lock-free from every session */
+/* Per-CPU so transports on different cores do not share a line */
 static struct cmd_stats {
-	uint32_t total_commands;
-	uint32_t successful;
-	uint32_t failed;
-	uint32_t unknown;
-	uint32_t arg_errors;
+	struct percpu_counter total_commands;
+	struct percpu_counter successful;
+	struct percpu_counter failed;
+	struct percpu_counter unknown;
+	struct percpu_counter arg_errors;
 } cmd_stats;
 
-K_MUTEX_DEFINE(cmd_mutex);
+#if CMD_TIMING
+static struct cmd_timing  cmd_timing[CMD_MAX_COMMANDS];
+static struct k_spinlock  cmd_timing_lock;
+#endif
 
-typedef void (*cmd_output_fn_t)(const char *str);
-static cmd_output_fn_t cmd_output = NULL;
+static struct cmd_session *cmd_sessions[CMD_MAX_SESSIONS];
+static int                 cmd_session_count;
 
-static void cmd_print(const char *fmt, ...)
+/* Serialises registration of commands and sessions only */
+K_MUTEX_DEFINE(cmd_mutex);
+
+void cmd_print(struct cmd_session *sess, const char *fmt, ...)
 {
-	char buf[256];
 	va_list ap;
+
+	/* Format straight into a pool frame and hand it off; replies that
+	 * do not fit one frame fall back to the session buffer.
+	 */
+	if (sess->frame_tx) {
+		struct frame_buf *f = frame_alloc(K_MSEC(CMD_FRAME_WAIT_MS));
+
+		if (f) {
+			va_start(ap, fmt);
+			int n = vsnprintf(f->data, sizeof(f->data), fmt, ap);
+			va_end(ap);
+
+			if (n >= 0 && n < (int)sizeof(f->data)) {
+				f->len = (uint16_t)n;
+				sess->frame_tx(sess->ctx, f);
+				return;
+			}
+			frame_free(f);
+		}
+	}
+
 	va_start(ap, fmt);
-	vsnprintf(buf, sizeof(buf), fmt, ap);
+	vsnprintf(sess->out_buf, sizeof(sess->out_buf), fmt, ap);
 	va_end(ap);
 
-	if (cmd_output) {
-		cmd_output(buf);
-	} else {
-		printk("%s", buf);
+	sess->sink(sess->ctx, sess->out_buf);
+}
+
+/**
+ * cmd_write — Send @p str as is, without cmd_print()'s length limit,
+ * e.g. a long JSON line rendered by the handler.
+ */
+void cmd_write(struct cmd_session *sess, const char *str)
+{
+	sess->sink(sess->ctx, str);
+}
+
+/* ---- Timing ---- */
+
+static inline uint32_t cmd_cycles(void)
+{
+#if CMD_TIMING
+	return k_cycle_get_32();
+#else
+	return 0;
+#endif
+}
+
+#if CMD_TIMING
+static int lat_bucket(uint32_t cyc)
+{
+	if (cyc == 0) return 0;
+	int b = (31 - __builtin_clz(cyc)) - CMD_LAT_MIN_LOG2;
+	return CLAMP(b, 0, CMD_LAT_BUCKETS - 1);
+}
+#endif
+
+static void cmd_timing_record(const struct cmd_entry *entry,
+			      const uint32_t cyc[CMD_PHASE_COUNT])
+{
+#if CMD_TIMING
+	struct cmd_timing *t = &cmd_timing[entry - cmd_table];
+	k_spinlock_key_t key = k_spin_lock(&cmd_timing_lock);
+
+	t->calls++;
+	for (int p = 0; p < CMD_PHASE_COUNT; p++) {
+		uint16_t *slot = &t->hist[p][lat_bucket(cyc[p])];
+		if (*slot != UINT16_MAX) (*slot)++;
+		t->sum_cyc[p] += cyc[p];
+		if (cyc[p] > t->max_cyc[p]) t->max_cyc[p] = cyc[p];
 	}
+
+	k_spin_unlock(&cmd_timing_lock, key);
+#else
+	ARG_UNUSED(entry); ARG_UNUSED(cyc);
+#endif
+}
+
+#if CMD_TIMING
+static void cmd_timing_get(int idx, struct cmd_timing *out)
+{
+	k_spinlock_key_t key = k_spin_lock(&cmd_timing_lock);
+	memcpy(out, &cmd_timing[idx], sizeof(*out));
+	k_spin_unlock(&cmd_timing_lock, key);
+}
+
+static void timing_json_one(struct json_writer *w, int idx)
+{
+	struct cmd_timing t;
+
+	cmd_timing_get(idx, &t);
+
+	json_obj_begin(w);
+	json_key(w, "cmd");
+	json_str(w, cmd_table[idx].name);
+	json_key(w, "n");
+	json_u32(w, t.calls);
+
+	for (int p = 0; p < CMD_PHASE_COUNT; p++) {
+		uint32_t avg = t.calls ?
+			(uint32_t)(t.sum_cyc[p] / t.calls) : 0;
+
+		json_key(w, cmd_phase_names[p]);
+		json_obj_begin(w);
+		json_key(w, "avg");
+		json_u32(w, avg);
+		json_key(w, "max");
+		json_u32(w, t.max_cyc[p]);
+		json_key(w, "h");
+		json_arr_begin(w);
+		for (int b = 0; b < CMD_LAT_BUCKETS; b++) {
+			json_u32(w, t.hist[p][b]);
+		}
+		json_arr_end(w);
+		json_obj_end(w);
+	}
+	json_obj_end(w);
+}
+
+/* One command's timing object; -ENOMEM if it did not fit */
+static int timing_format_one(char *buf, size_t buf_len, int idx)
+{
+	struct json_writer w;
+
+	json_init(&w, buf, buf_len);
+	timing_json_one(&w, idx);
+	return json_finish(&w);
 }
+#endif
 
 /* ---- History ---- */
 
-static void history_add(const char *line)
+static void history_add(struct cmd_history *h, const char *line)
 {
 	if (line[0] == '\0') return;
 
-	if (cmd_hist.count > 0) {
-		int prev = (cmd_hist.head - 1 + CMD_HISTORY_DEPTH) %
+	if (h->count > 0) {
+		int prev = (h->head - 1 + CMD_HISTORY_DEPTH) %
 			   CMD_HISTORY_DEPTH;
-		if (strcmp(cmd_hist.lines[prev], line) == 0) return;
+		if (strcmp(h->lines[prev], line) == 0) return;
 	}
 
-	strncpy(cmd_hist.lines[cmd_hist.head], line, CMD_MAX_LINE - 1);
-	cmd_hist.lines[cmd_hist.head][CMD_MAX_LINE - 1] = '\0';
-	cmd_hist.head = (cmd_hist.head + 1) % CMD_HISTORY_DEPTH;
-	if (cmd_hist.count < CMD_HISTORY_DEPTH) cmd_hist.count++;
+	strncpy(h->lines[h->head], line, CMD_MAX_LINE - 1);
+	h->lines[h->head][CMD_MAX_LINE - 1] = '\0';
+	h->head = (h->head + 1) % CMD_HISTORY_DEPTH;
+	if (h->count < CMD_HISTORY_DEPTH) h->count++;
 }
 
-void cmd_history_dump(void)
+void cmd_history_dump(struct cmd_session *sess)
 {
-	cmd_print("Command history (%d entries):\n", cmd_hist.count);
-	int start = (cmd_hist.head - cmd_hist.count + CMD_HISTORY_DEPTH) %
+	const struct cmd_history *h = &sess->hist;
+
+	cmd_print(sess, "Command history (%d entries):\n", h->count);
+	int start = (h->head - h->count + CMD_HISTORY_DEPTH) %
 		    CMD_HISTORY_DEPTH;
-	for (int i = 0; i < cmd_hist.count; i++) {
+	for (int i = 0; i < h->count; i++) {
 		int idx = (start + i) % CMD_HISTORY_DEPTH;
-		cmd_print("  [%d] %s\n", i + 1, cmd_hist.lines[idx]);
+		cmd_print(sess, "  [%d] %s\n", i + 1, h->lines[idx]);
 	}
 }
 
@@ -166,94 +319,293 @@ static struct cmd_arg parse_auto(const char *s)
 
 /* ---- Registration ---- */
 
+/**
+ * cmd_register — Add a command to the table.
+ *
+ * @return  0, or -1 if the table is full.  The rejected name is printed
+ *          and logged as an error, 'status' counts it, and with asserts
+ *          enabled it is fatal: raise CMD_MAX_COMMANDS.
+ */
 int cmd_register(const char *name, const char *help,
 		 const char *usage, cmd_handler_t handler,
 		 uint8_t min_args, uint8_t max_args)
 {
 	k_mutex_lock(&cmd_mutex, K_FOREVER);
-	if (cmd_count >= CMD_MAX_COMMANDS) {
+	int idx = (int)atomic_get(&cmd_count);
+	if (idx >= CMD_MAX_COMMANDS) {
+		cmd_rejected++;
 		k_mutex_unlock(&cmd_mutex);
+		printk("[CMD] Table full (%d), '%s' not registered\n",
+		       CMD_MAX_COMMANDS, name);
+		SHRIKE_LOG_E("CMD", "Table full (%d), '%s' not registered",
+			     CMD_MAX_COMMANDS, name);
+		__ASSERT(false, "command table full, raise CMD_MAX_COMMANDS");
 		return -1;
 	}
-	struct cmd_entry *e = &cmd_table[cmd_count++];
+	struct cmd_entry *e = &cmd_table[idx];
 	e->name = name; e->help = help; e->usage = usage;
 	e->handler = handler;
 	e->min_args = min_args; e->max_args = max_args;
 	e->hidden = false;
+	atomic_set(&cmd_count, idx + 1);
 	k_mutex_unlock(&cmd_mutex);
 	return 0;
 }
 
-void cmd_set_output(cmd_output_fn_t fn) { cmd_output = fn; }
+/**
+ * cmd_session_init — Set up a session for one transport.
+ *
+ * @param sess  Caller-owned session storage (static for the transport).
+ * @param name  Transport name shown by 'status' (e.g. "usb").
+ * @param sink  Output function receiving each formatted reply chunk.
+ * @param ctx   Opaque transport handle passed to the sink.
+ * @return      0 on success, -1 if the session table is full.
+ */
+int cmd_session_init(struct cmd_session *sess, const char *name,
+		     cmd_sink_fn_t sink, void *ctx)
+{
+	memset(sess, 0, sizeof(*sess));
+	sess->name = name;
+	sess->sink = sink;
+	sess->ctx  = ctx;
+
+	k_mutex_lock(&cmd_mutex, K_FOREVER);
+	if (cmd_session_count >= CMD_MAX_SESSIONS) {
+		k_mutex_unlock(&cmd_mutex);
+		return -1;
+	}
+	cmd_sessions[cmd_session_count++] = sess;
+	k_mutex_unlock(&cmd_mutex);
+	return 0;
+}
+
+/**
+ * cmd_session_set_frame_tx — Route cmd_print output through pool frames.
+ *
+ * @param fn  Receives each formatted reply frame and takes ownership of
+ *            it; NULL reverts to copying through the session sink.
+ */
+void cmd_session_set_frame_tx(struct cmd_session *sess,
+			      cmd_frame_tx_fn_t fn)
+{
+	sess->frame_tx = fn;
+}
 
 /* ---- Built-in Handlers ---- */
 
-static int cmd_help_handler(int argc, struct cmd_arg *argv)
+static int cmd_help_handler(struct cmd_session *sess,
+			    int argc, struct cmd_arg *argv)
 {
 	ARG_UNUSED(argc); ARG_UNUSED(argv);
-	cmd_print("\nAvailable commands:\n");
-	cmd_print("%-16s %s\n", "Command", "Description");
-	cmd_print("---------------- --------------------------------\n");
-	for (int i = 0; i < cmd_count; i++) {
+	int n = (int)atomic_get(&cmd_count);
+	cmd_print(sess, "\nAvailable commands:\n");
+	cmd_print(sess, "%-16s %s\n", "Command", "Description");
+	cmd_print(sess, "---------------- --------------------------------\n");
+	for (int i = 0; i < n; i++) {
 		if (cmd_table[i].hidden) continue;
-		cmd_print("%-16s %s\n", cmd_table[i].name,
+		cmd_print(sess, "%-16s %s\n", cmd_table[i].name,
 			  cmd_table[i].help ? cmd_table[i].help : "");
 	}
-	cmd_print("\nType '<command> --help' for usage details.\n\n");
+	cmd_print(sess, "\nType '<command> --help' for usage details.\n\n");
 	return 0;
 }
 
-static int cmd_status_handler(int argc, struct cmd_arg *argv)
+static const struct cmd_entry *cmd_find(const char *name);
+
+#if CMD_TIMING
+/* One command with every counter at its maximum takes 536 B plus its
+ * name
+ */
+#define CMD_TIMING_JSON_MAX  640
+
+static void cmd_status_timing(struct cmd_session *sess,
+			      const struct cmd_entry *entry, bool json)
 {
-	ARG_UNUSED(argc); ARG_UNUSED(argv);
-	cmd_print("\n=== Command Engine Status ===\n");
-	cmd_print("Registered: %d/%d\n", cmd_count, CMD_MAX_COMMANDS);
-	cmd_print("Executed  : %u (ok: %u, fail: %u, unknown: %u)\n",
-		  cmd_stats.total_commands, cmd_stats.successful,
-		  cmd_stats.failed, cmd_stats.unknown);
-	cmd_print("Arg errors: %u\n", cmd_stats.arg_errors);
-	cmd_print("History   : %d/%d\n", cmd_hist.count, CMD_HISTORY_DEPTH);
-	cmd_print("============================\n\n");
+	int idx = entry - cmd_table;
+	struct cmd_timing t;
+
+	if (json) {
+		char *jb = k_malloc(CMD_TIMING_JSON_MAX);
+
+		if (!jb) {
+			cmd_print(sess, "Out of memory\n");
+			return;
+		}
+
+		/* Newline added here so the line goes out in one write */
+		int len = timing_format_one(jb, CMD_TIMING_JSON_MAX - 1, idx);
+
+		if (len < 0) {
+			cmd_print(sess, "Timing failed: %d\n", len);
+		} else {
+			jb[len]     = '\n';
+			jb[len + 1] = '\0';
+			cmd_write(sess, jb);
+		}
+		k_free(jb);
+		return;
+	}
+
+	cmd_timing_get(idx, &t);
+
+	cmd_print(sess, "\n=== Timing: %s (%u calls, %u cyc/s) ===\n",
+		  entry->name, t.calls,
+		  (uint32_t)CONFIG_SYS_CLOCK_HW_CYCLES_PER_SEC);
+	for (int p = 0; p < CMD_PHASE_COUNT; p++) {
+		uint32_t avg = t.calls ? (uint32_t)(t.sum_cyc[p] / t.calls) : 0;
+
+		cmd_print(sess, "%-8s avg %u max %u cyc\n",
+			  cmd_phase_names[p], avg, t.max_cyc[p]);
+		for (int b = 0; b < CMD_LAT_BUCKETS; b++) {
+			if (t.hist[p][b] == 0) continue;
+			cmd_print(sess, "  >= 2^%-2d : %u\n",
+				  b ? b + CMD_LAT_MIN_LOG2 : 0, t.hist[p][b]);
+		}
+	}
+	cmd_print(sess, "============================\n\n");
+}
+#endif
+
+/*
+ * 'status json': per-command latency histograms as one line,
+ *
+ *   {"cyc_hz":<n>,"cmd_lat":[{"cmd":...,"n":...,"tok":{...},...},...]}
+ *
+ * sent one command at a time, so only one object is ever buffered.
+ * Commands that have never run are skipped.  Cycle counts are raw
+ * k_cycle_get_32() deltas; bucket i of "h" starts at 2^(i+4) cycles.
+ */
+static int cmd_status_json(struct cmd_session *sess)
+{
+#if CMD_TIMING
+	char *buf = k_malloc(CMD_TIMING_JSON_MAX);
+
+	if (!buf) {
+		cmd_print(sess, "Out of memory\n");
+		return -1;
+	}
+#endif
+
+	cmd_print(sess, "{\"cyc_hz\":%u,\"cmd_lat\":[",
+		  (uint32_t)CONFIG_SYS_CLOCK_HW_CYCLES_PER_SEC);
+#if CMD_TIMING
+	int n = (int)atomic_get(&cmd_count);
+	bool first = true;
+
+	for (int i = 0; i < n; i++) {
+		if (cmd_timing[i].calls == 0) continue;
+
+		/* The separator goes with the object, so one that does not
+		 * fit leaves the array valid
+		 */
+		buf[0] = ',';
+		if (timing_format_one(buf + 1, CMD_TIMING_JSON_MAX - 1, i) < 0) {
+			continue;
+		}
+		cmd_write(sess, first ? buf + 1 : buf);
+		first = false;
+	}
+	k_free(buf);
+#endif
+	cmd_write(sess, "]}\n");
 	return 0;
 }
 
-static int cmd_history_handler(int argc, struct cmd_arg *argv)
+static int cmd_status_handler(struct cmd_session *sess,
+			      int argc, struct cmd_arg *argv)
+{
+	const struct cmd_session_stats *ss = &sess->stats;
+
+	if (argc == 1 && argv[0].type == CMD_ARG_STRING &&
+	    strcmp(argv[0].sval, "json") == 0) {
+		return cmd_status_json(sess);
+	}
+	if (argc >= 1) {
+		const struct cmd_entry *entry = NULL;
+
+		if (argv[0].type == CMD_ARG_STRING) {
+			entry = cmd_find(argv[0].sval);
+		}
+		if (!entry) {
+			cmd_print(sess, "No such command\n");
+			return -1;
+		}
+#if CMD_TIMING
+		bool json = argc > 1 && argv[1].type == CMD_ARG_STRING &&
+			    strcmp(argv[1].sval, "json") == 0;
+		cmd_status_timing(sess, entry, json);
+		return 0;
+#else
+		cmd_print(sess, "Command timing disabled\n");
+		return -1;
+#endif
+	}
+
+	cmd_print(sess, "\n=== Command Engine Status ===\n");
+	cmd_print(sess, "Registered: %d/%d (%d rejected)\n",
+		  (int)atomic_get(&cmd_count), CMD_MAX_COMMANDS,
+		  cmd_rejected);
+	cmd_print(sess, "Executed  : %u (ok: %u, fail: %u, unknown: %u)\n",
+		  percpu_sum(&cmd_stats.total_commands),
+		  percpu_sum(&cmd_stats.successful),
+		  percpu_sum(&cmd_stats.failed),
+		  percpu_sum(&cmd_stats.unknown));
+	cmd_print(sess, "Arg errors: %u\n",
+		  percpu_sum(&cmd_stats.arg_errors));
+	cmd_print(sess, "Sessions  : %d/%d\n",
+		  cmd_session_count, CMD_MAX_SESSIONS);
+	cmd_print(sess, "--- session '%s' ---\n", sess->name);
+	cmd_print(sess, "Executed  : %u (ok: %u, fail: %u, unknown: %u)\n",
+		  ss->total_commands, ss->successful,
+		  ss->failed, ss->unknown);
+	cmd_print(sess, "Arg errors: %u\n", ss->arg_errors);
+	cmd_print(sess, "History   : %d/%d\n",
+		  sess->hist.count, CMD_HISTORY_DEPTH);
+	cmd_print(sess, "============================\n\n");
+	return 0;
+}
+
+static int cmd_history_handler(struct cmd_session *sess,
+			       int argc, struct cmd_arg *argv)
 {
 	ARG_UNUSED(argc); ARG_UNUSED(argv);
-	cmd_history_dump();
+	cmd_history_dump(sess);
 	return 0;
 }
 
-static int cmd_echo_handler(int argc, struct cmd_arg *argv)
+static int cmd_echo_handler(struct cmd_session *sess,
+			    int argc, struct cmd_arg *argv)
 {
 	for (int i = 0; i < argc; i++) {
 		if (argv[i].type == CMD_ARG_INT)
-			cmd_print("%d", argv[i].ival);
+			cmd_print(sess, "%d", argv[i].ival);
 		else if (argv[i].type == CMD_ARG_BOOL)
-			cmd_print("%s", argv[i].bval ? "true" : "false");
+			cmd_print(sess, "%s", argv[i].bval ? "true" : "false");
 		else
-			cmd_print("%s", argv[i].sval);
-		if (i < argc - 1) cmd_print(" ");
+			cmd_print(sess, "%s", argv[i].sval);
+		if (i < argc - 1) cmd_print(sess, " ");
 	}
-	cmd_print("\n");
+	cmd_print(sess, "\n");
 	return 0;
 }
 
-static int cmd_uptime_handler(int argc, struct cmd_arg *argv)
+static int cmd_uptime_handler(struct cmd_session *sess,
+			      int argc, struct cmd_arg *argv)
 {
 	ARG_UNUSED(argc); ARG_UNUSED(argv);
 	uint32_t ms = k_uptime_get_32();
 	uint32_t s = ms / 1000, m = s / 60, h = m / 60;
-	cmd_print("Uptime: %02u:%02u:%02u.%03u\n",
+	cmd_print(sess, "Uptime: %02u:%02u:%02u.%03u\n",
 		  h, m % 60, s % 60, ms % 1000);
 	return 0;
 }
 
-static int cmd_version_handler(int argc, struct cmd_arg *argv)
+static int cmd_version_handler(struct cmd_session *sess,
+			       int argc, struct cmd_arg *argv)
 {
 	ARG_UNUSED(argc); ARG_UNUSED(argv);
-	cmd_print("ShrikeOS Monitor v1.2.0\n");
-	cmd_print("Zephyr RTOS %s\n", KERNEL_VERSION_STRING);
+	cmd_print(sess, "ShrikeOS Monitor v1.2.0\n");
+	cmd_print(sess, "Zephyr RTOS %s\n", KERNEL_VERSION_STRING);
 	return 0;
 }
 
@@ -262,7 +614,7 @@ static void cmd_register_builtins(void)
 	cmd_register("help",    "Show available commands",
 		     "help", cmd_help_handler, 0, 0);
 	cmd_register("status",  "Command engine statistics",
-		     "status", cmd_status_handler, 0, 0);
+		     "status [json | cmd [json]]", cmd_status_handler, 0, 2);
 	cmd_register("history", "Show command history",
 		     "history", cmd_history_handler, 0, 0);
 	cmd_register("echo",    "Echo arguments back",
@@ -277,7 +629,9 @@ static void cmd_register_builtins(void)
 
 static const struct cmd_entry *cmd_find(const char *name)
 {
-	for (int i = 0; i < cmd_count; i++) {
+	int n = (int)atomic_get(&cmd_count);
+
+	for (int i = 0; i < n; i++) {
 		const char *a = cmd_table[i].name;
 		const char *b = name;
 		bool match = true;
@@ -294,8 +648,19 @@ static const struct cmd_entry *cmd_find(const char *name)
 	return NULL;
 }
 
-int cmd_execute(char *line)
+/**
+ * cmd_session_execute — Parse and run one command line on a session.
+ *
+ * Must only be called from the thread that owns @p sess.  The line is
+ * tokenised in place.
+ *
+ * @return  Handler result, or -1 on unknown command / bad arguments.
+ */
+int cmd_session_execute(struct cmd_session *sess, char *line)
 {
+	uint32_t cyc[CMD_PHASE_COUNT];
+	uint32_t t0 = cmd_cycles();
+
 	if (!line || line[0] == '\0') return 0;
 
 	while (*line && isspace((unsigned char)*line)) line++;
@@ -304,38 +669,46 @@ int cmd_execute(char *line)
 		line[--len] = '\0';
 	if (len == 0) return 0;
 
-	history_add(line);
+	history_add(&sess->hist, line);
 
 	char *tokens[CMD_MAX_ARGS + 1];
 	int ntok = tokenise(line, tokens, CMD_MAX_ARGS + 1);
 	if (ntok == 0) return 0;
 
-	cmd_stats.total_commands++;
+	uint32_t t1 = cmd_cycles();
+
+	percpu_inc(&cmd_stats.total_commands);
+	sess->stats.total_commands++;
 
 	const struct cmd_entry *entry = cmd_find(tokens[0]);
 	if (!entry) {
-		cmd_print("Unknown command: '%s'. Type 'help'.\n", tokens[0]);
-		cmd_stats.unknown++;
+		cmd_print(sess, "Unknown command: '%s'. Type 'help'.\n",
+			  tokens[0]);
+		percpu_inc(&cmd_stats.unknown);
+		sess->stats.unknown++;
 		return -1;
 	}
 
 	if (ntok > 1 && strcmp(tokens[1], "--help") == 0) {
-		cmd_print("Usage: %s\n", entry->usage ? entry->usage : "N/A");
-		if (entry->help) cmd_print("  %s\n", entry->help);
+		cmd_print(sess, "Usage: %s\n",
+			  entry->usage ? entry->usage : "N/A");
+		if (entry->help) cmd_print(sess, "  %s\n", entry->help);
 		return 0;
 	}
 
 	int argc = ntok - 1;
 	if (argc < entry->min_args) {
-		cmd_print("Too few args for '%s' (min %u, got %d)\n",
+		cmd_print(sess, "Too few args for '%s' (min %u, got %d)\n",
 			  entry->name, entry->min_args, argc);
-		cmd_stats.arg_errors++;
+		percpu_inc(&cmd_stats.arg_errors);
+		sess->stats.arg_errors++;
 		return -1;
 	}
 	if (argc > entry->max_args) {
-		cmd_print("Too many args for '%s' (max %u, got %d)\n",
+		cmd_print(sess, "Too many args for '%s' (max %u, got %d)\n",
 			  entry->name, entry->max_args, argc);
-		cmd_stats.arg_errors++;
+		percpu_inc(&cmd_stats.arg_errors);
+		sess->stats.arg_errors++;
 		return -1;
 	}
 
@@ -343,9 +716,21 @@ int cmd_execute(char *line)
 	for (int i = 0; i < argc; i++)
 		args[i] = parse_auto(tokens[i + 1]);
 
-	int ret = entry->handler(argc, args);
-	if (ret == 0) cmd_stats.successful++;
-	else { cmd_stats.failed++; }
+	uint32_t t2 = cmd_cycles();
+	int ret = entry->handler(sess, argc, args);
+	uint32_t t3 = cmd_cycles();
+
+	cyc[CMD_PHASE_TOKENISE] = t1 - t0;
+	cyc[CMD_PHASE_LOOKUP]   = t2 - t1;
+	cyc[CMD_PHASE_HANDLER]  = t3 - t2;
+	cmd_timing_record(entry, cyc);
+	if (ret == 0) {
+		percpu_inc(&cmd_stats.successful);
+		sess->stats.successful++;
+	} else {
+		percpu_inc(&cmd_stats.failed);
+		sess->stats.failed++;
+	}
 
 	return ret;
 }
@@ -353,19 +738,18 @@ int cmd_execute(char *line)
 void cmd_get_stats(uint32_t *total, uint32_t *ok, uint32_t *fail,
 		   uint32_t *unknown)
 {
-	k_mutex_lock(&cmd_mutex, K_FOREVER);
-	if (total)   *total   = cmd_stats.total_commands;
-	if (ok)      *ok      = cmd_stats.successful;
-	if (fail)    *fail    = cmd_stats.failed;
-	if (unknown) *unknown = cmd_stats.unknown;
-	k_mutex_unlock(&cmd_mutex);
+	if (total)   *total   = percpu_sum(&cmd_stats.total_commands);
+	if (ok)      *ok      = percpu_sum(&cmd_stats.successful);
+	if (fail)    *fail    = percpu_sum(&cmd_stats.failed);
+	if (unknown) *unknown = percpu_sum(&cmd_stats.unknown);
 }
 
 void cmd_init(void)
 {
 	memset(&cmd_stats, 0, sizeof(cmd_stats));
-	memset(&cmd_hist, 0, sizeof(cmd_hist));
-	cmd_count = 0;
+	atomic_set(&cmd_count, 0);
 	cmd_register_builtins();
-	printk("[CMD] Command engine initialised (%d built-ins)\n", cmd_count);
+	SYSINFO_KOBJ_LABEL(cmd_mutex);
+	printk("[CMD] Command engine initialised (%d built-ins)\n",
+	       (int)atomic_get(&cmd_count));
 }
@@ -0,0 +1,91 @@
+/*
+ * ShrikeOS Monitor — Command Processing Engine
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SHRIKE_COMMAND_H
+#define SHRIKE_COMMAND_H
+
+#include <zephyr/kernel.h>
+
+#define CMD_MAX_ARGS       8
+#define CMD_MAX_LINE       128
+#define CMD_HISTORY_DEPTH  8
+#define CMD_OUT_BUF_LEN    256
+
+enum cmd_arg_type {
+	CMD_ARG_NONE = 0,
+	CMD_ARG_INT,
+	CMD_ARG_STRING,
+	CMD_ARG_BOOL,
+};
+
+struct cmd_arg {
+	enum cmd_arg_type type;
+	union {
+		int         ival;
+		const char *sval;
+		bool        bval;
+	};
+};
+
+struct cmd_session;
+
+typedef int (*cmd_handler_t)(struct cmd_session *sess,
+			     int argc, struct cmd_arg *argv);
+
+/* Per-session output sink; ctx is the transport handle */
+typedef void (*cmd_sink_fn_t)(void *ctx, const char *str);
+
+/* Optional zero-copy output: takes ownership of a filled pool frame */
+struct frame_buf;
+typedef void (*cmd_frame_tx_fn_t)(void *ctx, struct frame_buf *f);
+
+struct cmd_history {
+	char lines[CMD_HISTORY_DEPTH][CMD_MAX_LINE];
+	int  head;
+	int  count;
+};
+
+struct cmd_session_stats {
+	uint32_t total_commands;
+	uint32_t successful;
+	uint32_t failed;
+	uint32_t unknown;
+	uint32_t arg_errors;
+};
+
+/*
+ * One command session per transport (USB CDC, hardware UART, BLE...).
+ * A session is owned by a single transport thread: its history, stats
+ * and output buffer are never touched by another thread, so sessions
+ * execute concurrently without sharing a lock and replies from one
+ * transport never interleave with another's.
+ */
+struct cmd_session {
+	const char              *name;
+	cmd_sink_fn_t            sink;
+	cmd_frame_tx_fn_t        frame_tx;
+	void                    *ctx;
+	struct cmd_history       hist;
+	struct cmd_session_stats stats;
+	char                     out_buf[CMD_OUT_BUF_LEN];
+};
+
+int  cmd_register(const char *name, const char *help,
+		  const char *usage, cmd_handler_t handler,
+		  uint8_t min_args, uint8_t max_args);
+int  cmd_session_init(struct cmd_session *sess, const char *name,
+		      cmd_sink_fn_t sink, void *ctx);
+void cmd_session_set_frame_tx(struct cmd_session *sess,
+			      cmd_frame_tx_fn_t fn);
+int  cmd_session_execute(struct cmd_session *sess, char *line);
+void cmd_print(struct cmd_session *sess, const char *fmt, ...);
+void cmd_write(struct cmd_session *sess, const char *str);
+void cmd_history_dump(struct cmd_session *sess);
+void cmd_get_stats(uint32_t *total, uint32_t *ok, uint32_t *fail,
+		   uint32_t *unknown);
+void cmd_init(void);
+
+#endif /* SHRIKE_COMMAND_H */
@@ -0,0 +1,355 @@
+/*
+ * ShrikeOS Monitor — Persistent Runtime Configuration
+ *
+ * Keeps the user-tunable settings (blink period, LED state, OLED
+ * message, log level) in Zephyr's settings subsystem on the flash
+ * storage partition.  Changes are coalesced: every update restarts a
+ * quiet-period timer and only the keys that changed are written once
+ * it expires, so a dragged slider costs one flash write, not dozens.
+ * The module only talks to the settings API, so it runs unchanged on
+ * native_sim's simulated flash (tests/config).
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/sys/util.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "command.h"
+#include "config.h"
+#include "logger.h"
+#include "sysinfo.h"
+
+/* --------------------------------------------------------------------
+ * Configuration
+ * ------------------------------------------------------------------ */
+
+#define CFG_SAVE_QUIET_MS         2000   /* write after this much calm */
+#define CFG_SAVE_MAX_DEFER_MS     10000  /* ...but never later than this */
+
+#define CFG_TREE "shrike"
+
+/* Dirty-key bits */
+enum {
+	CFG_KEY_BLINK = 0,
+	CFG_KEY_LED,
+	CFG_KEY_MSG,
+	CFG_KEY_LOG_LEVEL,
+	CFG_KEY_COUNT,
+};
+
+static const char *const cfg_key_names[] = {
+	[CFG_KEY_BLINK]     = CFG_TREE "/blink",
+	[CFG_KEY_LED]       = CFG_TREE "/led",
+	[CFG_KEY_MSG]       = CFG_TREE "/msg",
+	[CFG_KEY_LOG_LEVEL] = CFG_TREE "/loglvl",
+};
+
+/* --------------------------------------------------------------------
+ * State
+ * ------------------------------------------------------------------ */
+
+static struct shrike_config cfg = {
+	.blink_ms   = 250,
+	.led_on     = true,
+	.log_level  = LOG_LVL_DEBUG,
+	.custom_msg = "",
+};
+
+static uint32_t cfg_dirty;           /* CFG_KEY_* bitmask        */
+static int64_t  cfg_dirty_since;     /* first unsaved change     */
+static bool     cfg_ready;           /* settings backend is up   */
+
+static struct config_stats {
+	uint32_t updates;        /* set calls that changed a value   */
+	uint32_t flushes;        /* deferred saves that ran          */
+	uint32_t writes;         /* individual keys written          */
+	uint32_t errors;
+	uint32_t loaded;         /* keys restored at boot            */
+} cfg_stats;
+
+K_MUTEX_DEFINE(cfg_mutex);
+
+static void config_save_fn(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(cfg_save_work, config_save_fn);
+
+/* --------------------------------------------------------------------
+ * Settings backend
+ * ------------------------------------------------------------------ */
+
+static int config_settings_set(const char *name, size_t len,
+			       settings_read_cb read_cb, void *cb_arg)
+{
+	const char *next;
+	ssize_t rc = -ENOENT;
+
+	if (settings_name_steq(name, "blink", &next) && !next) {
+		rc = read_cb(cb_arg, &cfg.blink_ms, sizeof(cfg.blink_ms));
+	} else if (settings_name_steq(name, "led", &next) && !next) {
+		rc = read_cb(cb_arg, &cfg.led_on, sizeof(cfg.led_on));
+	} else if (settings_name_steq(name, "msg", &next) && !next) {
+		memset(cfg.custom_msg, 0, sizeof(cfg.custom_msg));
+		rc = read_cb(cb_arg, cfg.custom_msg,
+			     MIN(len, sizeof(cfg.custom_msg) - 1));
+	} else if (settings_name_steq(name, "loglvl", &next) && !next) {
+		rc = read_cb(cb_arg, &cfg.log_level, sizeof(cfg.log_level));
+	}
+
+	if (rc < 0) {
+		return (int)rc;
+	}
+	cfg_stats.loaded++;
+	return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(shrike_cfg, CFG_TREE, NULL,
+			       config_settings_set, NULL, NULL);
+
+static int config_write_key(int key, const struct shrike_config *c)
+{
+	switch (key) {
+	case CFG_KEY_BLINK:
+		return settings_save_one(cfg_key_names[key], &c->blink_ms,
+					 sizeof(c->blink_ms));
+	case CFG_KEY_LED:
+		return settings_save_one(cfg_key_names[key], &c->led_on,
+					 sizeof(c->led_on));
+	case CFG_KEY_MSG:
+		return settings_save_one(cfg_key_names[key], c->custom_msg,
+					 strlen(c->custom_msg));
+	case CFG_KEY_LOG_LEVEL:
+		return settings_save_one(cfg_key_names[key], &c->log_level,
+					 sizeof(c->log_level));
+	default:
+		return -EINVAL;
+	}
+}
+
+static void config_save_fn(struct k_work *work)
+{
+	ARG_UNUSED(work);
+	struct shrike_config snap;
+	uint32_t dirty;
+
+	k_mutex_lock(&cfg_mutex, K_FOREVER);
+	dirty = cfg_dirty;
+	cfg_dirty = 0;
+	memcpy(&snap, &cfg, sizeof(snap));
+	k_mutex_unlock(&cfg_mutex);
+
+	if (!dirty || !cfg_ready) {
+		return;
+	}
+
+	/* Flash I/O happens on the snapshot, outside the mutex */
+	for (int key = 0; key < CFG_KEY_COUNT; key++) {
+		if (!(dirty & BIT(key))) continue;
+
+		if (config_write_key(key, &snap) == 0) {
+			cfg_stats.writes++;
+		} else {
+			cfg_stats.errors++;
+			k_mutex_lock(&cfg_mutex, K_FOREVER);
+			cfg_dirty |= BIT(key);     /* retry next flush */
+			k_mutex_unlock(&cfg_mutex);
+		}
+	}
+	cfg_stats.flushes++;
+}
+
+/* Caller holds cfg_mutex */
+static void config_mark_dirty(int key)
+{
+	int64_t now = k_uptime_get();
+
+	if (!cfg_dirty) {
+		cfg_dirty_since = now;
+	}
+	cfg_dirty |= BIT(key);
+	cfg_stats.updates++;
+
+	/* Push the write back on every change, up to the max deferral */
+	if (now - cfg_dirty_since < CFG_SAVE_MAX_DEFER_MS) {
+		k_work_reschedule(&cfg_save_work, K_MSEC(CFG_SAVE_QUIET_MS));
+	} else {
+		k_work_schedule(&cfg_save_work, K_NO_WAIT);
+	}
+}
+
+/* --------------------------------------------------------------------
+ * Public API
+ * ------------------------------------------------------------------ */
+
+/**
+ * config_load — Bring up the settings backend and restore saved values.
+ *
+ * Intended to run from an APPLICATION-level SYS_INIT hook, i.e. before
+ * the static threads start.  Missing keys keep their defaults.  The
+ * restored log level is applied to the ring logger directly.
+ *
+ * @param out  Receives the effective configuration.
+ * @return     0 on success, negative errno if the backend failed (the
+ *             defaults are still returned in @p out).
+ */
+int config_load(struct shrike_config *out)
+{
+	int rc = settings_subsys_init();
+
+	if (rc == 0) {
+		rc = settings_load_subtree(CFG_TREE);
+	}
+
+	k_mutex_lock(&cfg_mutex, K_FOREVER);
+	cfg_ready = (rc == 0);
+	if (cfg.log_level >= LOG_LVL_COUNT) {
+		cfg.log_level = LOG_LVL_DEBUG;
+	}
+	memcpy(out, &cfg, sizeof(*out));
+	k_mutex_unlock(&cfg_mutex);
+
+	shrike_log_set_level((enum log_level)out->log_level);
+
+	printk("[CFG] %s (%u keys restored)\n",
+	       rc == 0 ? "Settings loaded" : "Settings unavailable, defaults",
+	       cfg_stats.loaded);
+	return rc;
+}
+
+void config_set_blink(uint16_t ms)
+{
+	k_mutex_lock(&cfg_mutex, K_FOREVER);
+	if (cfg.blink_ms != ms) {
+		cfg.blink_ms = ms;
+		config_mark_dirty(CFG_KEY_BLINK);
+	}
+	k_mutex_unlock(&cfg_mutex);
+}
+
+void config_set_led(bool on)
+{
+	k_mutex_lock(&cfg_mutex, K_FOREVER);
+	if (cfg.led_on != on) {
+		cfg.led_on = on;
+		config_mark_dirty(CFG_KEY_LED);
+	}
+	k_mutex_unlock(&cfg_mutex);
+}
+
+void config_set_msg(const char *msg)
+{
+	k_mutex_lock(&cfg_mutex, K_FOREVER);
+	if (strncmp(cfg.custom_msg, msg, sizeof(cfg.custom_msg) - 1) != 0) {
+		strncpy(cfg.custom_msg, msg, sizeof(cfg.custom_msg) - 1);
+		cfg.custom_msg[sizeof(cfg.custom_msg) - 1] = '\0';
+		config_mark_dirty(CFG_KEY_MSG);
+	}
+	k_mutex_unlock(&cfg_mutex);
+}
+
+void config_set_log_level(uint8_t level)
+{
+	if (level >= LOG_LVL_COUNT) {
+		return;
+	}
+
+	shrike_log_set_level((enum log_level)level);
+
+	k_mutex_lock(&cfg_mutex, K_FOREVER);
+	if (cfg.log_level != level) {
+		cfg.log_level = level;
+		config_mark_dirty(CFG_KEY_LOG_LEVEL);
+	}
+	k_mutex_unlock(&cfg_mutex);
+}
+
+/**
+ * config_flush — Write any pending changes now instead of waiting for
+ * the quiet period.
+ */
+void config_flush(void)
+{
+	k_work_reschedule(&cfg_save_work, K_NO_WAIT);
+}
+
+/* --------------------------------------------------------------------
+ * Commands
+ * ------------------------------------------------------------------ */
+
+static int config_cmd_handler(struct cmd_session *sess,
+			      int argc, struct cmd_arg *argv)
+{
+	if (argc == 1 && argv[0].type == CMD_ARG_STRING &&
+	    strcmp(argv[0].sval, "save") == 0) {
+		config_flush();
+		cmd_print(sess, "Flush scheduled\n");
+		return 0;
+	}
+	if (argc == 1 && argv[0].type == CMD_ARG_STRING &&
+	    strcmp(argv[0].sval, "reset") == 0) {
+		struct k_work_sync sync;
+
+		/* A pending flush would write the keys straight back */
+		k_mutex_lock(&cfg_mutex, K_FOREVER);
+		cfg_dirty = 0;
+		k_work_cancel_delayable(&cfg_save_work);
+		k_mutex_unlock(&cfg_mutex);
+		/* ...and one already running must finish first */
+		k_work_cancel_delayable_sync(&cfg_save_work, &sync);
+
+		for (int key = 0; key < CFG_KEY_COUNT; key++) {
+			settings_delete(cfg_key_names[key]);
+		}
+		cmd_print(sess, "Saved settings erased (defaults on reboot)\n");
+		return 0;
+	}
+	if (argc != 0) {
+		cmd_print(sess, "Usage: config [save|reset]\n");
+		return -1;
+	}
+
+	k_mutex_lock(&cfg_mutex, K_FOREVER);
+	cmd_print(sess, "\n=== Persistent Config ===\n");
+	cmd_print(sess, "Backend : %s\n", cfg_ready ? "settings" : "none");
+	cmd_print(sess, "blink   : %u ms\n", cfg.blink_ms);
+	cmd_print(sess, "led     : %s\n", cfg.led_on ? "on" : "off");
+	cmd_print(sess, "msg     : \"%s\"\n", cfg.custom_msg);
+	cmd_print(sess, "loglvl  : %u\n", cfg.log_level);
+	cmd_print(sess, "Pending : 0x%02x\n", cfg_dirty);
+	cmd_print(sess, "Updates : %u | Flushes: %u | Writes: %u | "
+		  "Errors: %u\n", cfg_stats.updates, cfg_stats.flushes,
+		  cfg_stats.writes, cfg_stats.errors);
+	cmd_print(sess, "=========================\n\n");
+	k_mutex_unlock(&cfg_mutex);
+	return 0;
+}
+
+static int loglevel_cmd_handler(struct cmd_session *sess,
+				int argc, struct cmd_arg *argv)
+{
+	ARG_UNUSED(argc);
+
+	if (argv[0].type != CMD_ARG_INT || argv[0].ival < 0 ||
+	    argv[0].ival >= LOG_LVL_COUNT) {
+		cmd_print(sess, "Level must be 0..%d\n", LOG_LVL_COUNT - 1);
+		return -1;
+	}
+	config_set_log_level((uint8_t)argv[0].ival);
+	cmd_print(sess, "Log level set to %d\n", argv[0].ival);
+	return 0;
+}
+
+/**
+ * config_init — Register configuration commands.  Call after cmd_init().
+ */
+void config_init(void)
+{
+	cmd_register("config",   "Show or save persistent settings",
+		     "config [save|reset]", config_cmd_handler, 0, 1);
+	cmd_register("loglevel", "Set minimum log level (persisted)",
+		     "loglevel <0-3>", loglevel_cmd_handler, 1, 1);
+
+	SYSINFO_KOBJ_LABEL(cfg_mutex);
+}
@@ -0,0 +1,27 @@
+/*
+ * ShrikeOS Monitor — Persistent Runtime Configuration
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SHRIKE_CONFIG_H
+#define SHRIKE_CONFIG_H
+
+#include <zephyr/kernel.h>
+
+struct shrike_config {
+	uint16_t blink_ms;
+	bool     led_on;
+	uint8_t  log_level;
+	char     custom_msg[32];
+};
+
+int  config_load(struct shrike_config *out);
+void config_set_blink(uint16_t ms);
+void config_set_led(bool on);
+void config_set_msg(const char *msg);
+void config_set_log_level(uint8_t level);
+void config_flush(void);
+void config_init(void);
+
+#endif /* SHRIKE_CONFIG_H */
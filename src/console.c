@@ -0,0 +1,326 @@
+/*
+ * ShrikeOS Monitor — Deferred Console
+ *
+ * Console output without a synchronous UART in the path.  Zephyr's UART
+ * log back end is disabled (prj.conf); this back end formats each
+ * message from the log thread into a byte ring instead, dropping whole
+ * messages (and counting them) when the ring is full, so no printk or
+ * LOG_* caller ever waits on the USB link.
+ *
+ * A drain thread below every other thread moves whole lines from the
+ * ring into pool frames and queues them on the serial transport, like
+ * any other producer.  Frames always end on a line boundary, so console
+ * text cannot land in the middle of a telemetry line or binary frame,
+ * and the drain leaves part of the pool free for telemetry.
+ *
+ * In panic mode messages still reach the ring (and the log ring), but
+ * the CDC ACM link cannot send them without interrupts.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log_backend.h>
+#include <zephyr/logging/log_msg.h>
+#include <zephyr/logging/log_output.h>
+#include <zephyr/sys/util.h>
+#include <string.h>
+
+#include "command.h"
+#include "console.h"
+#include "frame_pool.h"
+#include "serial_io.h"
+#include "sysinfo.h"
+
+/* --------------------------------------------------------------------
+ * Configuration
+ * ------------------------------------------------------------------ */
+
+#define CONSOLE_STACK_SIZE    768
+#define CONSOLE_PRIORITY      11     /* below every other thread */
+#define CONSOLE_FLUSH_MS      100    /* unterminated text waits this long */
+#define CONSOLE_POOL_RESERVE  4      /* frames left for telemetry/replies */
+#define CONSOLE_RETRY_MS      10
+#define CONSOLE_FMT_LEN       32
+
+#define CONSOLE_OUTPUT_FLAGS  (LOG_OUTPUT_FLAG_LEVEL |                    \
+			       LOG_OUTPUT_FLAG_TIMESTAMP |                \
+			       LOG_OUTPUT_FLAG_FORMAT_TIMESTAMP |         \
+			       LOG_OUTPUT_FLAG_CRLF_LFONLY)
+
+/* --------------------------------------------------------------------
+ * State
+ * ------------------------------------------------------------------ */
+
+static char              ring[CONSOLE_RING_SIZE];
+static uint32_t          ring_head;      /* free-running write index */
+static uint32_t          ring_tail;      /* free-running read index  */
+static struct k_spinlock console_lock;
+
+static struct console_stats con_stats;
+
+/* Message being formatted; log thread only */
+static uint8_t stage[FRAME_BUF_LEN];
+static size_t  stage_len;
+static bool    stage_truncated;
+static uint8_t fmt_buf[CONSOLE_FMT_LEN];
+
+static K_SEM_DEFINE(console_sem, 0, 1);
+
+/* --------------------------------------------------------------------
+ * Ring
+ * ------------------------------------------------------------------ */
+
+/* Store a whole message, or drop it if it does not fit */
+static void console_ring_put(const uint8_t *data, size_t len)
+{
+	k_spinlock_key_t key = k_spin_lock(&console_lock);
+	uint32_t used = ring_head - ring_tail;
+
+	if (len > CONSOLE_RING_SIZE - used) {
+		con_stats.dropped++;
+		con_stats.dropped_bytes += len;
+		k_spin_unlock(&console_lock, key);
+		return;
+	}
+
+	for (size_t i = 0; i < len; i++) {
+		ring[(ring_head + i) % CONSOLE_RING_SIZE] = data[i];
+	}
+	ring_head += len;
+	con_stats.peak = MAX(con_stats.peak, used + len);
+	k_spin_unlock(&console_lock, key);
+
+	k_sem_give(&console_sem);
+}
+
+/**
+ * console_ring_take — Move whole lines, at most @p cap bytes, into
+ * @p out.
+ *
+ * A line longer than @p cap, or unterminated text when @p flush is set,
+ * is taken as is.
+ *
+ * @return  Bytes taken.
+ */
+static size_t console_ring_take(char *out, size_t cap, bool flush)
+{
+	k_spinlock_key_t key = k_spin_lock(&console_lock);
+	size_t n = MIN((size_t)(ring_head - ring_tail), cap);
+	size_t take = 0;
+
+	for (size_t i = 0; i < n; i++) {
+		out[i] = ring[(ring_tail + i) % CONSOLE_RING_SIZE];
+		if (out[i] == '\n') {
+			take = i + 1;
+		}
+	}
+	if (take == 0 && (n == cap || flush)) {
+		take = n;
+	}
+	ring_tail += take;
+	k_spin_unlock(&console_lock, key);
+
+	return take;
+}
+
+static bool console_ring_empty(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&console_lock);
+	bool empty = ring_head == ring_tail;
+
+	k_spin_unlock(&console_lock, key);
+	return empty;
+}
+
+/* --------------------------------------------------------------------
+ * Drain
+ * ------------------------------------------------------------------ */
+
+static bool console_pool_has_room(void)
+{
+	struct frame_pool_stats ps;
+
+	frame_pool_get_stats(&ps);
+	return ps.in_use + CONSOLE_POOL_RESERVE < FRAME_POOL_COUNT;
+}
+
+/* Send what can go out now; false if it had to stop early */
+static bool console_drain(bool flush)
+{
+	while (1) {
+		if (!console_pool_has_room()) {
+			return false;
+		}
+
+		struct frame_buf *f = frame_alloc(K_NO_WAIT);
+
+		if (!f) {
+			return false;
+		}
+
+		/* Keep a byte to terminate a split or flushed line */
+		size_t n = console_ring_take(f->data, FRAME_BUF_LEN - 1, flush);
+
+		if (n == 0) {
+			frame_free(f);
+			return true;
+		}
+		if (f->data[n - 1] != '\n') {
+			f->data[n++] = '\n';
+			con_stats.partial_flushes++;
+		}
+
+		f->len = (uint16_t)n;
+		con_stats.frames++;
+		con_stats.bytes += n;
+		serial_io_submit(f);
+	}
+}
+
+static void console_thread_fn(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1); ARG_UNUSED(p2); ARG_UNUSED(p3);
+
+	k_timeout_t wait = K_FOREVER;
+
+	while (1) {
+		/* A timeout with text pending means an unterminated line has
+		 * waited long enough
+		 */
+		bool flush = k_sem_take(&console_sem, wait) == -EAGAIN;
+
+		if (!serial_io_ready()) {
+			wait = K_MSEC(CONSOLE_FLUSH_MS);     /* keep boot output */
+			continue;
+		}
+
+		if (!console_drain(flush)) {
+			wait = K_MSEC(CONSOLE_RETRY_MS);
+		} else if (!console_ring_empty()) {
+			wait = K_MSEC(CONSOLE_FLUSH_MS);
+		} else {
+			wait = K_FOREVER;
+		}
+	}
+}
+
+K_THREAD_DEFINE(console_tid, CONSOLE_STACK_SIZE, console_thread_fn,
+		NULL, NULL, NULL, CONSOLE_PRIORITY, 0, 0);
+
+/* --------------------------------------------------------------------
+ * Zephyr log back end
+ * ------------------------------------------------------------------ */
+
+static int console_out(uint8_t *data, size_t length, void *ctx)
+{
+	ARG_UNUSED(ctx);
+
+	size_t n = MIN(length, sizeof(stage) - stage_len);
+
+	memcpy(stage + stage_len, data, n);
+	stage_len += n;
+	if (n < length) {
+		stage_truncated = true;
+	}
+	return (int)length;
+}
+
+LOG_OUTPUT_DEFINE(console_output, console_out, fmt_buf, sizeof(fmt_buf));
+
+static void console_backend_process(const struct log_backend *const backend,
+				    union log_msg_generic *msg)
+{
+	ARG_UNUSED(backend);
+
+	stage_len       = 0;
+	stage_truncated = false;
+	log_output_msg_process(&console_output, &msg->log,
+			       CONSOLE_OUTPUT_FLAGS);
+
+	if (stage_len == 0) {
+		return;
+	}
+	if (stage_truncated) {
+		stage[stage_len - 1] = '\n';
+	}
+	console_ring_put(stage, stage_len);
+}
+
+static void console_backend_dropped(const struct log_backend *const backend,
+				    uint32_t cnt)
+{
+	ARG_UNUSED(backend);
+	con_stats.upstream_dropped += cnt;
+}
+
+static void console_backend_panic(const struct log_backend *const backend)
+{
+	ARG_UNUSED(backend);
+}
+
+static const struct log_backend_api console_backend_api = {
+	.process = console_backend_process,
+	.dropped = console_backend_dropped,
+	.panic   = console_backend_panic,
+};
+
+LOG_BACKEND_DEFINE(shrike_console_backend, console_backend_api, true);
+
+/* --------------------------------------------------------------------
+ * Public API
+ * ------------------------------------------------------------------ */
+
+/**
+ * console_write — Queue preformatted text, ending in a newline, for the
+ * console without passing through the log core (so the log ring does
+ * not capture it).  Dropped whole if the ring is full.
+ */
+void console_write(const char *text, size_t len)
+{
+	console_ring_put((const uint8_t *)text, len);
+}
+
+void console_get_stats(struct console_stats *out)
+{
+	k_spinlock_key_t key = k_spin_lock(&console_lock);
+
+	memcpy(out, &con_stats, sizeof(*out));
+	k_spin_unlock(&console_lock, key);
+}
+
+/* --------------------------------------------------------------------
+ * Commands
+ * ------------------------------------------------------------------ */
+
+static int console_cmd_handler(struct cmd_session *sess,
+			       int argc, struct cmd_arg *argv)
+{
+	ARG_UNUSED(argc); ARG_UNUSED(argv);
+	struct console_stats st;
+	uint32_t used;
+
+	console_get_stats(&st);
+
+	k_spinlock_key_t key = k_spin_lock(&console_lock);
+	used = ring_head - ring_tail;
+	k_spin_unlock(&console_lock, key);
+
+	cmd_print(sess, "Console: %u frames, %u bytes sent | %u partial\n",
+		  st.frames, st.bytes, st.partial_flushes);
+	cmd_print(sess, "Ring: %u / %u B (peak %u) | dropped %u (%u B), "
+		  "%u upstream\n", used, CONSOLE_RING_SIZE, st.peak,
+		  st.dropped, st.dropped_bytes, st.upstream_dropped);
+	return 0;
+}
+
+/**
+ * console_init — Register the 'console' command.  Call after cmd_init().
+ */
+void console_init(void)
+{
+	cmd_register("console", "Deferred console ring and drop counters",
+		     "console", console_cmd_handler, 0, 0);
+
+	SYSINFO_KOBJ_LABEL(console_sem);
+}
@@ -0,0 +1,28 @@
+/*
+ * ShrikeOS Monitor — Deferred Console
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SHRIKE_CONSOLE_H
+#define SHRIKE_CONSOLE_H
+
+#include <zephyr/kernel.h>
+
+#define CONSOLE_RING_SIZE  2048
+
+struct console_stats {
+	uint32_t frames;           /* handed to the serial transport     */
+	uint32_t bytes;
+	uint32_t dropped;          /* messages lost, ring full           */
+	uint32_t dropped_bytes;
+	uint32_t upstream_dropped; /* lost in the log core before us     */
+	uint32_t partial_flushes;  /* unterminated text sent after a wait */
+	uint32_t peak;             /* highest ring fill, bytes           */
+};
+
+void console_write(const char *text, size_t len);
+void console_get_stats(struct console_stats *out);
+void console_init(void);
+
+#endif /* SHRIKE_CONSOLE_H */
@@ -0,0 +1,302 @@
+/*
+ * ShrikeOS Monitor — Compressed Bulk Export
+ *
+ * Streams the log ring or the sensor history to the bridge in one go,
+ * instead of paging through 'log' output a line at a time.  A low
+ * priority thread renders up to EXPORT_CHUNK_RAW bytes of whole text
+ * lines, compresses them as an independent LZ4 block (falling back to
+ * raw text when that does not shrink them) and sends the result as one
+ * CRC-checked binary chunk, laid out in export.h.
+ *
+ * Chunks carry record numbers (log sequence numbers, history sample
+ * numbers), not byte offsets, so an interrupted or corrupted transfer
+ * resumes with 'export <stream> <next>' from the last good chunk even
+ * while the ring keeps filling.  Each export covers the records present
+ * when it started; a new request supersedes one still running.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/crc.h>
+#include <zephyr/sys/util.h>
+#include <string.h>
+
+#include "command.h"
+#include "export.h"
+#include "history.h"
+#include "logger.h"
+#include "lz4.h"
+#include "serial_io.h"
+#include "sysinfo.h"
+
+/* --------------------------------------------------------------------
+ * Configuration
+ * ------------------------------------------------------------------ */
+
+#define EXPORT_STACK_SIZE  1024
+#define EXPORT_PRIORITY    10     /* below every monitor thread */
+
+/* --------------------------------------------------------------------
+ * State
+ * ------------------------------------------------------------------ */
+
+/* Only the export thread touches these; kept off its stack */
+static uint8_t  raw_buf[EXPORT_CHUNK_RAW];
+static uint8_t  wire_buf[EXPORT_HDR_LEN + EXPORT_CHUNK_RAW + EXPORT_CRC_LEN];
+static uint16_t lz4_table[LZ4_HASH_SIZE];
+
+static K_SEM_DEFINE(export_sem, 0, 1);
+static atomic_t            export_busy;
+static atomic_t            export_cancel;
+static enum export_stream  req_stream;    /* under export_mutex */
+static uint32_t            req_from;
+
+static struct export_stats exp_stats;
+
+K_MUTEX_DEFINE(export_mutex);
+
+/* --------------------------------------------------------------------
+ * Chunking
+ * ------------------------------------------------------------------ */
+
+static void export_range(enum export_stream stream,
+			 uint32_t *oldest, uint32_t *next)
+{
+	if (stream == EXPORT_STREAM_LOG) {
+		shrike_log_seq_range(oldest, next);
+	} else {
+		history_range(oldest, next);
+	}
+}
+
+static size_t export_render(enum export_stream stream, uint32_t *first,
+			    uint32_t *next, uint32_t end)
+{
+	if (stream == EXPORT_STREAM_LOG) {
+		return shrike_log_export_text(first, next, end,
+					      (char *)raw_buf,
+					      sizeof(raw_buf));
+	}
+	return history_export_text(first, next, end,
+				   (char *)raw_buf, sizeof(raw_buf));
+}
+
+/**
+ * export_send_chunk — Frame @p raw_len bytes of raw_buf and queue them.
+ *
+ * @return  Bytes queued, or -ENOMEM if the transport dropped the chunk.
+ */
+static int export_send_chunk(enum export_stream stream, uint8_t flags,
+			     uint32_t first, uint32_t next, size_t raw_len)
+{
+	uint8_t *payload = wire_buf + EXPORT_HDR_LEN;
+	int pay_len = -ENOSPC;
+
+	/* Only keep the LZ4 block if it is strictly smaller */
+	if (raw_len > 1) {
+		pay_len = lz4_compress_block(raw_buf, raw_len, payload,
+					     raw_len - 1, lz4_table);
+	}
+	if (pay_len > 0) {
+		flags |= EXPORT_F_LZ4;
+	} else {
+		memcpy(payload, raw_buf, raw_len);
+		pay_len = (int)raw_len;
+	}
+
+	wire_buf[0] = EXPORT_SYNC;
+	wire_buf[1] = (uint8_t)stream;
+	wire_buf[2] = flags;
+	sys_put_le32(first, &wire_buf[3]);
+	sys_put_le32(next, &wire_buf[7]);
+	sys_put_le16((uint16_t)raw_len, &wire_buf[11]);
+	sys_put_le16((uint16_t)pay_len, &wire_buf[13]);
+
+	size_t len = EXPORT_HDR_LEN + pay_len;
+
+	sys_put_le16(crc16_ccitt(0, wire_buf + 1, len - 1), &wire_buf[len]);
+	len += EXPORT_CRC_LEN;
+
+	/* One write, so the chunk reaches the wire contiguously */
+	if (serial_io_write((const char *)wire_buf, len) < 0) {
+		return -ENOMEM;
+	}
+	return (int)len;
+}
+
+static void export_run(enum export_stream stream, uint32_t from)
+{
+	uint32_t oldest, end;
+	uint32_t raw_total = 0, wire_total = 0, failed = 0;
+	int64_t t0 = k_uptime_get();
+	uint8_t flags = EXPORT_F_START;
+	bool last = false;
+
+	export_range(stream, &oldest, &end);
+
+	/* Always at least one chunk, so an empty stream still ends */
+	while (!last && !atomic_get(&export_cancel)) {
+		uint32_t first = from, next;
+		size_t raw_len = export_render(stream, &first, &next, end);
+
+		last = next >= end;
+
+		if (last) {
+			flags |= EXPORT_F_LAST;
+		}
+
+		int ret = export_send_chunk(stream, flags, first, next,
+					    raw_len);
+		if (ret < 0) {
+			/* The bridge sees the gap and resumes from 'first' */
+			failed++;
+		} else {
+			wire_total += ret;
+		}
+		raw_total += raw_len;
+		from  = next;
+		flags = 0;
+
+		k_mutex_lock(&export_mutex, K_FOREVER);
+		exp_stats.chunks++;
+		k_mutex_unlock(&export_mutex);
+
+		if (raw_len == 0 && !last) {
+			break;          /* record larger than a chunk, or gone */
+		}
+	}
+
+	k_mutex_lock(&export_mutex, K_FOREVER);
+	exp_stats.exports++;
+	exp_stats.raw_bytes   = raw_total;
+	exp_stats.wire_bytes  = wire_total;
+	exp_stats.duration_ms = (uint32_t)(k_uptime_get() - t0);
+	exp_stats.failed     += failed;
+	k_mutex_unlock(&export_mutex);
+}
+
+static void export_thread_fn(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1); ARG_UNUSED(p2); ARG_UNUSED(p3);
+
+	while (1) {
+		enum export_stream stream;
+		uint32_t from;
+
+		k_sem_take(&export_sem, K_FOREVER);
+
+		k_mutex_lock(&export_mutex, K_FOREVER);
+		stream = req_stream;
+		from   = req_from;
+		atomic_clear(&export_cancel);
+		atomic_set(&export_busy, 1);
+		k_mutex_unlock(&export_mutex);
+
+		export_run(stream, from);
+		atomic_clear(&export_busy);
+	}
+}
+
+K_THREAD_DEFINE(export_tid, EXPORT_STACK_SIZE, export_thread_fn,
+		NULL, NULL, NULL, EXPORT_PRIORITY, 0, 0);
+
+/* --------------------------------------------------------------------
+ * Public API
+ * ------------------------------------------------------------------ */
+
+/**
+ * export_start — Export @p stream from record @p from.
+ *
+ * An export still running stops after its current chunk and this one
+ * starts in its place, which is how the bridge resumes a transfer.
+ */
+void export_start(enum export_stream stream, uint32_t from)
+{
+	k_mutex_lock(&export_mutex, K_FOREVER);
+	req_stream = stream;
+	req_from   = from;
+	atomic_set(&export_cancel, 1);
+	k_sem_give(&export_sem);
+	k_mutex_unlock(&export_mutex);
+}
+
+void export_get_stats(struct export_stats *out)
+{
+	k_mutex_lock(&export_mutex, K_FOREVER);
+	memcpy(out, &exp_stats, sizeof(*out));
+	k_mutex_unlock(&export_mutex);
+}
+
+/* --------------------------------------------------------------------
+ * Commands
+ * ------------------------------------------------------------------ */
+
+static int export_cmd_handler(struct cmd_session *sess,
+			      int argc, struct cmd_arg *argv)
+{
+	if (argc == 0) {
+		struct export_stats st;
+
+		export_get_stats(&st);
+		cmd_print(sess, "Exports: %u (%u chunks, %u dropped)%s\n",
+			  st.exports, st.chunks, st.failed,
+			  atomic_get(&export_busy) ? ", running" : "");
+		cmd_print(sess, "Last: %u B text -> %u B wire (%u%%) "
+			  "in %u ms\n", st.raw_bytes, st.wire_bytes,
+			  st.raw_bytes ? st.wire_bytes * 100 / st.raw_bytes : 0,
+			  st.duration_ms);
+		return 0;
+	}
+
+	if (argv[0].type != CMD_ARG_STRING) {
+		goto usage;
+	}
+	if (strcmp(argv[0].sval, "stop") == 0 && argc == 1) {
+		atomic_set(&export_cancel, 1);
+		cmd_print(sess, "Export stopping\n");
+		return 0;
+	}
+
+	enum export_stream stream;
+
+	if (strcmp(argv[0].sval, "log") == 0) {
+		stream = EXPORT_STREAM_LOG;
+	} else if (strcmp(argv[0].sval, "hist") == 0) {
+		stream = EXPORT_STREAM_HIST;
+	} else {
+		goto usage;
+	}
+
+	uint32_t from = 0;
+
+	if (argc == 2) {
+		if (argv[1].type != CMD_ARG_INT || argv[1].ival < 0) {
+			goto usage;
+		}
+		from = (uint32_t)argv[1].ival;
+	}
+
+	export_start(stream, from);
+	cmd_print(sess, "Export %s from %u started\n", argv[0].sval, from);
+	return 0;
+
+usage:
+	cmd_print(sess, "Usage: export [log|hist [from]] | export stop\n");
+	return -1;
+}
+
+/**
+ * export_init — Register the 'export' command.  Call after cmd_init().
+ */
+void export_init(void)
+{
+	cmd_register("export", "Compressed bulk export of log/history",
+		     "export [log|hist [from]] | export stop",
+		     export_cmd_handler, 0, 2);
+
+	SYSINFO_KOBJ_LABEL(export_mutex);
+	SYSINFO_KOBJ_LABEL(export_sem);
+}
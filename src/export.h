@@ -0,0 +1,57 @@
+/*
+ * ShrikeOS Monitor — Compressed Bulk Export
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SHRIKE_EXPORT_H
+#define SHRIKE_EXPORT_H
+
+#include <zephyr/kernel.h>
+
+/*
+ * Export chunk on the wire (little-endian), sent between telemetry
+ * frames and text lines:
+ *
+ *   0   sync      EXPORT_SYNC
+ *   1   stream    'L' log ring, 'H' sensor history
+ *   2   flags     EXPORT_F_*
+ *   3   first     u32, record number of the first record in the chunk
+ *   7   next      u32, record number to resume from
+ *   11  raw_len   u16, bytes of text once decompressed
+ *   13  pay_len   u16, bytes of payload that follow
+ *   15  payload   LZ4 block, or raw text without EXPORT_F_LZ4
+ *   ..  crc       u16, crc16_ccitt(0, bytes 1 .. end of payload)
+ *
+ * Each chunk holds whole text lines and decodes on its own.  A
+ * START chunk whose 'first' is later than requested means the records
+ * in between were overwritten before they could be sent.
+ */
+#define EXPORT_SYNC        0xA6
+#define EXPORT_HDR_LEN     15
+#define EXPORT_CRC_LEN     2
+#define EXPORT_CHUNK_RAW   1024   /* text bytes per chunk, at most */
+
+#define EXPORT_F_LZ4       BIT(0)
+#define EXPORT_F_LAST      BIT(1)
+#define EXPORT_F_START     BIT(2)   /* first chunk of an export request */
+
+enum export_stream {
+	EXPORT_STREAM_LOG = 'L',
+	EXPORT_STREAM_HIST = 'H',
+};
+
+struct export_stats {
+	uint32_t exports;
+	uint32_t chunks;
+	uint32_t raw_bytes;       /* of the last export */
+	uint32_t wire_bytes;      /* of the last export, incl. framing */
+	uint32_t duration_ms;     /* of the last export */
+	uint32_t failed;          /* chunks the transport dropped */
+};
+
+void export_start(enum export_stream stream, uint32_t from);
+void export_get_stats(struct export_stats *out);
+void export_init(void);
+
+#endif /* SHRIKE_EXPORT_H */
@@ -0,0 +1,106 @@
+/*
+ * ShrikeOS Monitor — Frame Buffer Pool
+ *
+ * Fixed-size I/O buffers backed by a k_mem_slab, shared by the serial
+ * RX and TX paths, telemetry and command output.  Keeping frames out
+ * of thread stacks is what lets the serial and display stacks shrink;
+ * allocation and free are O(1) and safe from ISRs.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+
+#include "command.h"
+#include "frame_pool.h"
+#include "smp.h"
+
+K_MEM_SLAB_DEFINE_STATIC(frame_slab, sizeof(struct frame_buf),
+			 FRAME_POOL_COUNT, 4);
+
+static atomic_t frames_in_use;
+static atomic_t frames_peak;
+static struct percpu_counter frame_allocs;
+static struct percpu_counter frame_failures;
+
+/* --------------------------------------------------------------------
+ * Public API
+ * ------------------------------------------------------------------ */
+
+/**
+ * frame_alloc — Borrow a frame from the pool.
+ *
+ * @param timeout  K_NO_WAIT from ISRs and loss-tolerant producers.
+ * @return         An empty frame, or NULL if none became free in time.
+ */
+struct frame_buf *frame_alloc(k_timeout_t timeout)
+{
+	struct frame_buf *f;
+
+	if (k_mem_slab_alloc(&frame_slab, (void **)&f, timeout) != 0) {
+		percpu_inc(&frame_failures);
+		return NULL;
+	}
+
+	f->len = 0;
+	f->pos = 0;
+
+	percpu_inc(&frame_allocs);
+	atomic_val_t used = atomic_inc(&frames_in_use) + 1;
+	atomic_val_t peak = atomic_get(&frames_peak);
+	while (used > peak &&
+	       !atomic_cas(&frames_peak, peak, used)) {
+		peak = atomic_get(&frames_peak);
+	}
+	return f;
+}
+
+/**
+ * frame_free — Return a frame to the pool.  NULL is ignored.
+ */
+void frame_free(struct frame_buf *f)
+{
+	if (!f) {
+		return;
+	}
+	atomic_dec(&frames_in_use);
+	k_mem_slab_free(&frame_slab, f);
+}
+
+void frame_pool_get_stats(struct frame_pool_stats *out)
+{
+	out->in_use   = (uint32_t)atomic_get(&frames_in_use);
+	out->peak     = (uint32_t)atomic_get(&frames_peak);
+	out->allocs   = percpu_sum(&frame_allocs);
+	out->failures = percpu_sum(&frame_failures);
+}
+
+/* --------------------------------------------------------------------
+ * Commands
+ * ------------------------------------------------------------------ */
+
+static int pool_cmd_handler(struct cmd_session *sess,
+			    int argc, struct cmd_arg *argv)
+{
+	ARG_UNUSED(argc); ARG_UNUSED(argv);
+	struct frame_pool_stats st;
+
+	frame_pool_get_stats(&st);
+
+	cmd_print(sess, "Frames: %u x %u B | in use %u | peak %u\n",
+		  FRAME_POOL_COUNT, (uint32_t)sizeof(struct frame_buf),
+		  st.in_use, st.peak);
+	cmd_print(sess, "Allocs: %u | failed: %u\n",
+		  st.allocs, st.failures);
+	return 0;
+}
+
+/**
+ * frame_pool_init — Register the 'pool' command.  Call after cmd_init().
+ */
+void frame_pool_init(void)
+{
+	cmd_register("pool", "Show frame buffer pool usage",
+		     "pool", pool_cmd_handler, 0, 0);
+}
@@ -0,0 +1,40 @@
+/*
+ * ShrikeOS Monitor — Frame Buffer Pool
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SHRIKE_FRAME_POOL_H
+#define SHRIKE_FRAME_POOL_H
+
+#include <zephyr/kernel.h>
+
+#define FRAME_BUF_LEN     128    /* one command line / telemetry frame */
+#define FRAME_POOL_COUNT  12
+
+/*
+ * A pooled I/O frame.  Ownership moves with the pointer: whoever holds
+ * a frame either passes it on (k_fifo, TX submit) or frees it, so a
+ * line travels from the UART ISR to the command engine, and a reply
+ * from the formatter to the ISR, without being copied.
+ */
+struct frame_buf {
+	void     *fifo_reserved;     /* first word, owned by k_fifo */
+	uint16_t  len;
+	uint16_t  pos;               /* consumer offset (TX drain)  */
+	char      data[FRAME_BUF_LEN];
+};
+
+struct frame_pool_stats {
+	uint32_t in_use;
+	uint32_t peak;
+	uint32_t allocs;
+	uint32_t failures;
+};
+
+struct frame_buf *frame_alloc(k_timeout_t timeout);
+void              frame_free(struct frame_buf *f);
+void              frame_pool_get_stats(struct frame_pool_stats *out);
+void              frame_pool_init(void);
+
+#endif /* SHRIKE_FRAME_POOL_H */
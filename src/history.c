@@ -0,0 +1,134 @@
+/*
+ * ShrikeOS Monitor — Sensor History
+ *
+ * The last HISTORY_SAMPLES temperature readings with their timestamps,
+ * for bulk export.  Samples are numbered from boot; a reader keeps the
+ * number of the next sample it wants, so an interrupted export resumes
+ * where it stopped as long as that sample has not been overwritten.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "history.h"
+#include "json.h"
+
+struct history_sample {
+	uint32_t t_ms;
+	int16_t  temp_dc;
+};
+
+static struct history_sample samples[HISTORY_SAMPLES];
+static uint32_t              sample_next;    /* number of the next push */
+
+K_MUTEX_DEFINE(history_mutex);
+
+/**
+ * history_push — Record a temperature reading (tenths of a degree C).
+ */
+void history_push(int16_t temp_dc)
+{
+	k_mutex_lock(&history_mutex, K_FOREVER);
+	struct history_sample *s = &samples[sample_next % HISTORY_SAMPLES];
+
+	s->t_ms    = k_uptime_get_32();
+	s->temp_dc = temp_dc;
+	sample_next++;
+	k_mutex_unlock(&history_mutex);
+}
+
+/**
+ * history_range — Number of the oldest retained sample and of the next
+ * one to be recorded.
+ */
+void history_range(uint32_t *oldest, uint32_t *next)
+{
+	k_mutex_lock(&history_mutex, K_FOREVER);
+
+	*next   = sample_next;
+	*oldest = sample_next > HISTORY_SAMPLES ?
+		  sample_next - HISTORY_SAMPLES : 0;
+	k_mutex_unlock(&history_mutex);
+}
+
+/**
+ * history_export_text — Render samples from number *first up to (not
+ * including) @p end as "t_ms,temp" CSV lines, whole lines only.
+ *
+ * On return *first is the first sample actually rendered (later than
+ * requested if it was overwritten) and *next the number to continue
+ * from.
+ *
+ * @return  Bytes written to @p buf (not NUL-terminated).
+ */
+size_t history_export_text(uint32_t *first, uint32_t *next, uint32_t end,
+			   char *buf, size_t len)
+{
+	size_t pos = 0;
+
+	k_mutex_lock(&history_mutex, K_FOREVER);
+	uint32_t oldest = sample_next > HISTORY_SAMPLES ?
+			  sample_next - HISTORY_SAMPLES : 0;
+	uint32_t idx = MAX(*first, oldest);
+
+	*first = idx;
+	end = MIN(end, sample_next);
+
+	while (idx < end) {
+		const struct history_sample *s = &samples[idx % HISTORY_SAMPLES];
+		char line[24];
+
+		int n = snprintf(line, sizeof(line), "%u,%s%d.%d\n", s->t_ms,
+				 s->temp_dc < 0 ? "-" : "",
+				 abs(s->temp_dc) / 10, abs(s->temp_dc) % 10);
+
+		if (n < 0 || pos + (size_t)n > len) {
+			break;
+		}
+		memcpy(buf + pos, line, n);
+		pos += n;
+		idx++;
+	}
+	*next = idx;
+
+	k_mutex_unlock(&history_mutex);
+	return pos;
+}
+
+/**
+ * history_format_json — Serialise the last @p count samples, oldest
+ * first, as {"next":n,"t_ms":<time of the newest>,"temp":[...]}.
+ *
+ * @return  Length written, or -ENOMEM if @p buf was too small.
+ */
+int history_format_json(char *buf, size_t buf_len, int count)
+{
+	struct json_writer w;
+
+	json_init(&w, buf, buf_len);
+	json_obj_begin(&w);
+
+	k_mutex_lock(&history_mutex, K_FOREVER);
+	uint32_t n = MIN((uint32_t)MAX(count, 0),
+			 MIN(sample_next, HISTORY_SAMPLES));
+
+	json_key(&w, "next");
+	json_u32(&w, sample_next);
+	json_key(&w, "t_ms");
+	json_u32(&w, n ? samples[(sample_next - 1) % HISTORY_SAMPLES].t_ms : 0);
+	json_key(&w, "temp");
+	json_arr_begin(&w);
+	for (uint32_t idx = sample_next - n; idx < sample_next; idx++) {
+		json_fixed(&w, samples[idx % HISTORY_SAMPLES].temp_dc, 1);
+	}
+	json_arr_end(&w);
+	k_mutex_unlock(&history_mutex);
+
+	json_obj_end(&w);
+	return json_finish(&w);
+}
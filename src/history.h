@@ -0,0 +1,20 @@
+/*
+ * ShrikeOS Monitor — Sensor History
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SHRIKE_HISTORY_H
+#define SHRIKE_HISTORY_H
+
+#include <zephyr/kernel.h>
+
+#define HISTORY_SAMPLES  600    /* 10 minutes at the 1 s sensor period */
+
+void   history_push(int16_t temp_dc);
+void   history_range(uint32_t *oldest, uint32_t *next);
+size_t history_export_text(uint32_t *first, uint32_t *next, uint32_t end,
+			   char *buf, size_t len);
+int    history_format_json(char *buf, size_t buf_len, int count);
+
+#endif /* SHRIKE_HISTORY_H */
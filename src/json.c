@@ -0,0 +1,403 @@
+/*
+ * ShrikeOS Monitor — Lightweight JSON Writer
+ *
+ * Append-only JSON encoder shared by every device serialiser.  It
+ * writes straight into a caller buffer, formats integers and fixed-
+ * point values two digits at a time from a lookup table (no printf,
+ * no soft-float), escapes strings, and latches an overflow flag
+ * instead of writing past the end.  Frame layouts are described once
+ * as static json_field tables and encoded by json_fields().
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+#include <string.h>
+
+#include "json.h"
+
+static const char digit_pairs[200] = {
+	'0','0','0','1','0','2','0','3','0','4','0','5','0','6','0','7','0','8','0','9',
+	'1','0','1','1','1','2','1','3','1','4','1','5','1','6','1','7','1','8','1','9',
+	'2','0','2','1','2','2','2','3','2','4','2','5','2','6','2','7','2','8','2','9',
+	'3','0','3','1','3','2','3','3','3','4','3','5','3','6','3','7','3','8','3','9',
+	'4','0','4','1','4','2','4','3','4','4','4','5','4','6','4','7','4','8','4','9',
+	'5','0','5','1','5','2','5','3','5','4','5','5','5','6','5','7','5','8','5','9',
+	'6','0','6','1','6','2','6','3','6','4','6','5','6','6','6','7','6','8','6','9',
+	'7','0','7','1','7','2','7','3','7','4','7','5','7','6','7','7','7','8','7','9',
+	'8','0','8','1','8','2','8','3','8','4','8','5','8','6','8','7','8','8','8','9',
+	'9','0','9','1','9','2','9','3','9','4','9','5','9','6','9','7','9','8','9','9',
+};
+
+static const uint32_t pow10_tbl[] = {
+	1, 10, 100, 1000, 10000, 100000, 1000000,
+};
+
+static const char hex_digits[] = "0123456789abcdef";
+
+/* --------------------------------------------------------------------
+ * Low-level append
+ * ------------------------------------------------------------------ */
+
+void json_init(struct json_writer *w, char *buf, size_t cap)
+{
+	w->buf       = buf;
+	w->cap       = cap;
+	w->len       = 0;
+	w->overflow  = false;
+	w->after_key = false;
+	w->depth     = 0;
+	w->first     = BIT(0);
+}
+
+/**
+ * json_finish — NUL-terminate the output.
+ *
+ * @return  Length excluding NUL, or -ENOMEM if anything was dropped.
+ */
+int json_finish(struct json_writer *w)
+{
+	if (w->cap == 0) {
+		return -ENOMEM;
+	}
+	if (w->len >= w->cap) {
+		w->len = w->cap - 1;
+		w->overflow = true;
+	}
+	w->buf[w->len] = '\0';
+	return w->overflow ? -ENOMEM : (int)w->len;
+}
+
+/* One byte is always kept back for the terminating NUL */
+static inline bool json_room(struct json_writer *w, size_t n)
+{
+	if (w->overflow || w->len + n >= w->cap) {
+		w->overflow = true;
+		return false;
+	}
+	return true;
+}
+
+void json_raw(struct json_writer *w, const char *s, size_t n)
+{
+	if (!json_room(w, n)) return;
+	memcpy(w->buf + w->len, s, n);
+	w->len += n;
+}
+
+static inline void json_putc(struct json_writer *w, char c)
+{
+	if (!json_room(w, 1)) return;
+	w->buf[w->len++] = c;
+}
+
+/* Emit the ',' between siblings; values straight after a key skip it */
+static void json_sep(struct json_writer *w)
+{
+	uint8_t bit = BIT(w->depth);
+
+	if (w->after_key) {
+		w->after_key = false;
+		return;
+	}
+	if (w->first & bit) {
+		w->first &= ~bit;
+	} else {
+		json_putc(w, ',');
+	}
+}
+
+/* --------------------------------------------------------------------
+ * Structure
+ * ------------------------------------------------------------------ */
+
+static void json_open(struct json_writer *w, char c)
+{
+	json_sep(w);
+	json_putc(w, c);
+	if (w->depth < JSON_MAX_DEPTH - 1) {
+		w->depth++;
+	}
+	w->first |= BIT(w->depth);
+}
+
+static void json_close(struct json_writer *w, char c)
+{
+	if (w->depth > 0) {
+		w->depth--;
+	}
+	json_putc(w, c);
+}
+
+void json_obj_begin(struct json_writer *w) { json_open(w, '{'); }
+void json_obj_end(struct json_writer *w)   { json_close(w, '}'); }
+void json_arr_begin(struct json_writer *w) { json_open(w, '['); }
+void json_arr_end(struct json_writer *w)   { json_close(w, ']'); }
+
+/* --------------------------------------------------------------------
+ * Scalars
+ * ------------------------------------------------------------------ */
+
+/* Format v into the tail of tmp[10]; returns the first digit */
+static char *fmt_u32(char tmp[10], uint32_t v)
+{
+	char *p = tmp + 10;
+
+	while (v >= 100) {
+		uint32_t q = v / 100;
+		uint32_t r = (v - q * 100) * 2;
+		v = q;
+		*--p = digit_pairs[r + 1];
+		*--p = digit_pairs[r];
+	}
+	if (v >= 10) {
+		*--p = digit_pairs[v * 2 + 1];
+		*--p = digit_pairs[v * 2];
+	} else {
+		*--p = (char)('0' + v);
+	}
+	return p;
+}
+
+static void put_u32(struct json_writer *w, uint32_t v)
+{
+	char tmp[10];
+	char *p = fmt_u32(tmp, v);
+
+	json_raw(w, p, (size_t)(tmp + 10 - p));
+}
+
+void json_u32(struct json_writer *w, uint32_t v)
+{
+	json_sep(w);
+	put_u32(w, v);
+}
+
+void json_i32(struct json_writer *w, int32_t v)
+{
+	json_sep(w);
+	if (v < 0) {
+		json_putc(w, '-');
+		put_u32(w, (uint32_t)0 - (uint32_t)v);
+	} else {
+		put_u32(w, (uint32_t)v);
+	}
+}
+
+/**
+ * json_fixed — Emit a fixed-point number.
+ *
+ * @param v         Value scaled by 10^decimals (e.g. 345 with 1 -> 34.5).
+ * @param decimals  Digits after the point, 0..6.
+ */
+void json_fixed(struct json_writer *w, int32_t v, uint8_t decimals)
+{
+	uint32_t mag;
+
+	json_sep(w);
+
+	decimals = MIN(decimals, ARRAY_SIZE(pow10_tbl) - 1);
+	if (v < 0) {
+		json_putc(w, '-');
+		mag = (uint32_t)0 - (uint32_t)v;
+	} else {
+		mag = (uint32_t)v;
+	}
+
+	if (decimals == 0) {
+		put_u32(w, mag);
+		return;
+	}
+
+	uint32_t scale = pow10_tbl[decimals];
+	uint32_t ip = mag / scale;
+	uint32_t fp = mag - ip * scale;
+	char tmp[10];
+	char *p;
+
+	put_u32(w, ip);
+	json_putc(w, '.');
+
+	/* Fractional part, left-padded with zeros to 'decimals' digits */
+	p = fmt_u32(tmp, fp);
+	for (size_t n = (size_t)(tmp + 10 - p); n < decimals; n++) {
+		json_putc(w, '0');
+	}
+	json_raw(w, p, (size_t)(tmp + 10 - p));
+}
+
+void json_bool(struct json_writer *w, bool v)
+{
+	json_sep(w);
+	json_putc(w, v ? '1' : '0');
+}
+
+static void put_escaped(struct json_writer *w, const char *s)
+{
+	json_putc(w, '"');
+
+	while (*s) {
+		/* Copy runs of plain characters in one go */
+		const char *run = s;
+		while (*s && *s != '"' && *s != '\\' &&
+		       (unsigned char)*s >= 0x20) {
+			s++;
+		}
+		if (s > run) {
+			json_raw(w, run, (size_t)(s - run));
+		}
+		if (*s == '\0') {
+			break;
+		}
+
+		unsigned char c = (unsigned char)*s++;
+		char esc[6] = { '\\', 0 };
+		size_t n = 2;
+
+		switch (c) {
+		case '"':  esc[1] = '"';  break;
+		case '\\': esc[1] = '\\'; break;
+		case '\n': esc[1] = 'n';  break;
+		case '\r': esc[1] = 'r';  break;
+		case '\t': esc[1] = 't';  break;
+		default:
+			esc[1] = 'u'; esc[2] = '0'; esc[3] = '0';
+			esc[4] = hex_digits[c >> 4];
+			esc[5] = hex_digits[c & 0xF];
+			n = 6;
+			break;
+		}
+		json_raw(w, esc, n);
+	}
+
+	json_putc(w, '"');
+}
+
+void json_str(struct json_writer *w, const char *s)
+{
+	json_sep(w);
+	put_escaped(w, s ? s : "");
+}
+
+/**
+ * json_value_raw — Emit an already encoded JSON value (e.g. an object
+ * rendered earlier) as the next value.
+ */
+void json_value_raw(struct json_writer *w, const char *s)
+{
+	json_sep(w);
+	json_raw(w, s, strlen(s));
+}
+
+/**
+ * json_value_begin — Start a value that another formatter (e.g. a
+ * module's *_format_json()) encodes straight into the writer's buffer.
+ *
+ * @param room  Set to the space left, terminating NUL included.
+ * @return      Where the value goes; pass its length, or the formatter's
+ *              negative error, to json_value_end().
+ */
+char *json_value_begin(struct json_writer *w, size_t *room)
+{
+	json_sep(w);
+	*room = (w->overflow || w->len >= w->cap) ? 0 : w->cap - w->len;
+	return w->buf + w->len;
+}
+
+void json_value_end(struct json_writer *w, int len)
+{
+	if (len < 0 || w->len + (size_t)len >= w->cap) {
+		w->overflow = true;
+	} else {
+		w->len += (size_t)len;
+	}
+}
+
+void json_key(struct json_writer *w, const char *key)
+{
+	json_sep(w);
+	put_escaped(w, key);
+	json_putc(w, ':');
+	w->after_key = true;
+}
+
+/* --------------------------------------------------------------------
+ * Descriptor encoder
+ * ------------------------------------------------------------------ */
+
+/* Enum members are int-sized unless packed into a smaller type */
+static int32_t json_enum_value(const void *p, uint8_t size)
+{
+	switch (size) {
+	case 1:
+		return *(const uint8_t *)p;
+	case 2:
+		return *(const uint16_t *)p;
+	default:
+		return *(const int32_t *)p;
+	}
+}
+
+/**
+ * json_fields — Emit "key":value pairs for each field of @p obj.
+ *
+ * Must be called inside an open object; the caller adds any extra
+ * members before or after.
+ */
+void json_fields(struct json_writer *w, const struct json_field *fields,
+		 size_t count, const void *obj)
+{
+	const uint8_t *base = obj;
+
+	for (size_t i = 0; i < count; i++) {
+		const struct json_field *f = &fields[i];
+		const void *p = base + f->offset;
+
+		json_key(w, f->key);
+
+		switch (f->type) {
+		case JSON_F_U8:
+			json_u32(w, *(const uint8_t *)p);
+			break;
+		case JSON_F_U16:
+			json_u32(w, *(const uint16_t *)p);
+			break;
+		case JSON_F_U32:
+			json_u32(w, *(const uint32_t *)p);
+			break;
+		case JSON_F_I16:
+			json_i32(w, *(const int16_t *)p);
+			break;
+		case JSON_F_I32:
+			json_i32(w, *(const int32_t *)p);
+			break;
+		case JSON_F_BOOL:
+			json_bool(w, *(const bool *)p);
+			break;
+		case JSON_F_FIXED16:
+			json_fixed(w, *(const int16_t *)p, f->decimals);
+			break;
+		case JSON_F_FIXED32:
+			json_fixed(w, *(const int32_t *)p, f->decimals);
+			break;
+		case JSON_F_STR:
+			json_str(w, (const char *)p);
+			break;
+		case JSON_F_ENUM: {
+			int32_t v = json_enum_value(p, f->size);
+
+			/* A bad value is shown, not used to index names[] */
+			if (v >= 0 && v < f->name_count) {
+				json_str(w, f->names[v]);
+			} else {
+				json_i32(w, v);
+			}
+			break;
+		}
+		default:
+			json_u32(w, 0);
+			break;
+		}
+	}
+}
@@ -0,0 +1,123 @@
+/*
+ * ShrikeOS Monitor — Lightweight JSON Writer
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SHRIKE_JSON_H
+#define SHRIKE_JSON_H
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+#include <stddef.h>
+
+#define JSON_MAX_DEPTH  8
+
+/* Append-only writer into a caller-owned buffer */
+struct json_writer {
+	char    *buf;
+	size_t   cap;
+	size_t   len;
+	bool     overflow;
+	bool     after_key;
+	uint8_t  depth;
+	uint8_t  first;          /* bit d: next item at depth d is first */
+};
+
+/* Field types understood by the descriptor encoder */
+enum json_field_type {
+	JSON_F_U8 = 0,
+	JSON_F_U16,
+	JSON_F_U32,
+	JSON_F_I16,
+	JSON_F_I32,
+	JSON_F_BOOL,        /* emitted as 0/1, matching the telemetry frames */
+	JSON_F_FIXED16,     /* int16_t scaled by 10^decimals                 */
+	JSON_F_FIXED32,     /* int32_t scaled by 10^decimals                 */
+	JSON_F_STR,         /* char array member, escaped                    */
+	JSON_F_ENUM,        /* enum member, emitted as names[value], or the  */
+	                    /* number if out of range                        */
+};
+
+/* One member of a frame layout */
+struct json_field {
+	const char        *key;
+	uint16_t           offset;
+	uint8_t            type;
+	uint8_t            decimals;
+	uint8_t            size;        /* JSON_F_ENUM: member size in bytes */
+	uint8_t            name_count;  /* JSON_F_ENUM: entries in names[]   */
+	const char *const *names;
+};
+
+#define JSON_FIELD(st, member, k, t) \
+	{ .key = (k), .offset = offsetof(st, member), .type = (t) }
+#define JSON_FIELD_FIXED(st, member, k, t, dec) \
+	{ .key = (k), .offset = offsetof(st, member), .type = (t), \
+	  .decimals = (dec) }
+#define JSON_FIELD_ENUM(st, member, k, tbl) \
+	{ .key = (k), .offset = offsetof(st, member), .type = JSON_F_ENUM, \
+	  .size = sizeof(((st *)0)->member), .name_count = ARRAY_SIZE(tbl), \
+	  .names = (tbl) }
+
+void json_init(struct json_writer *w, char *buf, size_t cap);
+int  json_finish(struct json_writer *w);
+
+void json_raw(struct json_writer *w, const char *s, size_t n);
+void json_obj_begin(struct json_writer *w);
+void json_obj_end(struct json_writer *w);
+void json_arr_begin(struct json_writer *w);
+void json_arr_end(struct json_writer *w);
+void json_key(struct json_writer *w, const char *key);
+
+void json_u32(struct json_writer *w, uint32_t v);
+void json_i32(struct json_writer *w, int32_t v);
+void json_fixed(struct json_writer *w, int32_t v, uint8_t decimals);
+void json_bool(struct json_writer *w, bool v);
+void json_str(struct json_writer *w, const char *s);
+void json_value_raw(struct json_writer *w, const char *s);
+char *json_value_begin(struct json_writer *w, size_t *room);
+void  json_value_end(struct json_writer *w, int len);
+
+void json_fields(struct json_writer *w, const struct json_field *fields,
+		 size_t count, const void *obj);
+
+/* Save/restore point, e.g. to drop a partially written array element */
+struct json_mark {
+	size_t  len;
+	uint8_t depth;
+	uint8_t first;
+	bool    after_key;
+	bool    overflow;
+};
+
+static inline struct json_mark json_checkpoint(const struct json_writer *w)
+{
+	return (struct json_mark){
+		w->len, w->depth, w->first, w->after_key, w->overflow
+	};
+}
+
+static inline void json_rewind(struct json_writer *w, struct json_mark m)
+{
+	w->len       = m.len;
+	w->depth     = m.depth;
+	w->first     = m.first;
+	w->after_key = m.after_key;
+	w->overflow  = m.overflow;
+}
+
+/* Hold back n bytes (e.g. for closing brackets) while appending a
+ * variable number of elements; n must be smaller than the buffer.
+ */
+static inline void json_reserve(struct json_writer *w, size_t n)
+{
+	w->cap -= n;
+}
+
+static inline void json_release(struct json_writer *w, size_t n)
+{
+	w->cap += n;
+}
+
+#endif /* SHRIKE_JSON_H */
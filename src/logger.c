@@ -4,30 +4,54 @@
  * In-memory circular log buffer with timestamps, level filtering,
  * and query support. Logs can be retrieved from the dashboard.
  *
+ * The ring is also a Zephyr log back end.  Deferred LOG_* messages, and
+ * printk via CONFIG_LOG_PRINTK, are stored as the cbprintf package the
+ * log core already built and are only rendered when an entry is read.
+ * Entries written through shrike_log() are formatted once on entry.
+ * Either way each message is formatted exactly once, and no caller
+ * waits on console output.
+ *
+ * shrike_log_kv() records a structured event instead: an event whose
+ * schema (name, id, typed keys) lives in flash, and only the packed
+ * values in the entry.  It is rendered as one JSON object, e.g.
+ * {"ev":"wdg_timeout","id":2,"thread":"sensor","elapsed_ms":5012}, in
+ * dumps and exports, and nested as "kv" in JSON output, so host tools
+ * read fields instead of parsing messages.
+ *
+ * Entries are kept in sequence and time order, so queries find the start
+ * and end of a time or sequence window by binary search instead of
+ * scanning the ring, then filter by level, module or text within it.
+ * shrike_log_query_next() returns one match at a time through a cursor,
+ * holding the mutex only to copy the entry, and 'log q' pages through
+ * results with it.
+ *
  * SPDX-License-Identifier: Apache-2.0
  */
 
 #include <zephyr/kernel.h>
+#include <zephyr/logging/log_backend.h>
+#include <zephyr/logging/log_core.h>
+#include <zephyr/logging/log_ctrl.h>
+#include <zephyr/logging/log_msg.h>
+#include <zephyr/logging/log_output.h>
+#include <zephyr/sys/cbprintf.h>
 #include <zephyr/sys/util.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
+#include "command.h"
+#include "console.h"
+#include "json.h"
+#include "logger.h"
+#include "sysinfo.h"
+
 /* --------------------------------------------------------------------
  * Configuration
  * ------------------------------------------------------------------ */
 
 #define LOG_BUF_ENTRIES    64
-#define LOG_MSG_MAX_LEN    80
-#define LOG_MODULE_MAX_LEN 16
-
-/* Log levels */
-enum log_level {
-	LOG_LVL_DEBUG = 0,
-	LOG_LVL_INFO,
-	LOG_LVL_WARN,
-	LOG_LVL_ERROR,
-	LOG_LVL_COUNT,
-};
+#define LOG_QUERY_PAGE     16     /* 'log q' entries per page */
 
 static const char *const log_level_names[] = {
 	[LOG_LVL_DEBUG] = "DEBUG",
@@ -43,21 +67,52 @@ static const char *const log_level_tags[] = {
 	[LOG_LVL_ERROR] = "[E]",
 };
 
-/* Single log entry */
+/* Single log entry; the message is text, a cbprintf package or the
+ * packed values of a structured event
+ */
 struct log_entry {
-	uint32_t       timestamp_ms;
-	enum log_level level;
-	char           module[LOG_MODULE_MAX_LEN];
-	char           message[LOG_MSG_MAX_LEN];
+	uint32_t                timestamp_ms;
+	enum log_level          level;
+	char                    module[LOG_MODULE_MAX_LEN];
+	const struct log_event *event;       /* set: 'pkg' holds values  */
+	uint8_t                 pkg_len;     /* 0: 'message' holds text  */
+	union {
+		char    message[LOG_MSG_MAX_LEN];
+		uint8_t pkg[LOG_MSG_MAX_LEN]
+			__aligned(CBPRINTF_PACKAGE_ALIGNMENT);
+	};
 	uint32_t       sequence;
 };
 
+/* JSON layout of one entry, around the rendered "msg" (or "kv") */
+static const struct json_field log_entry_head_fields[] = {
+	JSON_FIELD(struct log_entry, timestamp_ms, "t", JSON_F_U32),
+	JSON_FIELD_ENUM(struct log_entry, level, "l", log_level_names),
+	JSON_FIELD(struct log_entry, module, "m", JSON_F_STR),
+};
+
+static const struct json_field log_entry_tail_fields[] = {
+	JSON_FIELD(struct log_entry, sequence, "seq", JSON_F_U32),
+};
+
+/* Same layout for a query result ('log q ... json=1') */
+static const struct json_field log_record_head_fields[] = {
+	JSON_FIELD(struct log_record, timestamp_ms, "t", JSON_F_U32),
+	JSON_FIELD_ENUM(struct log_record, level, "l", log_level_names),
+	JSON_FIELD(struct log_record, module, "m", JSON_F_STR),
+};
+
+static const struct json_field log_record_tail_fields[] = {
+	JSON_FIELD(struct log_record, seq, "seq", JSON_F_U32),
+};
+
 /* Circular buffer */
 struct log_buffer {
 	struct log_entry entries[LOG_BUF_ENTRIES];
 	int              head;
 	int              count;
 	uint32_t         next_seq;
+	uint32_t         last_ms;     /* newest timestamp */
 };
 
 /* Statistics */
@@ -66,6 +121,9 @@ struct log_stats {
 	uint32_t dropped_messages;
 	uint32_t per_level[LOG_LVL_COUNT];
 	uint32_t queries_performed;
+	uint32_t backend_messages;   /* captured from Zephyr logging   */
+	uint32_t backend_dropped;    /* lost before reaching the ring  */
+	uint32_t events;             /* structured, from shrike_log_kv */
 };
 
 /* ------------------------------------------------------------------ */
@@ -80,27 +138,27 @@ K_MUTEX_DEFINE(log_mutex);
  * Core API
  * ------------------------------------------------------------------ */
 
-/**
- * shrike_log — Write a message to the log buffer.
- *
- * @param level   Severity level.
- * @param module  Module name (e.g. "WDG", "SYS").
- * @param fmt     printf-style format string.
- */
-void shrike_log(enum log_level level, const char *module,
-		const char *fmt, ...)
+/* Caller holds log_mutex.  Claim the next slot and fill the header. */
+static struct log_entry *log_ring_claim(enum log_level level,
+					const char *module,
+					uint32_t timestamp_ms)
 {
-	if (level < log_min_level) {
-		return;
-	}
-
-	k_mutex_lock(&log_mutex, K_FOREVER);
-
 	struct log_entry *e = &log_buf.entries[log_buf.head];
 
-	e->timestamp_ms = k_uptime_get_32();
+	/* A deferred message can be older than an entry written directly
+	 * while it was queued.  It takes that entry's time instead, so the
+	 * ring stays in time order and can be binary-searched.
+	 */
+	if (log_buf.count && (int32_t)(timestamp_ms - log_buf.last_ms) < 0) {
+		timestamp_ms = log_buf.last_ms;
+	}
+	log_buf.last_ms = timestamp_ms;
+
+	e->timestamp_ms = timestamp_ms;
 	e->level        = level;
 	e->sequence     = log_buf.next_seq++;
+	e->event        = NULL;
+	e->pkg_len      = 0;
 
 	if (module) {
 		strncpy(e->module, module, LOG_MODULE_MAX_LEN - 1);
@@ -108,12 +166,12 @@ void shrike_log(enum log_level level, const char *module,
 	} else {
 		e->module[0] = '\0';
 	}
+	return e;
+}
 
-	va_list ap;
-	va_start(ap, fmt);
-	vsnprintf(e->message, LOG_MSG_MAX_LEN, fmt, ap);
-	va_end(ap);
-
+/* Caller holds log_mutex.  Publish the slot claimed last. */
+static void log_ring_commit(enum log_level level)
+{
 	log_buf.head = (log_buf.head + 1) % LOG_BUF_ENTRIES;
 	if (log_buf.count < LOG_BUF_ENTRIES) {
 		log_buf.count++;
@@ -125,15 +183,254 @@ void shrike_log(enum log_level level, const char *module,
 	if (level < LOG_LVL_COUNT) {
 		log_st.per_level[level]++;
 	}
+}
+
+struct log_render {
+	char   *buf;
+	size_t  len;
+	size_t  pos;
+};
+
+static int log_render_out(int c, void *ctx)
+{
+	struct log_render *r = ctx;
+
+	if (r->pos + 1 < r->len) {
+		r->buf[r->pos++] = (char)c;
+	}
+	return c;
+}
+
+/*
+ * Pack the values of @p ev, passed as shrike_log_kv() takes them, into
+ * @p out: 4 bytes per number, 1 per bool, and a length byte plus the
+ * characters per string.  Fields that do not fit are left out, strings
+ * are cut to what fits.
+ */
+static size_t log_kv_pack(const struct log_event *ev, uint8_t *out,
+			  size_t cap, va_list ap)
+{
+	size_t pos = 0;
+
+	for (int i = 0; i < ev->nfields; i++) {
+		switch (ev->fields[i].type) {
+		case LOG_KV_U32:
+		case LOG_KV_I32: {
+			uint32_t v = va_arg(ap, uint32_t);
+
+			if (pos + sizeof(v) > cap) {
+				return pos;
+			}
+			memcpy(out + pos, &v, sizeof(v));
+			pos += sizeof(v);
+			break;
+		}
+		case LOG_KV_BOOL: {
+			int v = va_arg(ap, int);
+
+			if (pos + 1 > cap) {
+				return pos;
+			}
+			out[pos++] = v != 0;
+			break;
+		}
+		case LOG_KV_STR: {
+			const char *v = va_arg(ap, const char *);
+			size_t n = v ? strlen(v) : 0;
+
+			if (pos + 1 > cap) {
+				return pos;
+			}
+			n = MIN(n, MIN((size_t)LOG_KV_STR_MAX, cap - pos - 1));
+			out[pos++] = (uint8_t)n;
+			memcpy(out + pos, v, n);
+			pos += n;
+			break;
+		}
+		default:
+			return pos;
+		}
+	}
+	return pos;
+}
+
+/*
+ * Write event @p ev with its packed values as a JSON object.  Fields
+ * that do not fit in the writer are dropped whole, so the object stays
+ * valid.
+ */
+static void log_kv_json(struct json_writer *w, const struct log_event *ev,
+			const uint8_t *vals, size_t len)
+{
+	size_t pos = 0;
+
+	json_obj_begin(w);
+	json_key(w, "ev");
+	json_str(w, ev->name);
+	json_key(w, "id");
+	json_u32(w, ev->id);
+
+	/* Keep room for the closing '}' */
+	json_reserve(w, 1);
+	for (int i = 0; i < ev->nfields && pos < len; i++) {
+		struct json_mark m = json_checkpoint(w);
+		uint32_t v;
+
+		json_key(w, ev->fields[i].key);
+		switch (ev->fields[i].type) {
+		case LOG_KV_U32:
+			memcpy(&v, vals + pos, sizeof(v));
+			pos += sizeof(v);
+			json_u32(w, v);
+			break;
+		case LOG_KV_I32:
+			memcpy(&v, vals + pos, sizeof(v));
+			pos += sizeof(v);
+			json_i32(w, (int32_t)v);
+			break;
+		case LOG_KV_BOOL:
+			json_bool(w, vals[pos++] != 0);
+			break;
+		case LOG_KV_STR: {
+			char str[LOG_KV_STR_MAX + 1];
+			size_t n = vals[pos++];
+
+			memcpy(str, vals + pos, n);
+			str[n] = '\0';
+			pos += n;
+			json_str(w, str);
+			break;
+		}
+		}
+
+		if (w->overflow) {
+			json_rewind(w, m);
+			break;
+		}
+	}
+	json_release(w, 1);
+	json_obj_end(w);
+}
+
+/* Render a structured event into @p buf as a JSON object */
+static void log_kv_text(const struct log_event *ev, const uint8_t *vals,
+			size_t len, char *buf, size_t buf_len)
+{
+	struct json_writer w;
+
+	json_init(&w, buf, buf_len);
+	log_kv_json(&w, ev, vals, len);
+	json_finish(&w);
+}
+
+/**
+ * log_entry_text — Message of @p e as text, rendering a package or an
+ * event into @p buf (LOG_MSG_MAX_LEN bytes) if needed.  Trailing
+ * newlines, which printk messages carry, are dropped.
+ */
+static const char *log_entry_text(const struct log_entry *e, char *buf)
+{
+	struct log_render r = { .buf = buf, .len = LOG_MSG_MAX_LEN };
+
+	if (e->event) {
+		log_kv_text(e->event, e->pkg, e->pkg_len, buf,
+			    LOG_MSG_MAX_LEN);
+		return buf;
+	}
+	if (e->pkg_len == 0) {
+		return e->message;
+	}
+
+	cbpprintf((cbprintf_cb)log_render_out, &r, (void *)e->pkg);
+	while (r.pos > 0 && (buf[r.pos - 1] == '\n' ||
+			     buf[r.pos - 1] == '\r')) {
+		r.pos--;
+	}
+	buf[r.pos] = '\0';
+	return buf;
+}
+
+/**
+ * shrike_log — Write a message to the log buffer.
+ *
+ * @param level   Severity level.
+ * @param module  Module name (e.g. "WDG", "SYS").
+ * @param fmt     printf-style format string.
+ */
+void shrike_log(enum log_level level, const char *module,
+		const char *fmt, ...)
+{
+	if (level < log_min_level) {
+		return;
+	}
+
+	k_mutex_lock(&log_mutex, K_FOREVER);
+
+	struct log_entry *e = log_ring_claim(level, module,
+					     k_uptime_get_32());
+
+	va_list ap;
+	va_start(ap, fmt);
+	vsnprintf(e->message, LOG_MSG_MAX_LEN, fmt, ap);
+	va_end(ap);
+
+	log_ring_commit(level);
 
 	k_mutex_unlock(&log_mutex);
 }
 
-/* Convenience macros */
-#define SHRIKE_LOG_D(mod, ...) shrike_log(LOG_LVL_DEBUG, mod, __VA_ARGS__)
-#define SHRIKE_LOG_I(mod, ...) shrike_log(LOG_LVL_INFO,  mod, __VA_ARGS__)
-#define SHRIKE_LOG_W(mod, ...) shrike_log(LOG_LVL_WARN,  mod, __VA_ARGS__)
-#define SHRIKE_LOG_E(mod, ...) shrike_log(LOG_LVL_ERROR, mod, __VA_ARGS__)
+/**
+ * shrike_log_kv — Record a structured event.
+ *
+ * The values follow @p ev, one per field in the order the event lists
+ * them, with the C types given by enum log_kv_type.  The event is also
+ * echoed to the console as "[<module>] <JSON object>".
+ *
+ * @param level   Severity level.
+ * @param module  Module name (e.g. "WDG", "SYS").
+ * @param ev      Event, from SHRIKE_LOG_EVENT_DEFINE().
+ */
+void shrike_log_kv(enum log_level level, const char *module,
+		   const struct log_event *ev, ...)
+{
+	uint8_t vals[LOG_MSG_MAX_LEN];
+	char line[LOG_MODULE_MAX_LEN + LOG_MSG_MAX_LEN + 4];
+	size_t len;
+	va_list ap;
+
+	if (level < log_min_level) {
+		return;
+	}
+
+	va_start(ap, ev);
+	len = log_kv_pack(ev, vals, sizeof(vals), ap);
+	va_end(ap);
+
+	k_mutex_lock(&log_mutex, K_FOREVER);
+
+	struct log_entry *e = log_ring_claim(level, module,
+					     k_uptime_get_32());
+
+	memcpy(e->pkg, vals, len);
+	e->pkg_len = (uint8_t)len;
+	e->event   = ev;
+
+	log_ring_commit(level);
+	log_st.events++;
+
+	k_mutex_unlock(&log_mutex);
+
+	/* Straight to the console ring: a printk would be captured into
+	 * the log ring a second time
+	 */
+	int n = snprintf(line, sizeof(line), "[%.*s] ",
+			 LOG_MODULE_MAX_LEN - 1, module ? module : "");
+
+	log_kv_text(ev, vals, len, line + n, LOG_MSG_MAX_LEN);
+	n += strlen(line + n);
+	line[n++] = '\n';
+	console_write(line, (size_t)n);
+}
 
 /**
  * shrike_log_set_level — Set the minimum log level filter.
@@ -174,84 +471,221 @@ void shrike_log_clear(void)
  * Query API
  * ------------------------------------------------------------------ */
 
+/* Caller holds log_mutex */
+static inline uint32_t log_ring_oldest(void)
+{
+	return log_buf.next_seq - (uint32_t)log_buf.count;
+}
+
+/* Caller holds log_mutex.  @p seq must still be buffered. */
+static const struct log_entry *log_ring_at(uint32_t seq)
+{
+	int start = (log_buf.head - log_buf.count + LOG_BUF_ENTRIES) %
+		    LOG_BUF_ENTRIES;
+
+	return &log_buf.entries[(start + (int)(seq - log_ring_oldest())) %
+				LOG_BUF_ENTRIES];
+}
+
+/*
+ * Caller holds log_mutex.  Binary search for the first buffered entry
+ * at or after @p t_ms; next_seq if there is none.  Times compare by
+ * signed difference, so the search survives the 49-day wrap.
+ */
+static uint32_t log_ring_seq_at(uint32_t t_ms)
+{
+	uint32_t lo = log_ring_oldest();
+	uint32_t hi = log_buf.next_seq;
+
+	while (lo < hi) {
+		uint32_t mid = lo + (hi - lo) / 2;
+
+		if ((int32_t)(log_ring_at(mid)->timestamp_ms - t_ms) >= 0) {
+			hi = mid;
+		} else {
+			lo = mid + 1;
+		}
+	}
+	return lo;
+}
+
+static bool log_query_match(const struct log_query *q,
+			    const struct log_entry *e, char *text)
+{
+	if (e->level < q->min_level) {
+		return false;
+	}
+	if (q->module && strcmp(e->module, q->module) != 0) {
+		return false;
+	}
+	if (q->text) {
+		return strstr(log_entry_text(e, text), q->text) != NULL ||
+		       strstr(e->module, q->text) != NULL;
+	}
+	return true;
+}
+
+/**
+ * shrike_log_seq_at — Sequence number of the first buffered entry
+ * logged at or after @p t_ms (uptime), or of the next entry if none is.
+ */
+uint32_t shrike_log_seq_at(uint32_t t_ms)
+{
+	uint32_t seq;
+
+	k_mutex_lock(&log_mutex, K_FOREVER);
+	seq = log_ring_seq_at(t_ms);
+	k_mutex_unlock(&log_mutex);
+
+	return seq;
+}
+
 /**
- * shrike_log_dump — Print all buffered entries to the console.
+ * shrike_log_query_init — Match every entry from the oldest buffered
+ * now on.
  *
- * @param min_level  Only show entries at or above this level.
+ * Narrow the window and filters by setting the fields afterwards; set
+ * seq to resume from an earlier cursor.
  */
-void shrike_log_dump(enum log_level min_level)
+void shrike_log_query_init(struct log_query *q)
 {
+	memset(q, 0, sizeof(*q));
+	q->seq_end   = UINT32_MAX;
+	q->min_level = LOG_LVL_DEBUG;
+
 	k_mutex_lock(&log_mutex, K_FOREVER);
+	q->seq = log_ring_oldest();
+	k_mutex_unlock(&log_mutex);
+}
 
-	log_st.queries_performed++;
+/**
+ * shrike_log_query_next — Copy the next entry matching @p q and move
+ * the cursor past it.
+ *
+ * The window start is found by binary search, and the scan stops at the
+ * window end, so a query never walks the whole ring.  log_mutex is held
+ * for one entry at a time, never while the caller prints.
+ *
+ * @return  0, or -ENOENT if nothing in the window matches (yet).
+ */
+int shrike_log_query_next(struct log_query *q, struct log_record *out)
+{
+	int ret = -ENOENT;
 
-	int start = (log_buf.head - log_buf.count + LOG_BUF_ENTRIES) %
-		    LOG_BUF_ENTRIES;
+	k_mutex_lock(&log_mutex, K_FOREVER);
 
-	printk("\n=== Log Buffer (%d / %d entries, filter >= %s) ===\n",
-	       log_buf.count, LOG_BUF_ENTRIES,
-	       log_level_names[min_level]);
+	uint32_t oldest = log_ring_oldest();
+	uint32_t end    = MIN(q->seq_end, log_buf.next_seq);
 
-	int shown = 0;
-	for (int i = 0; i < log_buf.count; i++) {
-		int idx = (start + i) % LOG_BUF_ENTRIES;
-		const struct log_entry *e = &log_buf.entries[idx];
+	if (q->seq < oldest) {
+		q->lost += oldest - q->seq;
+		q->seq   = oldest;
+	}
+	if (q->flags & LOG_Q_T_FROM) {
+		q->seq = MAX(q->seq, log_ring_seq_at(q->t_from_ms));
+	}
+	if (q->flags & LOG_Q_T_TO) {
+		end = MIN(end, log_ring_seq_at(q->t_to_ms));
+	}
 
-		if (e->level < min_level) {
+	for (; q->seq < end; q->seq++) {
+		const struct log_entry *e = log_ring_at(q->seq);
+
+		if (!log_query_match(q, e, out->text)) {
 			continue;
 		}
 
-		uint32_t s  = e->timestamp_ms / 1000;
-		uint32_t ms = e->timestamp_ms % 1000;
+		const char *text = log_entry_text(e, out->text);
 
-		printk("[%5u.%03u] %s %-8s %s\n",
-		       s, ms,
-		       log_level_tags[e->level],
-		       e->module,
-		       e->message);
-		shown++;
+		if (text != out->text) {
+			strcpy(out->text, text);
+		}
+		out->seq          = q->seq++;
+		out->timestamp_ms = e->timestamp_ms;
+		out->level        = e->level;
+		out->event_id     = e->event ? e->event->id : 0;
+		strcpy(out->module, e->module);
+		ret = 0;
+		break;
 	}
 
-	printk("=== Shown %d entries ===\n\n", shown);
+	k_mutex_unlock(&log_mutex);
+	return ret;
+}
+
+/* Output goes to a command session: with CONFIG_LOG_PRINTK a printk
+ * here would be captured straight back into the ring.
+ */
+static void log_print_record(struct cmd_session *sess,
+			     const struct log_record *r)
+{
+	cmd_print(sess, "[%5u.%03u] %s %-8s %s\n",
+		  r->timestamp_ms / 1000, r->timestamp_ms % 1000,
+		  log_level_tags[r->level], r->module, r->text);
+}
 
+static void log_count_query(void)
+{
+	k_mutex_lock(&log_mutex, K_FOREVER);
+	log_st.queries_performed++;
 	k_mutex_unlock(&log_mutex);
 }
 
 /**
- * shrike_log_dump_last — Print the N most recent log entries.
+ * shrike_log_dump — Print all buffered entries to a session.
  *
- * @param count  Maximum number of entries to show.
+ * @param min_level  Only show entries at or above this level.
  */
-void shrike_log_dump_last(int count)
+void shrike_log_dump(struct cmd_session *sess, enum log_level min_level)
 {
-	k_mutex_lock(&log_mutex, K_FOREVER);
+	struct log_query q;
+	struct log_record r;
+	uint32_t oldest, next;
+	int shown = 0;
 
-	log_st.queries_performed++;
+	log_count_query();
+	shrike_log_seq_range(&oldest, &next);
+	shrike_log_query_init(&q);
+	q.seq       = oldest;
+	q.seq_end   = next;
+	q.min_level = min_level;
 
-	int to_show = (count < log_buf.count) ? count : log_buf.count;
-	int start_offset = log_buf.count - to_show;
-	int start = (log_buf.head - log_buf.count + LOG_BUF_ENTRIES) %
-		    LOG_BUF_ENTRIES;
+	cmd_print(sess, "\n=== Log Buffer (%u / %d entries, filter >= %s) ===\n",
+		  next - oldest, LOG_BUF_ENTRIES,
+		  log_level_names[min_level]);
 
-	printk("\n=== Last %d Log Entries ===\n", to_show);
+	while (shrike_log_query_next(&q, &r) == 0) {
+		log_print_record(sess, &r);
+		shown++;
+	}
 
-	for (int i = start_offset; i < log_buf.count; i++) {
-		int idx = (start + i) % LOG_BUF_ENTRIES;
-		const struct log_entry *e = &log_buf.entries[idx];
+	cmd_print(sess, "=== Shown %d entries ===\n\n", shown);
+}
 
-		uint32_t s  = e->timestamp_ms / 1000;
-		uint32_t ms = e->timestamp_ms % 1000;
+/**
+ * shrike_log_dump_last — Print the N most recent log entries.
+ *
+ * @param count  Maximum number of entries to show.
+ */
+void shrike_log_dump_last(struct cmd_session *sess, int count)
+{
+	struct log_query q;
+	struct log_record r;
+	uint32_t oldest, next;
 
-		printk("[%5u.%03u] %s %-8s %s\n",
-		       s, ms,
-		       log_level_tags[e->level],
-		       e->module,
-		       e->message);
-	}
+	log_count_query();
+	shrike_log_seq_range(&oldest, &next);
+	shrike_log_query_init(&q);
+	q.seq     = next - MIN((uint32_t)count, next - oldest);
+	q.seq_end = next;
 
-	printk("==========================\n\n");
+	cmd_print(sess, "\n=== Last %u Log Entries ===\n", next - q.seq);
 
-	k_mutex_unlock(&log_mutex);
+	while (shrike_log_query_next(&q, &r) == 0) {
+		log_print_record(sess, &r);
+	}
+
+	cmd_print(sess, "==========================\n\n");
 }
 
 /**
@@ -261,42 +695,85 @@ void shrike_log_dump_last(int count)
  * @param max_results  Maximum matches to print.
  * @return         Number of matches found.
  */
-int shrike_log_search(const char *keyword, int max_results)
+int shrike_log_search(struct cmd_session *sess, const char *keyword,
+		      int max_results)
 {
+	struct log_query q;
+	struct log_record r;
+	uint32_t oldest, next;
 	int found = 0;
 
+	log_count_query();
+	shrike_log_seq_range(&oldest, &next);
+	shrike_log_query_init(&q);
+	q.seq     = oldest;
+	q.seq_end = next;
+	q.text    = keyword;
+
+	cmd_print(sess, "\n=== Log Search: \"%s\" ===\n", keyword);
+
+	while (found < max_results && shrike_log_query_next(&q, &r) == 0) {
+		log_print_record(sess, &r);
+		found++;
+	}
+
+	cmd_print(sess, "=== Found %d matches ===\n\n", found);
+	return found;
+}
+
+/**
+ * shrike_log_seq_range — Sequence number of the oldest buffered entry
+ * and of the next entry to be written.
+ */
+void shrike_log_seq_range(uint32_t *oldest, uint32_t *next)
+{
 	k_mutex_lock(&log_mutex, K_FOREVER);
+	*next   = log_buf.next_seq;
+	*oldest = log_ring_oldest();
+	k_mutex_unlock(&log_mutex);
+}
 
-	log_st.queries_performed++;
+/**
+ * shrike_log_export_text — Render entries from sequence number *first
+ * up to (not including) @p end as dump lines, whole lines only.
+ *
+ * On return *first is the first entry actually rendered (later than
+ * requested if the ring has overwritten it) and *next the sequence
+ * number to continue from.
+ *
+ * @return  Bytes written to @p buf (not NUL-terminated).
+ */
+size_t shrike_log_export_text(uint32_t *first, uint32_t *next,
+			      uint32_t end, char *buf, size_t len)
+{
+	size_t pos = 0;
 
-	int start = (log_buf.head - log_buf.count + LOG_BUF_ENTRIES) %
-		    LOG_BUF_ENTRIES;
+	k_mutex_lock(&log_mutex, K_FOREVER);
 
-	printk("\n=== Log Search: \"%s\" ===\n", keyword);
+	uint32_t seq = MAX(*first, log_ring_oldest());
 
-	for (int i = 0; i < log_buf.count && found < max_results; i++) {
-		int idx = (start + i) % LOG_BUF_ENTRIES;
-		const struct log_entry *e = &log_buf.entries[idx];
+	*first = seq;
+	end = MIN(end, log_buf.next_seq);
 
-		if (strstr(e->message, keyword) != NULL ||
-		    strstr(e->module, keyword) != NULL) {
+	while (seq < end) {
+		const struct log_entry *e = log_ring_at(seq);
+		char text[LOG_MSG_MAX_LEN];
 
-			uint32_t s  = e->timestamp_ms / 1000;
-			uint32_t ms = e->timestamp_ms % 1000;
+		int n = snprintf(buf + pos, len - pos, "[%5u.%03u] %s %-8s %s\n",
+				 e->timestamp_ms / 1000, e->timestamp_ms % 1000,
+				 log_level_tags[e->level], e->module,
+				 log_entry_text(e, text));
 
-			printk("[%5u.%03u] %s %-8s %s\n",
-			       s, ms,
-			       log_level_tags[e->level],
-			       e->module,
-			       e->message);
-			found++;
+		if (n < 0 || pos + (size_t)n >= len) {
+			break;
 		}
+		pos += n;
+		seq++;
 	}
-
-	printk("=== Found %d matches ===\n\n", found);
+	*next = seq;
 
 	k_mutex_unlock(&log_mutex);
-	return found;
+	return pos;
 }
 
 /**
@@ -329,23 +806,28 @@ int shrike_log_count_by_level(enum log_level level)
 /**
  * shrike_log_dump_stats — Print logging statistics.
  */
-void shrike_log_dump_stats(void)
+void shrike_log_dump_stats(struct cmd_session *sess)
 {
 	k_mutex_lock(&log_mutex, K_FOREVER);
 
-	printk("\n=== Logging Statistics ===\n");
-	printk("Buffer   : %d / %d entries\n",
-	       log_buf.count, LOG_BUF_ENTRIES);
-	printk("Total    : %u messages\n", log_st.total_messages);
-	printk("Dropped  : %u (buffer full)\n", log_st.dropped_messages);
-	printk("Queries  : %u\n", log_st.queries_performed);
-	printk("Per level:\n");
+	cmd_print(sess, "\n=== Logging Statistics ===\n");
+	cmd_print(sess, "Buffer   : %d / %d entries\n",
+		  log_buf.count, LOG_BUF_ENTRIES);
+	cmd_print(sess, "Total    : %u messages\n", log_st.total_messages);
+	cmd_print(sess, "Dropped  : %u (buffer full)\n",
+		  log_st.dropped_messages);
+	cmd_print(sess, "Captured : %u from Zephyr log/printk, %u lost "
+		  "upstream\n", log_st.backend_messages,
+		  log_st.backend_dropped);
+	cmd_print(sess, "Events   : %u structured\n", log_st.events);
+	cmd_print(sess, "Queries  : %u\n", log_st.queries_performed);
+	cmd_print(sess, "Per level:\n");
 	for (int i = 0; i < LOG_LVL_COUNT; i++) {
-		printk("  %-6s : %u\n",
-		       log_level_names[i], log_st.per_level[i]);
+		cmd_print(sess, "  %-6s : %u\n",
+			  log_level_names[i], log_st.per_level[i]);
 	}
-	printk("Filter   : >= %s\n", log_level_names[log_min_level]);
-	printk("=========================\n\n");
+	cmd_print(sess, "Filter   : >= %s\n", log_level_names[log_min_level]);
+	cmd_print(sess, "=========================\n\n");
 
 	k_mutex_unlock(&log_mutex);
 }
@@ -353,14 +835,20 @@ void shrike_log_dump_stats(void)
 /**
  * shrike_log_format_json — Serialise recent entries as JSON.
  *
+ * Strings are escaped.  Entries that do not fit are dropped whole,
+ * newest first, so the output is always valid JSON.
+ *
  * @param buf      Output buffer.
  * @param buf_len  Size of output buffer.
  * @param count    Maximum number of recent entries to include.
- * @return         Bytes written (excluding NUL).
+ * @return         Bytes written (excluding NUL), or -ENOMEM if the
+ *                 buffer cannot hold even the envelope.
  */
 int shrike_log_format_json(char *buf, size_t buf_len, int count)
 {
-	int written = 0;
+	struct json_writer w;
+
+	json_init(&w, buf, buf_len);
 
 	k_mutex_lock(&log_mutex, K_FOREVER);
 
@@ -369,55 +857,328 @@ int shrike_log_format_json(char *buf, size_t buf_len, int count)
 	int start = (log_buf.head - log_buf.count + LOG_BUF_ENTRIES) %
 		    LOG_BUF_ENTRIES;
 
-	written += snprintf(buf + written, buf_len - written,
-			    "{\"log_count\":%d,\"total\":%u,"
-			    "\"dropped\":%u,\"entries\":[",
-			    log_buf.count,
-			    log_st.total_messages,
-			    log_st.dropped_messages);
-
+	json_obj_begin(&w);
+	json_key(&w, "log_count");
+	json_i32(&w, log_buf.count);
+	json_key(&w, "total");
+	json_u32(&w, log_st.total_messages);
+	json_key(&w, "dropped");
+	json_u32(&w, log_st.dropped_messages);
+	json_key(&w, "entries");
+	json_arr_begin(&w);
+
+	/* Keep room for the closing "]}" */
+	json_reserve(&w, 2);
 	for (int i = start_offset; i < log_buf.count; i++) {
 		int idx = (start + i) % LOG_BUF_ENTRIES;
-		const struct log_entry *e = &log_buf.entries[idx];
+		struct json_mark m = json_checkpoint(&w);
 
-		if (written >= (int)buf_len - 2) break;
+		const struct log_entry *e = &log_buf.entries[idx];
+		char text[LOG_MSG_MAX_LEN];
+
+		json_obj_begin(&w);
+		json_fields(&w, log_entry_head_fields,
+			    ARRAY_SIZE(log_entry_head_fields), e);
+		if (e->event) {
+			json_key(&w, "kv");
+			log_kv_json(&w, e->event, e->pkg, e->pkg_len);
+		} else {
+			json_key(&w, "msg");
+			json_str(&w, log_entry_text(e, text));
+		}
+		json_fields(&w, log_entry_tail_fields,
+			    ARRAY_SIZE(log_entry_tail_fields), e);
+		json_obj_end(&w);
 
-		if (i > start_offset) {
-			written += snprintf(buf + written,
-					    buf_len - written, ",");
+		if (w.overflow) {
+			json_rewind(&w, m);
+			break;
 		}
+	}
+	json_release(&w, 2);
+
+	k_mutex_unlock(&log_mutex);
+
+	json_arr_end(&w);
+	json_obj_end(&w);
+	return json_finish(&w);
+}
+
+/* --------------------------------------------------------------------
+ * Zephyr log back end
+ * ------------------------------------------------------------------ */
+
+static enum log_level log_level_from_zephyr(uint8_t zlevel)
+{
+	switch (zlevel) {
+	case LOG_LEVEL_ERR: return LOG_LVL_ERROR;
+	case LOG_LEVEL_WRN: return LOG_LVL_WARN;
+	case LOG_LEVEL_DBG: return LOG_LVL_DEBUG;
+	default:            return LOG_LVL_INFO;   /* INF and printk */
+	}
+}
+
+static void ring_backend_process(const struct log_backend *const backend,
+				 union log_msg_generic *msg)
+{
+	ARG_UNUSED(backend);
+
+	struct log_msg *m = &msg->log;
+	enum log_level level = log_level_from_zephyr(log_msg_get_level(m));
+	const void *source = log_msg_get_source(m);
+	const char *module = "printk";
+	size_t plen;
+	uint8_t *pkg = log_msg_get_package(m, &plen);
+
+	/* Only the deferred log thread may take the mutex */
+	if (k_is_in_isr() || level < log_min_level) {
+		return;
+	}
+
+	if (source) {
+		int16_t id = IS_ENABLED(CONFIG_LOG_RUNTIME_FILTERING) ?
+			log_dynamic_source_id((void *)source) :
+			log_const_source_id(source);
+
+		module = log_source_name_get(log_msg_get_domain(m), id);
+	}
 
-		written += snprintf(buf + written, buf_len - written,
-			"{\"t\":%u,\"l\":\"%s\",\"m\":\"%s\","
-			"\"msg\":\"%s\",\"seq\":%u}",
-			e->timestamp_ms,
-			log_level_names[e->level],
-			e->module,
-			e->message,
-			e->sequence);
+	uint32_t ts_ms = (uint32_t)(log_output_timestamp_to_us(
+					log_msg_get_timestamp(m)) / 1000);
+
+	k_mutex_lock(&log_mutex, K_FOREVER);
+
+	struct log_entry *e = log_ring_claim(level, module, ts_ms);
+
+	if (plen <= sizeof(e->pkg)) {
+		memcpy(e->pkg, pkg, plen);
+		e->pkg_len = (uint8_t)plen;
+	} else {
+		/* Too big to keep packaged: render the prefix that fits */
+		struct log_render r = { .buf = e->message,
+					.len = LOG_MSG_MAX_LEN };
+
+		cbpprintf((cbprintf_cb)log_render_out, &r, pkg);
+		e->message[r.pos] = '\0';
 	}
 
-	written += snprintf(buf + written, buf_len - written, "]}");
+	log_ring_commit(level);
+	log_st.backend_messages++;
 
 	k_mutex_unlock(&log_mutex);
-	return written;
 }
 
-/* ------------------------------------------------------------------ */
+static void ring_backend_dropped(const struct log_backend *const backend,
+				 uint32_t cnt)
+{
+	ARG_UNUSED(backend);
+	log_st.backend_dropped += cnt;
+}
+
+static void ring_backend_panic(const struct log_backend *const backend)
+{
+	ARG_UNUSED(backend);
+}
+
+static const struct log_backend_api ring_backend_api = {
+	.process = ring_backend_process,
+	.dropped = ring_backend_dropped,
+	.panic   = ring_backend_panic,
+};
+
+LOG_BACKEND_DEFINE(shrike_ring_backend, ring_backend_api, true);
+
+/* --------------------------------------------------------------------
+ * Commands
+ * ------------------------------------------------------------------ */
+
+static int log_parse_level(const char *s, enum log_level *out)
+{
+	static const char letters[] = "DIWE";
+	const char *p = strchr(letters, s[0]);
+
+	if (s[0] != '\0' && s[1] == '\0' && p) {
+		*out = (enum log_level)(p - letters);
+		return 0;
+	}
+	if (s[0] >= '0' && s[0] < '0' + LOG_LVL_COUNT && s[1] == '\0') {
+		*out = (enum log_level)(s[0] - '0');
+		return 0;
+	}
+	return -EINVAL;
+}
+
+/* Fill @p q from key=value arguments; see log_query_cmd() */
+static int log_parse_query(int argc, struct cmd_arg *argv,
+			   struct log_query *q, int *page, bool *json)
+{
+	for (int i = 0; i < argc; i++) {
+		const char *arg = argv[i].type == CMD_ARG_STRING ?
+				  argv[i].sval : "";
+		const char *val = strchr(arg, '=');
+
+		if (!val || *++val == '\0') {
+			return -EINVAL;
+		}
+
+		size_t klen = (size_t)(val - 1 - arg);
+		char *end;
+		uint32_t n = (uint32_t)strtoul(val, &end, 0);
+		bool num = *end == '\0';
+
+#define LOG_Q_KEY(k) (klen == sizeof(k) - 1 && strncmp(arg, k, klen) == 0)
+		if (LOG_Q_KEY("since") && num) {
+			q->flags    |= LOG_Q_T_FROM;
+			q->t_from_ms = k_uptime_get_32() - n;
+		} else if (LOG_Q_KEY("from") && num) {
+			q->flags    |= LOG_Q_T_FROM;
+			q->t_from_ms = n;
+		} else if (LOG_Q_KEY("to") && num) {
+			q->flags  |= LOG_Q_T_TO;
+			q->t_to_ms = n;
+		} else if (LOG_Q_KEY("seq") && num) {
+			q->seq = n;
+		} else if (LOG_Q_KEY("lvl")) {
+			if (log_parse_level(val, &q->min_level) < 0) {
+				return -EINVAL;
+			}
+		} else if (LOG_Q_KEY("mod")) {
+			q->module = val;
+		} else if (LOG_Q_KEY("n") && num && n > 0) {
+			*page = (int)MIN(n, (uint32_t)LOG_BUF_ENTRIES);
+		} else if (LOG_Q_KEY("json") && num) {
+			*json = n != 0;
+		} else {
+			return -EINVAL;
+		}
+#undef LOG_Q_KEY
+	}
+	return 0;
+}
+
+/*
+ * 'log q [key=value ...]': one page of matching entries, then the
+ * cursor to pass as seq= for the next page.
+ *
+ *   since=<ms>        the last <ms> of uptime
+ *   from=<ms> to=<ms> absolute uptime window, 'to' exclusive
+ *   seq=<n>           resume from a cursor
+ *   lvl=D|I|W|E       minimum level (or 0-3)
+ *   mod=<name>        module, exact match
+ *   n=<count>         page size (default LOG_QUERY_PAGE)
+ *   json=1            entries as JSON lines
+ */
+static int log_query_cmd(struct cmd_session *sess,
+			 int argc, struct cmd_arg *argv)
+{
+	struct log_query q;
+	struct log_record r;
+	int page = LOG_QUERY_PAGE;
+	int shown = 0;
+	bool json = false;
+
+	shrike_log_query_init(&q);
+	if (log_parse_query(argc, argv, &q, &page, &json) < 0) {
+		cmd_print(sess, "Usage: log q [since=ms] [from=ms] [to=ms] "
+			  "[seq=n] [lvl=D|I|W|E] [mod=name] [n=count] "
+			  "[json=1]\n");
+		return -1;
+	}
+
+	log_count_query();
+
+	while (shown < page && shrike_log_query_next(&q, &r) == 0) {
+		if (json) {
+			char buf[LOG_MSG_MAX_LEN + 96];
+			struct json_writer w;
+
+			json_init(&w, buf, sizeof(buf));
+			json_obj_begin(&w);
+			json_fields(&w, log_record_head_fields,
+				    ARRAY_SIZE(log_record_head_fields), &r);
+			if (r.event_id) {
+				json_key(&w, "kv");
+				json_value_raw(&w, r.text);
+			} else {
+				json_key(&w, "msg");
+				json_str(&w, r.text);
+			}
+			json_fields(&w, log_record_tail_fields,
+				    ARRAY_SIZE(log_record_tail_fields), &r);
+			json_obj_end(&w);
+			if (json_finish(&w) >= 0) {
+				cmd_print(sess, "%s\n", buf);
+			}
+		} else {
+			log_print_record(sess, &r);
+		}
+		shown++;
+	}
+
+	/* Look one match ahead without moving the cursor */
+	struct log_query peek = q;
+	bool more = shrike_log_query_next(&peek, &r) == 0;
+
+	if (json) {
+		cmd_print(sess, "{\"log_next\":%u,\"more\":%d,\"lost\":%u}\n",
+			  q.seq, more, q.lost);
+	} else {
+		cmd_print(sess, "--- %d shown, next seq=%u%s, %u lost\n",
+			  shown, q.seq, more ? " (more)" : "", q.lost);
+	}
+	return 0;
+}
+
+static int log_cmd_handler(struct cmd_session *sess,
+			   int argc, struct cmd_arg *argv)
+{
+	if (argc == 0) {
+		shrike_log_dump_last(sess, 20);
+		return 0;
+	}
+	if (argv[0].type == CMD_ARG_INT && argc == 1) {
+		shrike_log_dump_last(sess, MAX(argv[0].ival, 1));
+		return 0;
+	}
+	if (argv[0].type == CMD_ARG_STRING) {
+		if (strcmp(argv[0].sval, "stats") == 0) {
+			shrike_log_dump_stats(sess);
+			return 0;
+		}
+		if (strcmp(argv[0].sval, "clear") == 0) {
+			shrike_log_clear();
+			cmd_print(sess, "Log cleared\n");
+			return 0;
+		}
+		if (strcmp(argv[0].sval, "q") == 0) {
+			return log_query_cmd(sess, argc - 1, argv + 1);
+		}
+		if (strcmp(argv[0].sval, "find") == 0 && argc == 2 &&
+		    argv[1].type == CMD_ARG_STRING) {
+			shrike_log_search(sess, argv[1].sval, LOG_BUF_ENTRIES);
+			return 0;
+		}
+	}
+
+	cmd_print(sess, "Usage: log [count|stats|clear|find <text>|"
+		  "q [key=value ...]]\n");
+	return -1;
+}
 
 /**
- * shrike_log_init — Initialise the logging subsystem.
+ * shrike_log_init — Register log commands.  Call after cmd_init().
+ *
+ * The ring itself needs no setup and already holds whatever the log
+ * back end captured during boot.
  */
 void shrike_log_init(void)
 {
-	memset(&log_buf, 0, sizeof(log_buf));
-	memset(&log_st, 0, sizeof(log_st));
-	log_min_level = LOG_LVL_DEBUG;
+	cmd_register("log", "Show, search or clear the log ring",
+		     "log [count|stats|clear|find <text>|q [key=value ...]]",
+		     log_cmd_handler, 0, CMD_MAX_ARGS);
+
+	SYSINFO_KOBJ_LABEL(log_mutex);
 
 	SHRIKE_LOG_I("LOG", "Logging subsystem initialised "
 		     "(%d entry buffer)", LOG_BUF_ENTRIES);
-
-	printk("[LOG] Ring-buffer logger ready "
-	       "(%d slots, filter >= %s)\n",
-	       LOG_BUF_ENTRIES, log_level_names[log_min_level]);
 }
@@ -0,0 +1,154 @@
+/*
+ * ShrikeOS Monitor — Ring-Buffer Logging Subsystem
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SHRIKE_LOGGER_H
+#define SHRIKE_LOGGER_H
+
+#include <zephyr/kernel.h>
+
+struct cmd_session;
+
+#define LOG_MSG_MAX_LEN    80
+#define LOG_MODULE_MAX_LEN 16
+
+/* Log levels */
+enum log_level {
+	LOG_LVL_DEBUG = 0,
+	LOG_LVL_INFO,
+	LOG_LVL_WARN,
+	LOG_LVL_ERROR,
+	LOG_LVL_COUNT,
+};
+
+/*
+ * Structured events.  IDs are part of the export format: host tools key
+ * on them, so append new ones and never renumber.
+ */
+enum log_event_id {
+	LOG_EV_WDG_WARNING = 1,
+	LOG_EV_WDG_TIMEOUT,
+	LOG_EV_WDG_OVER_BUDGET,
+	LOG_EV_SUP_RESTART,
+	LOG_EV_SUP_RECOVERED,
+	LOG_EV_SUP_GAVE_UP,
+	LOG_EV_SUP_NOT_RESTARTED,
+	LOG_EV_LAT_SPIKE,
+};
+
+/* Field types, and the argument each takes in shrike_log_kv() */
+enum log_kv_type {
+	LOG_KV_U32,                  /* uint32_t                       */
+	LOG_KV_I32,                  /* int32_t                        */
+	LOG_KV_BOOL,                 /* bool                           */
+	LOG_KV_STR,                  /* const char *, LOG_KV_STR_MAX   */
+};
+
+#define LOG_KV_STR_MAX  24
+
+struct log_kv_field {
+	const char *key;
+	uint8_t     type;            /* enum log_kv_type */
+};
+
+/* Schema of one event; only the values are stored per entry */
+struct log_event {
+	uint16_t                   id;       /* enum log_event_id */
+	uint8_t                    nfields;
+	const char                *name;
+	const struct log_kv_field *fields;
+};
+
+#define LOG_KV(k, t) { .key = (k), .type = LOG_KV_##t }
+
+/*
+ * Define event @p ev with id @p ev_id and its fields, in the order
+ * their values are passed, e.g.
+ *
+ *   SHRIKE_LOG_EVENT_DEFINE(wdg_timeout, LOG_EV_WDG_TIMEOUT,
+ *                           LOG_KV("thread", STR),
+ *                           LOG_KV("elapsed_ms", U32));
+ *   SHRIKE_LOG_KV(LOG_LVL_WARN, "WDG", wdg_timeout, name, elapsed);
+ */
+#define SHRIKE_LOG_EVENT_DEFINE(ev, ev_id, ...)                         \
+	static const struct log_kv_field log_ev_##ev##_fields[] = {     \
+		__VA_ARGS__                                             \
+	};                                                              \
+	static const struct log_event log_ev_##ev = {                   \
+		.id      = (ev_id),                                     \
+		.nfields = ARRAY_SIZE(log_ev_##ev##_fields),            \
+		.name    = #ev,                                         \
+		.fields  = log_ev_##ev##_fields,                        \
+	}
+
+#define SHRIKE_LOG_KV(level, mod, ev, ...) \
+	shrike_log_kv(level, mod, &log_ev_##ev, __VA_ARGS__)
+
+/* Query window flags */
+#define LOG_Q_T_FROM  BIT(0)     /* t_from_ms is set */
+#define LOG_Q_T_TO    BIT(1)     /* t_to_ms is set   */
+
+/*
+ * A log query and its cursor.  Entries are matched in sequence order
+ * within [seq, seq_end) and, if set, [t_from_ms, t_to_ms); reading one
+ * advances seq past it, so the same query picks up later pages, and
+ * entries written since.
+ */
+struct log_query {
+	uint32_t       seq;          /* cursor: next sequence number      */
+	uint32_t       seq_end;
+	uint32_t       t_from_ms;
+	uint32_t       t_to_ms;
+	uint8_t        flags;
+	enum log_level min_level;
+	const char    *module;       /* exact match, NULL: any            */
+	const char    *text;         /* substring of message or module    */
+	uint32_t       lost;         /* overwritten before they were read */
+};
+
+/* One entry returned by a query, message rendered; a structured
+ * event is rendered as a JSON object
+ */
+struct log_record {
+	uint32_t       seq;
+	uint32_t       timestamp_ms;
+	enum log_level level;
+	uint16_t       event_id;     /* 0: plain text message             */
+	char           module[LOG_MODULE_MAX_LEN];
+	char           text[LOG_MSG_MAX_LEN];
+};
+
+void shrike_log(enum log_level level, const char *module,
+		const char *fmt, ...);
+void shrike_log_kv(enum log_level level, const char *module,
+		   const struct log_event *ev, ...);
+
+/* Convenience macros */
+#define SHRIKE_LOG_D(mod, ...) shrike_log(LOG_LVL_DEBUG, mod, __VA_ARGS__)
+#define SHRIKE_LOG_I(mod, ...) shrike_log(LOG_LVL_INFO,  mod, __VA_ARGS__)
+#define SHRIKE_LOG_W(mod, ...) shrike_log(LOG_LVL_WARN,  mod, __VA_ARGS__)
+#define SHRIKE_LOG_E(mod, ...) shrike_log(LOG_LVL_ERROR, mod, __VA_ARGS__)
+
+void           shrike_log_set_level(enum log_level min);
+enum log_level shrike_log_get_level(void);
+void           shrike_log_clear(void);
+void           shrike_log_dump(struct cmd_session *sess,
+			       enum log_level min_level);
+void           shrike_log_dump_last(struct cmd_session *sess, int count);
+int            shrike_log_search(struct cmd_session *sess,
+				 const char *keyword, int max_results);
+int            shrike_log_count_by_level(enum log_level level);
+void           shrike_log_seq_range(uint32_t *oldest, uint32_t *next);
+uint32_t       shrike_log_seq_at(uint32_t t_ms);
+void           shrike_log_query_init(struct log_query *q);
+int            shrike_log_query_next(struct log_query *q,
+				     struct log_record *out);
+size_t         shrike_log_export_text(uint32_t *first, uint32_t *next,
+				      uint32_t end, char *buf, size_t len);
+void           shrike_log_dump_stats(struct cmd_session *sess);
+int            shrike_log_format_json(char *buf, size_t buf_len, int count);
+void           shrike_log_init(void);
+
+#endif /* SHRIKE_LOGGER_H */
@@ -0,0 +1,164 @@
+/*
+ * ShrikeOS Monitor — LZ4 Block Compressor
+ *
+ * Greedy single-pass encoder for the standard LZ4 block format, sized
+ * for bulk export chunks: the only state is a caller-provided 2 KiB
+ * hash table of 16-bit positions, and each block is independent, so a
+ * transfer can resume at any chunk.  Output decodes with any LZ4 block
+ * decoder (the bridge has a pure-Python one).
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+#include <string.h>
+
+#include "lz4.h"
+
+/* Format limits: matches are at least 4 bytes, the last 5 bytes are
+ * always literals and no match may start in the last 12.
+ */
+#define LZ4_MIN_MATCH    4
+#define LZ4_LAST_LITERALS 5
+#define LZ4_MF_LIMIT     12
+#define LZ4_MAX_OFFSET   0xFFFF
+
+static inline uint32_t lz4_read32(const uint8_t *p)
+{
+	uint32_t v;
+
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static inline uint32_t lz4_hash(uint32_t v)
+{
+	return (v * 2654435761U) >> (32 - LZ4_HASH_BITS);
+}
+
+/* 4-bit length in the token, remainder as a run of 255s plus one byte */
+static uint8_t *lz4_put_len(uint8_t *op, size_t len)
+{
+	len -= 15;
+	while (len >= 255) {
+		*op++ = 255;
+		len -= 255;
+	}
+	*op++ = (uint8_t)len;
+	return op;
+}
+
+/* Worst-case output of one sequence, for the bounds check */
+static inline size_t lz4_seq_bound(size_t lit, size_t mlen)
+{
+	return 1 + lit / 255 + 1 + lit + 2 + mlen / 255 + 1;
+}
+
+/**
+ * lz4_compress_block — Compress @p src into one LZ4 block.
+ *
+ * @param table  Scratch hash table, LZ4_HASH_SIZE entries.
+ * @return       Compressed length, -EINVAL if @p src_len exceeds
+ *               LZ4_MAX_INPUT, or -ENOSPC if the output would not fit
+ *               in @p dst_cap (send the data uncompressed instead).
+ */
+int lz4_compress_block(const uint8_t *src, size_t src_len,
+		       uint8_t *dst, size_t dst_cap,
+		       uint16_t table[LZ4_HASH_SIZE])
+{
+	const uint8_t *ip     = src;
+	const uint8_t *anchor = src;
+	const uint8_t *end    = src + src_len;
+	uint8_t       *op     = dst;
+	uint8_t       *oend   = dst + dst_cap;
+
+	if (src_len > LZ4_MAX_INPUT) {
+		return -EINVAL;
+	}
+
+	if (src_len > LZ4_MF_LIMIT) {
+		const uint8_t *mflimit    = end - LZ4_MF_LIMIT;
+		const uint8_t *matchlimit = end - LZ4_LAST_LITERALS;
+
+		memset(table, 0, LZ4_HASH_SIZE * sizeof(table[0]));
+		ip++;
+
+		while (ip < mflimit) {
+			uint32_t seq = lz4_read32(ip);
+			uint32_t h   = lz4_hash(seq);
+			const uint8_t *ref = src + table[h];
+
+			table[h] = (uint16_t)(ip - src);
+
+			if (ref >= ip || ip - ref > LZ4_MAX_OFFSET ||
+			    lz4_read32(ref) != seq) {
+				ip++;
+				continue;
+			}
+
+			/* Grow the match backwards over pending literals */
+			while (ip > anchor && ref > src && ip[-1] == ref[-1]) {
+				ip--;
+				ref--;
+			}
+
+			const uint8_t *mp = ip + LZ4_MIN_MATCH;
+			const uint8_t *rp = ref + LZ4_MIN_MATCH;
+
+			while (mp < matchlimit && *mp == *rp) {
+				mp++;
+				rp++;
+			}
+
+			size_t lit  = (size_t)(ip - anchor);
+			size_t mlen = (size_t)(mp - ip) - LZ4_MIN_MATCH;
+			uint16_t off = (uint16_t)(ip - ref);
+
+			if ((size_t)(oend - op) < lz4_seq_bound(lit, mlen)) {
+				return -ENOSPC;
+			}
+
+			uint8_t *token = op++;
+
+			*token = (uint8_t)(MIN(lit, 15) << 4);
+			if (lit >= 15) {
+				op = lz4_put_len(op, lit);
+			}
+			memcpy(op, anchor, lit);
+			op += lit;
+
+			*op++ = (uint8_t)off;
+			*op++ = (uint8_t)(off >> 8);
+
+			*token |= (uint8_t)MIN(mlen, 15);
+			if (mlen >= 15) {
+				op = lz4_put_len(op, mlen);
+			}
+
+			ip = anchor = mp;
+
+			/* Index a position inside the match for the next one */
+			if (ip - 2 > src && ip < mflimit) {
+				table[lz4_hash(lz4_read32(ip - 2))] =
+					(uint16_t)(ip - 2 - src);
+			}
+		}
+	}
+
+	/* Trailing literals */
+	size_t lit = (size_t)(end - anchor);
+
+	if ((size_t)(oend - op) < 1 + lit / 255 + 1 + lit) {
+		return -ENOSPC;
+	}
+
+	*op++ = (uint8_t)(MIN(lit, 15) << 4);
+	if (lit >= 15) {
+		op = lz4_put_len(op, lit);
+	}
+	memcpy(op, anchor, lit);
+	op += lit;
+
+	return (int)(op - dst);
+}
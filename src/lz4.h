@@ -0,0 +1,23 @@
+/*
+ * ShrikeOS Monitor — LZ4 Block Compressor
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SHRIKE_LZ4_H
+#define SHRIKE_LZ4_H
+
+#include <zephyr/kernel.h>
+
+/* Match finder table: 2^LZ4_HASH_BITS positions of 16 bits each, so
+ * inputs are limited to 64 KiB.
+ */
+#define LZ4_HASH_BITS   10
+#define LZ4_HASH_SIZE   BIT(LZ4_HASH_BITS)
+#define LZ4_MAX_INPUT   0xFFFF
+
+int lz4_compress_block(const uint8_t *src, size_t src_len,
+		       uint8_t *dst, size_t dst_cap,
+		       uint16_t table[LZ4_HASH_SIZE]);
+
+#endif /* SHRIKE_LZ4_H */
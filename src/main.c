@@ -1,4 +1,5 @@
 #include <zephyr/kernel.h>
+#include <zephyr/init.h>
 #include <zephyr/device.h>
 #include <zephyr/drivers/gpio.h>
 #include <zephyr/drivers/adc.h>
@@ -10,6 +11,55 @@
 #include <string.h>
 #include <stdlib.h>
 
+#include "command.h"
+#include "config.h"
+#include "console.h"
+#include "export.h"
+#include "frame_pool.h"
+#include "history.h"
+#include "logger.h"
+#include "oled.h"
+#include "periodic.h"
+#include "ram.h"
+#include "scheduler.h"
+#include "serial_io.h"
+#include "smp.h"
+#include "snapshot.h"
+#include "supervisor.h"
+#include "sysinfo.h"
+#include "telemetry.h"
+#include "telemetry_schema.h"
+#include "watchdog.h"
+
+/* Line and frame buffers live in the frame pool, not on these stacks.
+ * Deepest paths from gcc -fcallgraph-info=su, frames of this code only
+ * (libc formatting, drivers and the exception frame come on top):
+ *   serial   1312 B  serial loop -> cmd_session_execute -> 'log q'
+ *   display   880 B  display loop -> wdg_end -> structured log event
+ * The serial thread runs every command handler and keeps 2048; the
+ * display thread has ~650 B of margin at 1536.  Confirm with 'stacks'.
+ */
+#define SERIAL_STACK_SIZE   2048
+#define DISPLAY_STACK_SIZE  1536
+
+/* Watchdog timeouts and per-iteration execution budgets ('wdg').
+ * Timeouts adapt to the observed loop interval within [MIN, TIMEOUT];
+ * the registered timeout is the upper bound and the warm-up value.
+ * An unresponsive loop is restarted by the supervisor ('sup'), at most
+ * SUP_RESTARTS times per SUP_WINDOW_MS.
+ */
+#define SENSOR_WDG_TIMEOUT_MS      3000
+#define SENSOR_WDG_MIN_MS          1500
+#define SENSOR_BUDGET_US           20000
+#define DISPLAY_WDG_TIMEOUT_MS     2000
+#define DISPLAY_WDG_MIN_MS         750
+#define DISPLAY_BUDGET_US          150000
+#define HEARTBEAT_WDG_TIMEOUT_MS   5000    /* blink can be up to 2 s */
+#define HEARTBEAT_WDG_MIN_MS       500
+#define HEARTBEAT_BUDGET_US        2000
+#define SUP_RESTARTS               3
+#define SUP_WINDOW_MS              60000
+
 
 static const struct gpio_dt_spec led = GPIO_DT_SPEC_GET(DT_ALIAS(led0), gpios);
 
@@ -27,7 +77,7 @@ static const struct device *cdc_dev;
 
 
 struct monitor_state {
-	float temperature;
+	int16_t temp_dc;                /* tenths of a degree C */
 	uint32_t uptime_secs;
 	uint8_t thread_count;
 	bool led_on;
@@ -36,7 +86,7 @@ struct monitor_state {
 };
 
 static struct monitor_state state = {
-	.temperature = 0.0f,
+	.temp_dc = 0,
 	.uptime_secs = 0,
 	.thread_count = 4,
 	.led_on = true,
@@ -46,6 +96,24 @@ static struct monitor_state state = {
 
 K_MUTEX_DEFINE(state_mutex);
 
+/* Restore persisted settings into the live state.  Runs at APPLICATION
+ * init level, after the flash driver is up and before the static
+ * threads below are started.
+ */
+static int state_restore(void)
+{
+	struct shrike_config cfg;
+
+	config_load(&cfg);
+
+	state.blink_ms = cfg.blink_ms;
+	state.led_on   = cfg.led_on;
+	memcpy(state.custom_msg, cfg.custom_msg, sizeof(state.custom_msg));
+	return 0;
+}
+
+SYS_INIT(state_restore, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
 
 static int16_t adc_buf;
 static struct adc_sequence adc_seq = {
@@ -87,30 +155,58 @@ static void init_adc(void)
 }
 
 
+static struct periodic_task sensor_task = PERIODIC_TASK_INIT("sensor", 1000);
+static struct periodic_task display_task = PERIODIC_TASK_INIT("display", 500);
+static struct periodic_task heartbeat_task = PERIODIC_TASK_INIT("heartbeat", 250);
+
 static void sensor_thread_fn(void *p1, void *p2, void *p3)
 {
-	ARG_UNUSED(p1); ARG_UNUSED(p2); ARG_UNUSED(p3);
+	ARG_UNUSED(p2); ARG_UNUSED(p3);
 
 	init_adc();
 
+	int wdg = POINTER_TO_INT(p1);
+	wdg_set_budget(wdg, SENSOR_BUDGET_US);
+	wdg_set_adaptive(wdg, SENSOR_WDG_MIN_MS, SENSOR_WDG_TIMEOUT_MS);
+	periodic_start(&sensor_task);
+
 	while (1) {
+		wdg_begin(wdg);
+
 		float temp = read_internal_temp();
+		/* Convert once; everything downstream is fixed-point */
+		int16_t temp_dc = (int16_t)(temp * 10.0f +
+					    (temp < 0.0f ? -0.5f : 0.5f));
 
 		k_mutex_lock(&state_mutex, K_FOREVER);
-		state.temperature = temp;
+		state.temp_dc = temp_dc;
 		state.uptime_secs = k_uptime_get_32() / 1000;
 		k_mutex_unlock(&state_mutex);
 
-		k_msleep(1000);
+		/* An excursion goes out now, not at the next tick */
+		telem_offer(false);
+
+		oled_push_temp(temp_dc);
+		history_push(temp_dc);
+
+		wdg_end(wdg);
+		periodic_next(&sensor_task);
 	}
 }
 
-K_THREAD_DEFINE(sensor_tid, 1024, sensor_thread_fn, NULL, NULL, NULL, 5, 0, 0);
+/* The entry redoes its own ADC setup, so a restart needs no separate
+ * reinit hook.
+ */
+SUP_CHILD_DEFINE(sensor_child, 1024,
+	.name = "sensor", .entry = sensor_thread_fn, .prio = 5,
+	.cpu = SMP_CPU_COLLECT, .wdg_timeout_ms = SENSOR_WDG_TIMEOUT_MS,
+	.policy = SUP_ONE_FOR_ONE, .max_restarts = SUP_RESTARTS,
+	.window_ms = SUP_WINDOW_MS);
 
 
 static void display_thread_fn(void *p1, void *p2, void *p3)
 {
-	ARG_UNUSED(p1); ARG_UNUSED(p2); ARG_UNUSED(p3);
+	ARG_UNUSED(p2); ARG_UNUSED(p3);
 
 	display_dev = DEVICE_DT_GET(DT_CHOSEN(zephyr_display));
 	if (!device_is_ready(display_dev)) {
@@ -118,8 +214,10 @@ static void display_thread_fn(void *p1, void *p2, void *p3)
 		return;
 	}
 
-	if (display_set_pixel_format(display_dev, PIXEL_FORMAT_MONO10) != 0) {
-		display_set_pixel_format(display_dev, PIXEL_FORMAT_MONO01);
+	enum display_pixel_format fmt = PIXEL_FORMAT_MONO10;
+	if (display_set_pixel_format(display_dev, fmt) != 0) {
+		fmt = PIXEL_FORMAT_MONO01;
+		display_set_pixel_format(display_dev, fmt);
 	}
 
 	if (cfb_framebuffer_init(display_dev)) {
@@ -144,42 +242,50 @@ static void display_thread_fn(void *p1, void *p2, void *p3)
 	cfb_framebuffer_set_font(display_dev, best_font);
 	cfb_set_kerning(display_dev, 1);
 
-	char line_buf[32];
+	oled_init(display_dev, fmt);
+
+	int wdg = POINTER_TO_INT(p1);
+	wdg_set_budget(wdg, DISPLAY_BUDGET_US);
+	wdg_set_adaptive(wdg, DISPLAY_WDG_MIN_MS, DISPLAY_WDG_TIMEOUT_MS);
+	periodic_start(&display_task);
 
 	while (1) {
+		wdg_begin(wdg);
+
 		k_mutex_lock(&state_mutex, K_FOREVER);
 		bool led_st = state.led_on;
-		uint16_t blink = state.blink_ms;
 		char msg[32];
 		strncpy(msg, state.custom_msg, sizeof(msg) - 1);
 		msg[sizeof(msg) - 1] = '\0';
 		k_mutex_unlock(&state_mutex);
 
-		cfb_framebuffer_clear(display_dev, false);
-
-		cfb_print(display_dev, "     SHRIKE", 0, 0);
+		oled_refresh(led_st, msg);
 
-		snprintf(line_buf, sizeof(line_buf), "LED: %s",
-			 led_st ? "ON" : "OFF");
-		cfb_print(display_dev, line_buf, 0, 16);
-
-		if (msg[0] != '\0') {
-			cfb_print(display_dev, msg, 0, 32);
-		} else {
-			cfb_print(display_dev, "> Ready", 0, 32);
-		}
+		wdg_end(wdg);
+		periodic_next(&display_task);
+	}
+}
 
-		cfb_framebuffer_finalize(display_dev);
-		k_msleep(500);
+/* cfb_framebuffer_init() allocates the framebuffer on the heap: free
+ * it before the entry runs again, or every restart leaks it.
+ */
+static void display_reinit(void)
+{
+	if (display_dev) {
+		cfb_framebuffer_deinit(display_dev);
 	}
 }
 
-K_THREAD_DEFINE(display_tid, 2048, display_thread_fn, NULL, NULL, NULL, 6, 0, 0);
+SUP_CHILD_DEFINE(display_child, DISPLAY_STACK_SIZE,
+	.name = "display", .entry = display_thread_fn, .prio = 6,
+	.cpu = SMP_CPU_COLLECT, .wdg_timeout_ms = DISPLAY_WDG_TIMEOUT_MS,
+	.policy = SUP_ONE_FOR_ONE, .max_restarts = SUP_RESTARTS,
+	.window_ms = SUP_WINDOW_MS, .reinit = display_reinit);
 
 
 static void heartbeat_thread_fn(void *p1, void *p2, void *p3)
 {
-	ARG_UNUSED(p1); ARG_UNUSED(p2); ARG_UNUSED(p3);
+	ARG_UNUSED(p2); ARG_UNUSED(p3);
 
 	if (!gpio_is_ready_dt(&led)) {
 		printk("LED GPIO not ready\n");
@@ -189,10 +295,19 @@ static void heartbeat_thread_fn(void *p1, void *p2, void *p3)
 	gpio_pin_configure_dt(&led, GPIO_OUTPUT_ACTIVE);
 	printk("LED GPIO configured on pin %d\n", led.pin);
 
+	int wdg = POINTER_TO_INT(p1);
+	wdg_set_budget(wdg, HEARTBEAT_BUDGET_US);
+	wdg_set_adaptive(wdg, HEARTBEAT_WDG_MIN_MS, HEARTBEAT_WDG_TIMEOUT_MS);
+	periodic_start(&heartbeat_task);
+
+	uint16_t last_blink = 0;
+
 	while (1) {
 		uint16_t blink;
 		bool on;
 
+		wdg_begin(wdg);
+
 		k_mutex_lock(&state_mutex, K_FOREVER);
 		blink = state.blink_ms;
 		on = state.led_on;
@@ -204,30 +319,173 @@ static void heartbeat_thread_fn(void *p1, void *p2, void *p3)
 			gpio_pin_set_dt(&led, 0);
 		}
 
-		k_msleep(blink);
+		wdg_end(wdg);
+
+		/* A new blink rate is a new interval distribution */
+		if (blink != last_blink) {
+			wdg_adaptive_reset(wdg);
+			last_blink = blink;
+		}
+		periodic_set_period(&heartbeat_task, blink);
+		periodic_next(&heartbeat_task);
 	}
 }
 
-K_THREAD_DEFINE(heartbeat_tid, 512, heartbeat_thread_fn, NULL, NULL, NULL, 7, 0, 0);
+SUP_CHILD_DEFINE(heartbeat_child, 512,
+	.name = "heartbeat", .entry = heartbeat_thread_fn, .prio = 7,
+	.cpu = -1, .wdg_timeout_ms = HEARTBEAT_WDG_TIMEOUT_MS,
+	.policy = SUP_ONE_FOR_ONE, .max_restarts = SUP_RESTARTS,
+	.window_ms = SUP_WINDOW_MS);
 
 
-static void send_telemetry(const struct device *dev)
+/* Frame layout, JSON descriptors and the binary packer are generated
+ * from schema/telemetry.json (see scripts/gen_telemetry.py).
+ */
+static void telemetry_snapshot(struct telemetry_frame *f)
 {
-	char buf[128];
-
 	k_mutex_lock(&state_mutex, K_FOREVER);
-	int len = snprintf(buf, sizeof(buf),
-		"{\"temp\":%.1f,\"up\":%u,\"thds\":%u,\"led\":%u,\"blink\":%u}\n",
-		(double)state.temperature,
-		state.uptime_secs,
-		state.thread_count,
-		state.led_on ? 1 : 0,
-		state.blink_ms);
+	f->temp  = state.temp_dc;
+	f->up    = state.uptime_secs;
+	f->thds  = state.thread_count;
+	f->led   = state.led_on;
+	f->blink = state.blink_ms;
 	k_mutex_unlock(&state_mutex);
+}
+
+/* Telemetry wire format; the bridge switches to binary with 'telem bin' */
+static atomic_t telem_binary;
 
-	for (int i = 0; i < len; i++) {
-		uart_poll_out(dev, buf[i]);
+BUILD_ASSERT(TELEMETRY_BIN_FRAME_LEN <= FRAME_BUF_LEN,
+	     "binary telemetry frame does not fit a pool frame");
+
+/* Encoded straight into a pool frame; fails if the pool is drained.
+ * Called by the send-on-delta filter (telemetry.c).
+ */
+static int send_telemetry(const struct telemetry_frame *f,
+			  k_timeout_t timeout)
+{
+	struct frame_buf *fb = frame_alloc(K_NO_WAIT);
+	int len;
+
+	if (!fb) {
+		return -ENOMEM;
 	}
+
+	if (atomic_get(&telem_binary)) {
+		telemetry_pack(f, (uint8_t *)fb->data);
+		len = TELEMETRY_BIN_FRAME_LEN;
+	} else {
+		len = telemetry_encode_json(f, fb->data, sizeof(fb->data));
+	}
+
+	if (len <= 0) {
+		frame_free(fb);
+		return -ENOMEM;
+	}
+	fb->len = (uint16_t)len;
+
+	int ret = serial_io_submit_timeout(fb, timeout);
+
+	if (ret == -EBUSY) {
+		frame_free(fb);
+	}
+	return ret;
+}
+
+/* The snprintf encoder the writer replaced, kept only as the 'bench'
+ * baseline.  It goes through the soft-float %.1f path like the old
+ * frame did.
+ */
+static int telemetry_encode_snprintf(const struct telemetry_frame *f,
+				     char *buf, size_t len)
+{
+	return snprintf(buf, len,
+		"{\"temp\":%.1f,\"up\":%u,\"thds\":%u,\"led\":%u,\"blink\":%u}\n",
+		(double)((float)f->temp / 10.0f),
+		f->up, f->thds, f->led ? 1 : 0, f->blink);
+}
+
+static int telem_handler(struct cmd_session *sess,
+			 int argc, struct cmd_arg *argv)
+{
+	if (argc == 1) {
+		if (argv[0].type != CMD_ARG_STRING) {
+			cmd_print(sess, "Usage: telem [json|bin]\n");
+			return -1;
+		}
+		if (strcmp(argv[0].sval, "bin") == 0) {
+			atomic_set(&telem_binary, 1);
+		} else if (strcmp(argv[0].sval, "json") == 0) {
+			atomic_set(&telem_binary, 0);
+		} else {
+			cmd_print(sess, "Usage: telem [json|bin]\n");
+			return -1;
+		}
+		/* First frame in the new format goes out at once */
+		telem_force();
+	}
+	cmd_print(sess, "Telemetry: %s, schema v%d, on change (checked "
+		  "every %d ms, 'deadband')\n",
+		  atomic_get(&telem_binary) ? "binary" : "json",
+		  TELEMETRY_SCHEMA_VERSION, TELEMETRY_PERIOD_MS);
+	return 0;
+}
+
+static int bench_handler(struct cmd_session *sess,
+			 int argc, struct cmd_arg *argv)
+{
+	struct telemetry_frame f;
+	struct frame_buf *fb;
+	int iters = 1000;
+
+	if (argc == 1) {
+		/* Bounded so a run cannot wrap the 32-bit cycle counter */
+		if (argv[0].type != CMD_ARG_INT || argv[0].ival <= 0 ||
+		    argv[0].ival > 100000) {
+			cmd_print(sess, "Iterations must be 1..100000\n");
+			return -1;
+		}
+		iters = argv[0].ival;
+	}
+
+	fb = frame_alloc(K_MSEC(100));
+	if (!fb) {
+		cmd_print(sess, "No free frame\n");
+		return -1;
+	}
+	char *buf = fb->data;
+
+	telemetry_snapshot(&f);
+
+	uint32_t t0 = k_cycle_get_32();
+	for (int i = 0; i < iters; i++) {
+		telemetry_encode_snprintf(&f, buf, FRAME_BUF_LEN);
+	}
+	uint32_t t1 = k_cycle_get_32();
+	for (int i = 0; i < iters; i++) {
+		telemetry_encode_json(&f, buf, FRAME_BUF_LEN);
+	}
+	uint32_t t2 = k_cycle_get_32();
+	for (int i = 0; i < iters; i++) {
+		telemetry_pack(&f, (uint8_t *)buf);
+	}
+	uint32_t t3 = k_cycle_get_32();
+
+	frame_free(fb);
+
+	uint32_t legacy = (t1 - t0) / (uint32_t)iters;
+	uint32_t writer = (t2 - t1) / (uint32_t)iters;
+	uint32_t binary = (t3 - t2) / (uint32_t)iters;
+
+	cmd_print(sess, "Telemetry frame, %d iterations:\n", iters);
+	cmd_print(sess, "  snprintf : %u cyc/frame\n", legacy);
+	cmd_print(sess, "  writer   : %u cyc/frame\n", writer);
+	cmd_print(sess, "  binary   : %u cyc/frame\n", binary);
+	if (writer) {
+		cmd_print(sess, "  speedup  : %u.%ux\n", legacy / writer,
+			  (legacy % writer) * 10 / writer);
+	}
+	return 0;
 }
 
 static void parse_command(const char *json)
@@ -243,13 +501,21 @@ static void parse_command(const char *json)
 		val = atoi(val_pos);
 	}
 
+	if (strncmp(cmd_pos, "page", 4) == 0) {
+		/* 0..3 pins a page, anything else resumes rotation */
+		oled_select_page(val_pos ? val : -1);
+		return;
+	}
+
 	k_mutex_lock(&state_mutex, K_FOREVER);
 
 	if (strncmp(cmd_pos, "led", 3) == 0) {
 		state.led_on = (val != 0);
+		config_set_led(state.led_on);
 	} else if (strncmp(cmd_pos, "blink", 5) == 0) {
 		if (val >= 50 && val <= 2000) {
 			state.blink_ms = (uint16_t)val;
+			config_set_blink(state.blink_ms);
 		}
 	} else if (strncmp(cmd_pos, "oled_msg", 8) == 0) {
 		const char *str_val = strstr(json, "\"val\":\"");
@@ -261,11 +527,80 @@ static void parse_command(const char *json)
 						  sizeof(state.custom_msg) - 1);
 				memcpy(state.custom_msg, str_val, slen);
 				state.custom_msg[slen] = '\0';
+				config_set_msg(state.custom_msg);
 			}
 		}
 	}
 
 	k_mutex_unlock(&state_mutex);
+
+	telem_offer(false);
+}
+
+/* One pass of the telemetry path, for the SMP scaling run */
+static void smpbench_iter(void *arg)
+{
+	ARG_UNUSED(arg);
+	struct telemetry_frame f;
+	char buf[96];
+
+	telemetry_snapshot(&f);
+	telemetry_encode_json(&f, buf, sizeof(buf));
+}
+
+static int smpbench_handler(struct cmd_session *sess,
+			    int argc, struct cmd_arg *argv)
+{
+	uint32_t ms = 1000;
+	uint32_t per_cpu[SMP_MAX_CPUS];
+	int ncpu = smp_num_cpus();
+
+	if (argc == 1) {
+		if (argv[0].type != CMD_ARG_INT || argv[0].ival < 100 ||
+		    argv[0].ival > 10000) {
+			cmd_print(sess, "Duration must be 100..10000 ms\n");
+			return -1;
+		}
+		ms = (uint32_t)argv[0].ival;
+	}
+
+	int one = smp_bench_run(smpbench_iter, NULL, 1, ms, NULL);
+	int all = smp_bench_run(smpbench_iter, NULL, ncpu, ms, per_cpu);
+
+	if (one < 0 || all < 0) {
+		cmd_print(sess, "Benchmark already running\n");
+		return -1;
+	}
+
+	cmd_print(sess, "Telemetry path, %u ms per run:\n", ms);
+	cmd_print(sess, "  1 CPU  : %d frames (%u/s)\n",
+		  one, (uint32_t)((uint64_t)one * 1000 / ms));
+	cmd_print(sess, "  %d CPU%s : %d frames (%u/s)\n", ncpu,
+		  ncpu > 1 ? "s" : " ", all,
+		  (uint32_t)((uint64_t)all * 1000 / ms));
+	for (int i = 0; i < ncpu; i++) {
+		cmd_print(sess, "    cpu%d : %u\n", i, per_cpu[i]);
+	}
+	if (one > 0) {
+		cmd_print(sess, "  scaling: %u%%\n",
+			  (uint32_t)((uint64_t)all * 100 / one));
+	}
+	return 0;
+}
+
+static struct cmd_session usb_session;
+
+/* Replies too long for one frame are copied into as many as needed */
+static void usb_sink(void *ctx, const char *str)
+{
+	ARG_UNUSED(ctx);
+	serial_io_write(str, strlen(str));
+}
+
+static void usb_frame_tx(void *ctx, struct frame_buf *f)
+{
+	ARG_UNUSED(ctx);
+	serial_io_submit(f);
 }
 
 static void serial_thread_fn(void *p1, void *p2, void *p3)
@@ -292,29 +627,47 @@ static void serial_thread_fn(void *p1, void *p2, void *p3)
 
 	k_msleep(500);
 
-	char rx_buf[128];
-	int rx_pos = 0;
+	if (serial_io_start(cdc_dev) != 0) {
+		return;
+	}
+
+	cmd_session_init(&usb_session, "usb", usb_sink, NULL);
+	cmd_session_set_frame_tx(&usb_session, usb_frame_tx);
+
+	int64_t next_telem = k_uptime_get();
 
 	while (1) {
-		unsigned char c;
-		while (uart_poll_in(cdc_dev, &c) == 0) {
-			if (c == '\n' || c == '\r') {
-				if (rx_pos > 0) {
-					rx_buf[rx_pos] = '\0';
-					parse_command(rx_buf);
-					rx_pos = 0;
-				}
-			} else if (rx_pos < (int)sizeof(rx_buf) - 1) {
-				rx_buf[rx_pos++] = (char)c;
+		/* Lines arrive as pool frames from the RX interrupt and are
+		 * handled in place; wake up at least once per telemetry tick.
+		 */
+		int64_t wait = next_telem - k_uptime_get();
+		struct frame_buf *rx = serial_io_rx_get(K_MSEC(MAX(wait, 0)));
+
+		if (rx) {
+			/* JSON from the dashboard, plain text lines go to the
+			 * command engine
+			 */
+			if (rx->data[0] == '{') {
+				parse_command(rx->data);
+			} else {
+				cmd_session_execute(&usb_session, rx->data);
 			}
+			frame_free(rx);
 		}
 
-		send_telemetry(cdc_dev);
-		k_msleep(500);
+		int64_t now = k_uptime_get();
+		if (now >= next_telem) {
+			telem_offer(true);
+			/* Skip missed periods instead of bursting */
+			do {
+				next_telem += TELEMETRY_PERIOD_MS;
+			} while (next_telem <= now);
+		}
 	}
 }
 
-K_THREAD_DEFINE(serial_tid, 2048, serial_thread_fn, NULL, NULL, NULL, 4, 0, 0);
+K_THREAD_DEFINE(serial_tid, SERIAL_STACK_SIZE, serial_thread_fn,
+		NULL, NULL, NULL, 4, 0, SMP_START_DELAY);
 
 int main(void)
 {
@@ -323,5 +676,37 @@ int main(void)
 	printk("LED: GPIO %d (blink thread)\n", led.pin);
 	printk("Threads: sensor, display, heartbeat, serial\n");
 
+	cmd_init();
+	shrike_log_init();
+	console_init();
+	frame_pool_init();
+	serial_io_init();
+	sysinfo_init();
+	wdg_init();
+	sched_init();
+	config_init();
+	smp_init();
+	periodic_init();
+	sup_init();
+	export_init();
+	ram_init();
+	snapshot_init();
+	telem_init(telemetry_snapshot, send_telemetry);
+
+	cmd_register("bench", "Time telemetry encoding (cycles/frame)",
+		     "bench [iterations]", bench_handler, 0, 1);
+	cmd_register("telem", "Select telemetry wire format",
+		     "telem [json|bin]", telem_handler, 0, 1);
+	cmd_register("smpbench", "Telemetry throughput on 1 vs all CPUs",
+		     "smpbench [ms]", smpbench_handler, 0, 1);
+	SYSINFO_KOBJ_LABEL(state_mutex);
+
+	/* Serial I/O on its own core, periodic collectors on the other */
+	smp_start(serial_tid, SMP_CPU_IO);
+	sup_start(&sensor_child);
+	sup_start(&display_child);
+	sup_start(&heartbeat_child);
+	smp_start(sysinfo_tid, SMP_CPU_COLLECT);
+
 	return 0;
 }
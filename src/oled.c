@@ -0,0 +1,388 @@
+/*
+ * ShrikeOS Monitor — OLED Page Manager
+ *
+ * Multi-page dashboard for the SSD1306: status, temperature sparkline,
+ * thread/watchdog health and heap usage.  Pages rotate on a timer or
+ * are pinned on command.  A page is only pushed over I2C when its text
+ * content differs from what is already on the panel, and the sparkline
+ * sweeps across the panel one column per sample, so a new sample costs
+ * two column writes rather than a redraw of the whole plot.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/display.h>
+#include <zephyr/display/cfb.h>
+#include <zephyr/sys/util.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "oled.h"
+#include "sysinfo.h"
+#include "watchdog.h"
+
+/* --------------------------------------------------------------------
+ * Configuration
+ * ------------------------------------------------------------------ */
+
+#define OLED_WIDTH           128
+#define OLED_LINE_H          16
+#define OLED_LINES           4
+#define OLED_LINE_LEN        16
+#define OLED_PAGE_ROTATE_MS  5000
+#define OLED_PENDING_MAX     4
+
+/* Sparkline occupies the three text rows below the page title, i.e.
+ * SSD1306 pages 2..7 (8 pixel rows per controller page).
+ */
+#define SPARK_FIRST_PAGE     2
+#define SPARK_PAGES          6
+#define SPARK_ROWS           (SPARK_PAGES * 8)
+#define SPARK_MIN_DECI_C     150    /* 15.0 °C at the bottom row */
+#define SPARK_MAX_DECI_C     650    /* 65.0 °C at the top row    */
+
+/* --------------------------------------------------------------------
+ * Data Structures
+ * ------------------------------------------------------------------ */
+
+/* Text content of one page, compared against what is on the panel */
+struct oled_frame {
+	char lines[OLED_LINES][OLED_LINE_LEN];
+};
+
+static struct {
+	const struct device *dev;
+	uint8_t        ink_mask;      /* XOR for raw bitmap polarity    */
+	enum oled_page page;
+	bool           auto_rotate;
+	uint32_t       page_since_ms;
+	int16_t        pending[OLED_PENDING_MAX];
+	uint8_t        pending_count;
+	int16_t        last_temp;
+	bool           have_temp;
+	int8_t         spark_prev_row; /* -1 until the first sample     */
+	uint8_t        spark_head;     /* column the next sample lands in */
+	uint8_t        spark_dirty;    /* columns drawn since last push  */
+} oled;
+
+/* Sparkline bitmap in controller layout: [page][column], bit n of a
+ * byte is pixel row (page * 8 + n).  Columns map 1:1 to panel columns;
+ * the trace wraps at spark_head like a chart recorder, with the blank
+ * column at spark_head marking the sweep position.
+ */
+static uint8_t spark_fb[SPARK_PAGES][OLED_WIDTH];
+
+static struct oled_frame oled_shown;
+static struct oled_frame oled_next;
+static int               oled_shown_page = -1;
+
+K_MUTEX_DEFINE(oled_mutex);
+
+/* --------------------------------------------------------------------
+ * Sparkline
+ * ------------------------------------------------------------------ */
+
+static int spark_row_for(int16_t deci_c)
+{
+	int v = CLAMP(deci_c, SPARK_MIN_DECI_C, SPARK_MAX_DECI_C);
+
+	return (SPARK_ROWS - 1) -
+	       ((v - SPARK_MIN_DECI_C) * (SPARK_ROWS - 1)) /
+	       (SPARK_MAX_DECI_C - SPARK_MIN_DECI_C);
+}
+
+static void spark_set_col(int x, const uint8_t col[SPARK_PAGES])
+{
+	for (int p = 0; p < SPARK_PAGES; p++) {
+		spark_fb[p][x] = col[p] ^ oled.ink_mask;
+	}
+}
+
+/**
+ * Draw the new sample at the sweep position, joined vertically to the
+ * previous sample, and blank the column after it as the sweep gap.
+ *
+ * The display API has no horizontal scroll, and scrolling in software
+ * means rewriting all 768 bytes of the plot per sample; sweeping keeps
+ * the panel update to the columns that actually changed.
+ */
+static void spark_shift_in(int16_t deci_c)
+{
+	static const uint8_t blank[SPARK_PAGES];
+	int row = spark_row_for(deci_c);
+	int lo = row, hi = row;
+	uint8_t col[SPARK_PAGES] = { 0 };
+
+	if (oled.spark_prev_row >= 0) {
+		lo = MIN(row, oled.spark_prev_row);
+		hi = MAX(row, oled.spark_prev_row);
+	}
+
+	for (int r = lo; r <= hi; r++) {
+		col[r / 8] |= BIT(r % 8);
+	}
+
+	spark_set_col(oled.spark_head, col);
+	oled.spark_head = (oled.spark_head + 1) % OLED_WIDTH;
+	spark_set_col(oled.spark_head, blank);
+
+	oled.spark_prev_row = (int8_t)row;
+	oled.spark_dirty    = MIN(oled.spark_dirty + 1, OLED_WIDTH);
+}
+
+/** spark_push — Write the whole plot, after a CFB push blanked it. */
+static void spark_push(void)
+{
+	struct display_buffer_descriptor desc = {
+		.buf_size = sizeof(spark_fb),
+		.width    = OLED_WIDTH,
+		.height   = SPARK_ROWS,
+		.pitch    = OLED_WIDTH,
+	};
+
+	display_write(oled.dev, 0, SPARK_FIRST_PAGE * 8, &desc, spark_fb);
+	oled.spark_dirty = 0;
+}
+
+/**
+ * spark_push_cols — Write only the columns drawn since the last push,
+ * plus the sweep gap after them (SPARK_PAGES bytes per column).
+ */
+static void spark_push_cols(void)
+{
+	struct display_buffer_descriptor desc = {
+		.buf_size = SPARK_PAGES,
+		.width    = 1,
+		.height   = SPARK_ROWS,
+		.pitch    = 1,
+	};
+	uint8_t col[SPARK_PAGES];
+	int n = oled.spark_dirty + 1;
+
+	if (n >= OLED_WIDTH) {
+		spark_push();
+		return;
+	}
+
+	for (int i = n - 1; i >= 0; i--) {
+		int x = (oled.spark_head - i + OLED_WIDTH) % OLED_WIDTH;
+
+		for (int p = 0; p < SPARK_PAGES; p++) {
+			col[p] = spark_fb[p][x];
+		}
+		display_write(oled.dev, x, SPARK_FIRST_PAGE * 8, &desc, col);
+	}
+	oled.spark_dirty = 0;
+}
+
+/* --------------------------------------------------------------------
+ * Page composition
+ * ------------------------------------------------------------------ */
+
+static void compose_status(struct oled_frame *f, bool led_on,
+			   const char *msg)
+{
+	snprintf(f->lines[0], OLED_LINE_LEN, "     SHRIKE");
+	snprintf(f->lines[1], OLED_LINE_LEN, "LED: %s", led_on ? "ON" : "OFF");
+	snprintf(f->lines[2], OLED_LINE_LEN, "%s",
+		 (msg && msg[0] != '\0') ? msg : "> Ready");
+}
+
+static void compose_temp(struct oled_frame *f)
+{
+	if (!oled.have_temp || oled.last_temp <= -990) {
+		snprintf(f->lines[0], OLED_LINE_LEN, "TEMP  --");
+		return;
+	}
+
+	/* Whole degrees only: the sparkline carries the fine detail and
+	 * the title then rarely forces a full-frame push.
+	 */
+	int t = oled.last_temp;
+	int whole = (t >= 0) ? (t + 5) / 10 : (t - 5) / 10;
+
+	snprintf(f->lines[0], OLED_LINE_LEN, "TEMP  %d C", whole);
+}
+
+static void compose_health(struct oled_frame *f)
+{
+	snprintf(f->lines[0], OLED_LINE_LEN, "HEALTH");
+	snprintf(f->lines[1], OLED_LINE_LEN, "THR %u CPU %u%%",
+		 sysinfo_get_thread_count(), sysinfo_get_cpu_load());
+	snprintf(f->lines[2], OLED_LINE_LEN, "WDG %d/%d OK",
+		 wdg_get_healthy_count(), wdg_get_active_count());
+}
+
+static void compose_heap(struct oled_frame *f)
+{
+	uint32_t used, total, peak;
+
+	sysinfo_get_heap(&used, &total, &peak);
+
+	snprintf(f->lines[0], OLED_LINE_LEN, "HEAP %u", total);
+	snprintf(f->lines[1], OLED_LINE_LEN, "USED %u", used);
+	snprintf(f->lines[2], OLED_LINE_LEN, "FREE %u", total - used);
+	snprintf(f->lines[3], OLED_LINE_LEN, "PEAK %u", peak);
+}
+
+static void frame_push(const struct oled_frame *f)
+{
+	cfb_framebuffer_clear(oled.dev, false);
+	for (int i = 0; i < OLED_LINES; i++) {
+		if (f->lines[i][0] != '\0') {
+			cfb_print(oled.dev, f->lines[i], 0, i * OLED_LINE_H);
+		}
+	}
+	cfb_framebuffer_finalize(oled.dev);
+}
+
+/* --------------------------------------------------------------------
+ * Public API
+ * ------------------------------------------------------------------ */
+
+/**
+ * oled_init — Bind the page manager to an initialised CFB display.
+ *
+ * @param dev  Display device, already set up with cfb_framebuffer_init().
+ * @param fmt  Pixel format the display was configured with; raw
+ *             sparkline writes follow the same polarity as the CFB.
+ */
+void oled_init(const struct device *dev, enum display_pixel_format fmt)
+{
+	k_mutex_lock(&oled_mutex, K_FOREVER);
+
+	oled.dev            = dev;
+	oled.ink_mask       = (fmt == PIXEL_FORMAT_MONO01) ? 0xFF : 0x00;
+	oled.page           = OLED_PAGE_STATUS;
+	oled.auto_rotate    = true;
+	oled.page_since_ms  = k_uptime_get_32();
+	oled.spark_prev_row = -1;
+	oled.spark_head     = 0;
+	oled.spark_dirty    = 0;
+	memset(spark_fb, oled.ink_mask, sizeof(spark_fb));
+	oled_shown_page     = -1;
+
+	k_mutex_unlock(&oled_mutex);
+
+	printk("[OLED] Page manager ready (%d pages, rotate %d ms)\n",
+	       OLED_PAGE_COUNT, OLED_PAGE_ROTATE_MS);
+}
+
+/**
+ * oled_push_temp — Queue a temperature sample for the sparkline.
+ *
+ * Called from the sensor thread; the column is drawn by the display
+ * thread on its next refresh.
+ *
+ * @param deci_c  Temperature in tenths of a degree Celsius.
+ */
+void oled_push_temp(int16_t deci_c)
+{
+	k_mutex_lock(&oled_mutex, K_FOREVER);
+
+	if (oled.pending_count < OLED_PENDING_MAX) {
+		oled.pending[oled.pending_count++] = deci_c;
+	} else {
+		/* Display thread fell behind: keep the newest sample */
+		oled.pending[OLED_PENDING_MAX - 1] = deci_c;
+	}
+
+	k_mutex_unlock(&oled_mutex);
+}
+
+/**
+ * oled_select_page — Pin a page, or resume automatic rotation.
+ *
+ * @param page  Page index (0 .. OLED_PAGE_COUNT-1), or any other
+ *              value to resume rotating through all pages.
+ */
+void oled_select_page(int page)
+{
+	k_mutex_lock(&oled_mutex, K_FOREVER);
+
+	if (page >= 0 && page < OLED_PAGE_COUNT) {
+		oled.page        = (enum oled_page)page;
+		oled.auto_rotate = false;
+	} else {
+		oled.auto_rotate = true;
+	}
+	oled.page_since_ms = k_uptime_get_32();
+
+	k_mutex_unlock(&oled_mutex);
+}
+
+/**
+ * oled_refresh — Draw pending samples and update the active page.
+ *
+ * Must be called from the display thread only; it owns the sparkline
+ * bitmap and the panel.
+ *
+ * @param led_on  Current LED state for the status page.
+ * @param msg     Custom message for the status page (may be empty).
+ */
+void oled_refresh(bool led_on, const char *msg)
+{
+	int16_t samples[OLED_PENDING_MAX];
+	int n;
+	enum oled_page page;
+	uint32_t now = k_uptime_get_32();
+
+	if (!oled.dev) {
+		return;
+	}
+
+	k_mutex_lock(&oled_mutex, K_FOREVER);
+
+	n = oled.pending_count;
+	memcpy(samples, oled.pending, n * sizeof(samples[0]));
+	oled.pending_count = 0;
+
+	if (oled.auto_rotate &&
+	    now - oled.page_since_ms >= OLED_PAGE_ROTATE_MS) {
+		oled.page = (oled.page + 1) % OLED_PAGE_COUNT;
+		oled.page_since_ms = now;
+	}
+	page = oled.page;
+
+	k_mutex_unlock(&oled_mutex);
+
+	for (int i = 0; i < n; i++) {
+		spark_shift_in(samples[i]);
+		oled.last_temp = samples[i];
+		oled.have_temp = true;
+	}
+
+	memset(&oled_next, 0, sizeof(oled_next));
+	switch (page) {
+	case OLED_PAGE_STATUS:
+		compose_status(&oled_next, led_on, msg);
+		break;
+	case OLED_PAGE_TEMP:
+		compose_temp(&oled_next);
+		break;
+	case OLED_PAGE_HEALTH:
+		compose_health(&oled_next);
+		break;
+	case OLED_PAGE_HEAP:
+		compose_heap(&oled_next);
+		break;
+	default:
+		break;
+	}
+
+	if ((int)page != oled_shown_page ||
+	    memcmp(&oled_next, &oled_shown, sizeof(oled_next)) != 0) {
+		frame_push(&oled_next);
+		memcpy(&oled_shown, &oled_next, sizeof(oled_shown));
+		oled_shown_page = page;
+
+		/* The CFB push blanked the sparkline rows */
+		if (page == OLED_PAGE_TEMP) {
+			spark_push();
+		}
+	} else if (page == OLED_PAGE_TEMP && oled.spark_dirty) {
+		spark_push_cols();
+	}
+}
@@ -0,0 +1,26 @@
+/*
+ * ShrikeOS Monitor — OLED Page Manager
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SHRIKE_OLED_H
+#define SHRIKE_OLED_H
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/display.h>
+
+enum oled_page {
+	OLED_PAGE_STATUS = 0,
+	OLED_PAGE_TEMP,
+	OLED_PAGE_HEALTH,
+	OLED_PAGE_HEAP,
+	OLED_PAGE_COUNT,
+};
+
+void oled_init(const struct device *dev, enum display_pixel_format fmt);
+void oled_push_temp(int16_t deci_c);
+void oled_select_page(int page);
+void oled_refresh(bool led_on, const char *msg);
+
+#endif /* SHRIKE_OLED_H */
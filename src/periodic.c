@@ -0,0 +1,304 @@
+/*
+ * ShrikeOS Monitor — Periodic Task Timing
+ *
+ * Release/deadline bookkeeping for the monitor's periodic threads.
+ * Each loop calls periodic_start() once and periodic_next() at the end
+ * of every job; releases are absolute, so periods do not drift, and the
+ * response time of every job (finish minus release) is recorded along
+ * with deadline misses.
+ *
+ * Built with CONFIG_SCHED_DEADLINE (edf.conf) the tasks share a single
+ * priority and each job's absolute deadline is handed to the kernel
+ * with k_thread_deadline_set(), giving earliest-deadline-first order.
+ * Without it the threads keep their static priorities and the same
+ * statistics are collected, so 'rt' output from both builds can be
+ * compared directly.  'rtload' adds a synthetic periodic CPU load.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/util.h>
+#include <string.h>
+
+#include "command.h"
+#include "periodic.h"
+
+/* --------------------------------------------------------------------
+ * Configuration
+ * ------------------------------------------------------------------ */
+
+#define PERIODIC_MAX_TASKS       8
+#define PERIODIC_LOAD_STACK_SIZE 768
+#define PERIODIC_LOAD_PRIORITY   5      /* static build: ties with sensor */
+
+/* --------------------------------------------------------------------
+ * State
+ * ------------------------------------------------------------------ */
+
+static struct periodic_task *tasks[PERIODIC_MAX_TASKS];
+static int                   task_count;
+static struct k_spinlock     periodic_lock;
+
+K_THREAD_STACK_DEFINE(load_stack, PERIODIC_LOAD_STACK_SIZE);
+static struct k_thread       load_thread;
+static struct periodic_task  load_task = PERIODIC_TASK_INIT("load", 10);
+static uint32_t              load_busy_us;
+static atomic_t              load_running;
+static atomic_t              load_stop;
+
+/* --------------------------------------------------------------------
+ * Release / deadline handling
+ * ------------------------------------------------------------------ */
+
+static inline int64_t task_deadline_ticks(const struct periodic_task *t)
+{
+	return k_ms_to_ticks_ceil64(t->deadline_ms ? t->deadline_ms
+						   : t->period_ms);
+}
+
+#ifdef CONFIG_SCHED_DEADLINE
+/* The kernel takes the deadline relative to now, in cycles */
+static void periodic_set_deadline(struct periodic_task *t, int64_t release)
+{
+	int64_t left = release + task_deadline_ticks(t) - k_uptime_ticks();
+
+	k_thread_deadline_set(k_current_get(),
+			      (int)k_ticks_to_cyc_ceil32(MAX(left, 1)));
+}
+#endif
+
+/**
+ * periodic_start — Register @p t and make "now" its first release.
+ *
+ * Call once from the task's own thread before its loop.  In EDF builds
+ * this also moves the thread into the shared deadline-ordered priority.
+ */
+void periodic_start(struct periodic_task *t)
+{
+	k_spinlock_key_t key = k_spin_lock(&periodic_lock);
+	bool known = false;
+
+	for (int i = 0; i < task_count; i++) {
+		if (tasks[i] == t) {
+			known = true;
+			break;
+		}
+	}
+	if (!known && task_count < PERIODIC_MAX_TASKS) {
+		tasks[task_count++] = t;
+	}
+	k_spin_unlock(&periodic_lock, key);
+
+	t->release = k_uptime_ticks();
+
+#ifdef CONFIG_SCHED_DEADLINE
+	k_thread_priority_set(k_current_get(), PERIODIC_EDF_PRIORITY);
+	periodic_set_deadline(t, t->release);
+#endif
+}
+
+/**
+ * periodic_next — Finish the current job and sleep until the next
+ * release.
+ *
+ * If the job overran whole periods, the missed releases are skipped
+ * (and counted) rather than run back to back.
+ */
+void periodic_next(struct periodic_task *t)
+{
+	int64_t now    = k_uptime_ticks();
+	int64_t period = k_ms_to_ticks_ceil64(MAX(t->period_ms, 1U));
+	int64_t resp   = now - t->release;
+	int64_t next   = t->release + period;
+	uint32_t resp_us  = (uint32_t)MIN(k_ticks_to_us_floor64(resp),
+					  (uint64_t)UINT32_MAX);
+	uint32_t skipped  = 0;
+
+	while (next < now) {
+		next += period;
+		skipped++;
+	}
+
+	k_spinlock_key_t key = k_spin_lock(&periodic_lock);
+	t->stats.jobs++;
+	t->stats.skipped     += skipped;
+	t->stats.resp_last_us = resp_us;
+	t->stats.resp_max_us  = MAX(t->stats.resp_max_us, resp_us);
+	t->stats.resp_sum_us += resp_us;
+	if (resp > task_deadline_ticks(t)) {
+		t->stats.misses++;
+	}
+	k_spin_unlock(&periodic_lock, key);
+
+	t->release = next;
+
+#ifdef CONFIG_SCHED_DEADLINE
+	/* Set before sleeping so the wake-up is queued by the new deadline */
+	periodic_set_deadline(t, next);
+#endif
+
+	k_sleep(K_TIMEOUT_ABS_TICKS(next));
+}
+
+/**
+ * periodic_set_period — Change the period (and implicit deadline)
+ * from the next release on.  Only call from the task's own thread.
+ */
+void periodic_set_period(struct periodic_task *t, uint32_t period_ms)
+{
+	t->period_ms = period_ms;
+}
+
+/* --------------------------------------------------------------------
+ * Synthetic load
+ * ------------------------------------------------------------------ */
+
+static void load_thread_fn(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1); ARG_UNUSED(p2); ARG_UNUSED(p3);
+
+	periodic_start(&load_task);
+
+	while (!atomic_get(&load_stop)) {
+		k_busy_wait(load_busy_us);
+		periodic_next(&load_task);
+	}
+}
+
+static void load_halt(void)
+{
+	atomic_set(&load_stop, 1);
+	k_thread_join(&load_thread, K_FOREVER);
+	atomic_clear(&load_running);
+}
+
+/* --------------------------------------------------------------------
+ * Commands
+ * ------------------------------------------------------------------ */
+
+static int rt_cmd_handler(struct cmd_session *sess,
+			  int argc, struct cmd_arg *argv)
+{
+	struct periodic_stats snap[PERIODIC_MAX_TASKS];
+	struct periodic_task *list[PERIODIC_MAX_TASKS];
+	int n;
+
+	if (argc == 1 && argv[0].type == CMD_ARG_STRING &&
+	    strcmp(argv[0].sval, "reset") == 0) {
+		k_spinlock_key_t key = k_spin_lock(&periodic_lock);
+		for (int i = 0; i < task_count; i++) {
+			memset(&tasks[i]->stats, 0, sizeof(tasks[i]->stats));
+		}
+		k_spin_unlock(&periodic_lock, key);
+		cmd_print(sess, "Periodic task statistics cleared\n");
+		return 0;
+	}
+	if (argc != 0) {
+		cmd_print(sess, "Usage: rt [reset]\n");
+		return -1;
+	}
+
+	k_spinlock_key_t key = k_spin_lock(&periodic_lock);
+	n = task_count;
+	for (int i = 0; i < n; i++) {
+		list[i] = tasks[i];
+		snap[i] = tasks[i]->stats;
+	}
+	k_spin_unlock(&periodic_lock, key);
+
+#ifdef CONFIG_SCHED_DEADLINE
+	cmd_print(sess, "\n=== Periodic Tasks (EDF, prio %d) ===\n",
+		  PERIODIC_EDF_PRIORITY);
+#else
+	cmd_print(sess, "\n=== Periodic Tasks (static prio) ===\n");
+#endif
+	cmd_print(sess, "%-10s %6s %7s %5s %5s %9s %9s\n",
+		  "Task", "Per ms", "Jobs", "Miss", "Skip",
+		  "Worst us", "Avg us");
+
+	for (int i = 0; i < n; i++) {
+		uint32_t avg = snap[i].jobs ?
+			(uint32_t)(snap[i].resp_sum_us / snap[i].jobs) : 0;
+
+		cmd_print(sess, "%-10s %6u %7u %5u %5u %9u %9u\n",
+			  list[i]->name, list[i]->period_ms,
+			  snap[i].jobs, snap[i].misses, snap[i].skipped,
+			  snap[i].resp_max_us, avg);
+	}
+
+	if (atomic_get(&load_running)) {
+		cmd_print(sess, "Load: %u us every %u ms\n",
+			  load_busy_us, load_task.period_ms);
+	}
+	cmd_print(sess, "=====================================\n\n");
+	return 0;
+}
+
+static int rtload_cmd_handler(struct cmd_session *sess,
+			      int argc, struct cmd_arg *argv)
+{
+	if (argc == 1 && argv[0].type == CMD_ARG_STRING &&
+	    strcmp(argv[0].sval, "off") == 0) {
+		if (atomic_get(&load_running)) {
+			load_halt();
+		}
+		cmd_print(sess, "Synthetic load stopped\n");
+		return 0;
+	}
+
+	if (argc < 2 || argv[0].type != CMD_ARG_INT ||
+	    argv[1].type != CMD_ARG_INT || argv[0].ival < 0 ||
+	    argv[1].ival < 1 || argv[0].ival >= argv[1].ival * 1000) {
+		cmd_print(sess, "Usage: rtload <busy_us> <period_ms> [prio] "
+			  "| rtload off (busy < period)\n");
+		return -1;
+	}
+
+	int prio = PERIODIC_LOAD_PRIORITY;
+
+	if (argc == 3) {
+		if (argv[2].type != CMD_ARG_INT || argv[2].ival < 0 ||
+		    argv[2].ival >= CONFIG_NUM_PREEMPT_PRIORITIES) {
+			cmd_print(sess, "Priority must be 0..%d\n",
+				  CONFIG_NUM_PREEMPT_PRIORITIES - 1);
+			return -1;
+		}
+		prio = argv[2].ival;
+	}
+
+	if (atomic_get(&load_running)) {
+		load_halt();
+	}
+
+	load_busy_us        = (uint32_t)argv[0].ival;
+	load_task.period_ms = (uint32_t)argv[1].ival;
+	atomic_clear(&load_stop);
+	atomic_set(&load_running, 1);
+
+	k_thread_create(&load_thread, load_stack,
+			K_THREAD_STACK_SIZEOF(load_stack),
+			load_thread_fn, NULL, NULL, NULL,
+			prio, 0, K_NO_WAIT);
+	k_thread_name_set(&load_thread, "rt_load");
+
+	cmd_print(sess, "Load: %u us every %u ms (%u%% CPU)%s\n",
+		  load_busy_us, load_task.period_ms,
+		  load_busy_us / (load_task.period_ms * 10),
+		  IS_ENABLED(CONFIG_SCHED_DEADLINE) ? ", EDF" : "");
+	return 0;
+}
+
+/**
+ * periodic_init — Register periodic task commands.  Call after
+ * cmd_init().
+ */
+void periodic_init(void)
+{
+	cmd_register("rt", "Periodic task response times and misses",
+		     "rt [reset]", rt_cmd_handler, 0, 1);
+	cmd_register("rtload", "Start/stop a synthetic periodic CPU load",
+		     "rtload <busy_us> <period_ms> [prio] | rtload off",
+		     rtload_cmd_handler, 1, 3);
+}
@@ -0,0 +1,43 @@
+/*
+ * ShrikeOS Monitor — Periodic Task Timing
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SHRIKE_PERIODIC_H
+#define SHRIKE_PERIODIC_H
+
+#include <zephyr/kernel.h>
+
+/* With CONFIG_SCHED_DEADLINE every periodic task is moved to this one
+ * priority so the kernel orders them by deadline; the sporadic serial
+ * thread (priority 4) stays above the band.
+ */
+#define PERIODIC_EDF_PRIORITY  5
+
+struct periodic_stats {
+	uint32_t jobs;
+	uint32_t misses;         /* finished after release + deadline   */
+	uint32_t skipped;        /* releases dropped after an overrun   */
+	uint32_t resp_last_us;   /* response time = finish - release    */
+	uint32_t resp_max_us;
+	uint64_t resp_sum_us;
+};
+
+struct periodic_task {
+	const char           *name;
+	uint32_t              period_ms;
+	uint32_t              deadline_ms;   /* relative; 0 = period      */
+	int64_t               release;       /* current job, in ticks     */
+	struct periodic_stats stats;
+};
+
+#define PERIODIC_TASK_INIT(_name, _period_ms) \
+	{ .name = (_name), .period_ms = (_period_ms) }
+
+void periodic_start(struct periodic_task *t);
+void periodic_next(struct periodic_task *t);
+void periodic_set_period(struct periodic_task *t, uint32_t period_ms);
+void periodic_init(void);
+
+#endif /* SHRIKE_PERIODIC_H */
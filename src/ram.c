@@ -0,0 +1,255 @@
+/*
+ * ShrikeOS Monitor — RAM Accounting
+ *
+ * Shows where the RP2040's 264 KB of SRAM goes.  Nearly all of it is
+ * static, so most of the report comes from the build: the linker's
+ * region symbols give the image's .data, .bss and noinit totals, and a
+ * table generated from libapp.a after it is compiled
+ * (scripts/gen_ram_table.py) splits the application's share by source
+ * file and lists its largest buffers.  The run-time part adds thread
+ * stacks against their high-water marks (from sysinfo), the heap and
+ * the frame pool.
+ *
+ * 'ram' prints the report and 'ram json' sends it as one JSON object
+ * per line, so the numbers of two builds can be diffed directly.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/linker/linker-defs.h>
+#include <zephyr/sys/util.h>
+#include <string.h>
+
+#include "command.h"
+#include "frame_pool.h"
+#include "json.h"
+#include "ram.h"
+#include "sysinfo.h"
+
+/* --------------------------------------------------------------------
+ * Configuration
+ * ------------------------------------------------------------------ */
+
+#define RAM_JSON_LINE_LEN  200
+
+static const struct json_field ram_image_fields[] = {
+	JSON_FIELD(struct ram_totals, sram,  "sram",  JSON_F_U32),
+	JSON_FIELD(struct ram_totals, image, "image", JSON_F_U32),
+	JSON_FIELD(struct ram_totals, data,  "data",  JSON_F_U32),
+	JSON_FIELD(struct ram_totals, bss,   "bss",   JSON_F_U32),
+	JSON_FIELD(struct ram_totals, other, "other", JSON_F_U32),
+	JSON_FIELD(struct ram_totals, app,   "app",   JSON_F_U32),
+};
+
+static const struct json_field ram_runtime_fields[] = {
+	JSON_FIELD(struct ram_totals, heap,        "heap",        JSON_F_U32),
+	JSON_FIELD(struct ram_totals, heap_used,   "heap_used",   JSON_F_U32),
+	JSON_FIELD(struct ram_totals, heap_peak,   "heap_peak",   JSON_F_U32),
+	JSON_FIELD(struct ram_totals, stacks,      "stacks",      JSON_F_U32),
+	JSON_FIELD(struct ram_totals, stacks_used, "stacks_used", JSON_F_U32),
+	JSON_FIELD(struct ram_totals, pool,        "pool",        JSON_F_U32),
+	JSON_FIELD(struct ram_totals, pool_used,   "pool_used",   JSON_F_U32),
+	JSON_FIELD(struct ram_totals, pool_peak,   "pool_peak",   JSON_F_U32),
+};
+
+static const struct json_field ram_module_fields[] = {
+	JSON_FIELD(struct ram_module, data,   "data",   JSON_F_U32),
+	JSON_FIELD(struct ram_module, bss,    "bss",    JSON_F_U32),
+	JSON_FIELD(struct ram_module, noinit, "noinit", JSON_F_U32),
+};
+
+/* --------------------------------------------------------------------
+ * Public API
+ * ------------------------------------------------------------------ */
+
+/**
+ * ram_get_totals — Fill @p out from the linker symbols, the generated
+ * module table and the latest run-time figures.
+ */
+void ram_get_totals(struct ram_totals *out)
+{
+	struct frame_pool_stats ps;
+	struct sysinfo_thread t;
+
+	memset(out, 0, sizeof(*out));
+
+	out->sram  = CONFIG_SRAM_SIZE * 1024U;
+	out->image = (uint32_t)(_image_ram_end - _image_ram_start);
+	out->data  = (uint32_t)(__data_region_end - __data_region_start);
+	out->bss   = (uint32_t)(__bss_end - __bss_start);
+	out->other = out->image - out->data - out->bss;
+
+	for (size_t i = 0; i < ram_module_count; i++) {
+		out->app += ram_modules[i].data + ram_modules[i].bss +
+			    ram_modules[i].noinit;
+	}
+
+	sysinfo_get_heap(&out->heap_used, &out->heap, &out->heap_peak);
+
+	for (int i = 0; sysinfo_get_thread(i, &t) == 0; i++) {
+		if (t.valid) {
+			out->stacks      += t.stack_size;
+			out->stacks_used += t.stack_used;
+		}
+	}
+
+	frame_pool_get_stats(&ps);
+	out->pool      = FRAME_POOL_COUNT * sizeof(struct frame_buf);
+	out->pool_used = ps.in_use * sizeof(struct frame_buf);
+	out->pool_peak = ps.peak * sizeof(struct frame_buf);
+}
+
+/* --------------------------------------------------------------------
+ * Commands
+ * ------------------------------------------------------------------ */
+
+static uint32_t ram_pct(uint32_t part, uint32_t whole)
+{
+	return whole ? part * 100 / whole : 0;
+}
+
+static void ram_print_report(struct cmd_session *sess,
+			     const struct ram_totals *rt)
+{
+	struct sysinfo_thread t;
+
+	cmd_print(sess, "\n=== RAM (bytes) ===\n");
+	cmd_print(sess, "SRAM %u | image %u (%u%%): data %u, bss %u, "
+		  "noinit %u\n", rt->sram, rt->image,
+		  ram_pct(rt->image, rt->sram), rt->data, rt->bss, rt->other);
+	cmd_print(sess, "Heap %u used / %u (peak %u) | pool %u / %u "
+		  "(peak %u)\n", rt->heap_used, rt->heap, rt->heap_peak,
+		  rt->pool_used, rt->pool, rt->pool_peak);
+	cmd_print(sess, "Stacks %u peak / %u\n", rt->stacks_used, rt->stacks);
+
+	cmd_print(sess, "%-16s %6s %6s %6s %6s\n",
+		  "Module", "Data", "Bss", "Noinit", "Total");
+	for (size_t i = 0; i < ram_module_count; i++) {
+		const struct ram_module *m = &ram_modules[i];
+
+		cmd_print(sess, "%-16s %6u %6u %6u %6u\n", m->name, m->data,
+			  m->bss, m->noinit, m->data + m->bss + m->noinit);
+	}
+	cmd_print(sess, "%-16s %27u (%u%% of image)\n", "app", rt->app,
+		  ram_pct(rt->app, rt->image));
+
+	cmd_print(sess, "%-22s %-12s %6s\n", "Largest", "Module", "Size");
+	for (size_t i = 0; i < ram_symbol_count; i++) {
+		const struct ram_symbol *s = &ram_symbols[i];
+
+		cmd_print(sess, "%-22s %-12s %6u\n", s->name, s->module,
+			  s->size);
+	}
+
+	cmd_print(sess, "%-18s %6s %6s %5s\n", "Thread", "Stack", "Peak",
+		  "Use%");
+	for (int i = 0; sysinfo_get_thread(i, &t) == 0; i++) {
+		if (t.valid) {
+			cmd_print(sess, "%-18s %6u %6u %4u%%\n", t.name,
+				  t.stack_size, t.stack_used,
+				  ram_pct(t.stack_used, t.stack_size));
+		}
+	}
+	cmd_print(sess, "===================\n\n");
+}
+
+/* Start one {"ram":"<kind>",...} line */
+static void ram_json_begin(struct json_writer *w, char *buf,
+			   const char *kind)
+{
+	json_init(w, buf, RAM_JSON_LINE_LEN);
+	json_obj_begin(w);
+	json_key(w, "ram");
+	json_str(w, kind);
+}
+
+static void ram_json_end(struct cmd_session *sess, struct json_writer *w,
+			 const char *buf)
+{
+	json_obj_end(w);
+	if (json_finish(w) >= 0) {
+		cmd_print(sess, "%s\n", buf);
+	}
+}
+
+static void ram_print_json(struct cmd_session *sess,
+			   const struct ram_totals *rt)
+{
+	char buf[RAM_JSON_LINE_LEN];
+	struct json_writer w;
+	struct sysinfo_thread t;
+
+	ram_json_begin(&w, buf, "image");
+	json_fields(&w, ram_image_fields, ARRAY_SIZE(ram_image_fields), rt);
+	ram_json_end(sess, &w, buf);
+
+	ram_json_begin(&w, buf, "runtime");
+	json_fields(&w, ram_runtime_fields, ARRAY_SIZE(ram_runtime_fields),
+		    rt);
+	ram_json_end(sess, &w, buf);
+
+	for (size_t i = 0; i < ram_module_count; i++) {
+		ram_json_begin(&w, buf, "module");
+		json_key(&w, "name");
+		json_str(&w, ram_modules[i].name);
+		json_fields(&w, ram_module_fields,
+			    ARRAY_SIZE(ram_module_fields), &ram_modules[i]);
+		ram_json_end(sess, &w, buf);
+	}
+
+	for (size_t i = 0; i < ram_symbol_count; i++) {
+		ram_json_begin(&w, buf, "symbol");
+		json_key(&w, "name");
+		json_str(&w, ram_symbols[i].name);
+		json_key(&w, "module");
+		json_str(&w, ram_symbols[i].module);
+		json_key(&w, "size");
+		json_u32(&w, ram_symbols[i].size);
+		ram_json_end(sess, &w, buf);
+	}
+
+	for (int i = 0; sysinfo_get_thread(i, &t) == 0; i++) {
+		if (!t.valid) {
+			continue;
+		}
+		ram_json_begin(&w, buf, "thread");
+		json_key(&w, "name");
+		json_str(&w, t.name);
+		json_key(&w, "stack");
+		json_u32(&w, t.stack_size);
+		json_key(&w, "peak");
+		json_u32(&w, t.stack_used);
+		ram_json_end(sess, &w, buf);
+	}
+}
+
+static int ram_cmd_handler(struct cmd_session *sess,
+			   int argc, struct cmd_arg *argv)
+{
+	struct ram_totals rt;
+
+	if (argc == 1 && (argv[0].type != CMD_ARG_STRING ||
+			  strcmp(argv[0].sval, "json") != 0)) {
+		cmd_print(sess, "Usage: ram [json]\n");
+		return -1;
+	}
+
+	ram_get_totals(&rt);
+
+	if (argc == 1) {
+		ram_print_json(sess, &rt);
+	} else {
+		ram_print_report(sess, &rt);
+	}
+	return 0;
+}
+
+/**
+ * ram_init — Register the 'ram' command.  Call after cmd_init().
+ */
+void ram_init(void)
+{
+	cmd_register("ram", "RAM use by module, thread, heap and pool",
+		     "ram [json]", ram_cmd_handler, 0, 1);
+}
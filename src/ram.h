@@ -0,0 +1,58 @@
+/*
+ * ShrikeOS Monitor — RAM Accounting
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SHRIKE_RAM_H
+#define SHRIKE_RAM_H
+
+#include <zephyr/kernel.h>
+
+/* Static RAM of one source file; the table is generated at build time
+ * by scripts/gen_ram_table.py, largest module first
+ */
+struct ram_module {
+	const char *name;
+	uint32_t    data;
+	uint32_t    bss;
+	uint32_t    noinit;      /* thread stacks and other uncleared RAM */
+};
+
+/* One of the largest RAM symbols in the application */
+struct ram_symbol {
+	const char *name;
+	const char *module;
+	uint32_t    size;
+};
+
+extern const struct ram_module ram_modules[];
+extern const struct ram_symbol ram_symbols[];
+extern const size_t            ram_module_count;
+extern const size_t            ram_symbol_count;
+
+/* Where the RAM goes, in bytes */
+struct ram_totals {
+	/* Image, from the linker */
+	uint32_t sram;           /* CONFIG_SRAM_SIZE                     */
+	uint32_t image;          /* _image_ram_start .. _image_ram_end    */
+	uint32_t data;
+	uint32_t bss;
+	uint32_t other;          /* noinit: stacks, heap, kernel buffers  */
+	uint32_t app;            /* sum of ram_modules                    */
+
+	/* Run time */
+	uint32_t heap;
+	uint32_t heap_used;
+	uint32_t heap_peak;
+	uint32_t stacks;         /* threads listed by sysinfo             */
+	uint32_t stacks_used;    /* high-water marks                      */
+	uint32_t pool;           /* frame pool                            */
+	uint32_t pool_used;
+	uint32_t pool_peak;
+};
+
+void ram_get_totals(struct ram_totals *out);
+void ram_init(void);
+
+#endif /* SHRIKE_RAM_H */
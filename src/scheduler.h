@@ -0,0 +1,16 @@
+/*
+ * ShrikeOS Monitor — Timed Command Scheduler
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SHRIKE_SCHEDULER_H
+#define SHRIKE_SCHEDULER_H
+
+#include <zephyr/kernel.h>
+
+int  sched_add(const char *line, uint32_t delay_ms, uint32_t period_ms);
+int  sched_cancel(int id);
+void sched_init(void);
+
+#endif /* SHRIKE_SCHEDULER_H */
@@ -0,0 +1,304 @@
+/*
+ * ShrikeOS Monitor — Interrupt-Driven Serial Transport
+ *
+ * Moves whole frames between the USB CDC ACM UART and the rest of the
+ * firmware.  The RX interrupt assembles each line straight into a pool
+ * frame and queues it for the serial thread; producers queue finished
+ * frames for TX and the interrupt drains them into the UART FIFO and
+ * frees them.  Nothing is copied between the formatter and the wire,
+ * and no line or frame buffer lives on a thread stack.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/uart.h>
+#include <zephyr/sys/util.h>
+#include <string.h>
+
+#include "command.h"
+#include "serial_io.h"
+#include "sysinfo.h"
+
+/* --------------------------------------------------------------------
+ * Configuration
+ * ------------------------------------------------------------------ */
+
+#define SERIAL_WRITE_WAIT_MS  100    /* serial_io_write frame wait */
+
+/* --------------------------------------------------------------------
+ * State
+ * ------------------------------------------------------------------ */
+
+static const struct device *serial_dev;
+
+static K_FIFO_DEFINE(rx_fifo);
+static K_FIFO_DEFINE(tx_fifo);
+
+/* ISR-owned */
+static struct frame_buf *rx_cur;
+static bool              rx_discard;   /* skipping the rest of a line */
+static struct frame_buf *tx_cur;
+
+/* Serialises the TX-empty check in the ISR against submit */
+static struct k_spinlock tx_lock;
+
+/* Keeps a multi-frame serial_io_write() contiguous on the wire; taken
+ * by submit too, so nothing is queued in the middle of one.  Recursive,
+ * as write submits.
+ */
+K_MUTEX_DEFINE(tx_writer_mutex);
+
+static struct serial_io_stats sio_stats;
+
+/* --------------------------------------------------------------------
+ * Interrupt handling
+ * ------------------------------------------------------------------ */
+
+static void serial_rx_byte(uint8_t c)
+{
+	if (c == '\n' || c == '\r') {
+		if (rx_cur && rx_cur->len > 0) {
+			rx_cur->data[rx_cur->len] = '\0';
+			k_fifo_put(&rx_fifo, rx_cur);
+			rx_cur = NULL;
+			sio_stats.rx_lines++;
+		}
+		rx_discard = false;
+		return;
+	}
+	if (rx_discard) {
+		return;
+	}
+
+	if (!rx_cur) {
+		rx_cur = frame_alloc(K_NO_WAIT);
+		if (!rx_cur) {
+			sio_stats.rx_dropped++;
+			rx_discard = true;
+			return;
+		}
+	}
+
+	if (rx_cur->len < FRAME_BUF_LEN - 1) {
+		rx_cur->data[rx_cur->len++] = (char)c;
+	} else {
+		/* Keep the head of an overlong line, as before */
+		sio_stats.rx_truncated++;
+		rx_discard = true;
+	}
+}
+
+static void serial_rx_isr(const struct device *dev)
+{
+	uint8_t chunk[16];
+	int n;
+
+	while ((n = uart_fifo_read(dev, chunk, sizeof(chunk))) > 0) {
+		for (int i = 0; i < n; i++) {
+			serial_rx_byte(chunk[i]);
+		}
+	}
+}
+
+static void serial_tx_isr(const struct device *dev)
+{
+	while (1) {
+		if (!tx_cur) {
+			k_spinlock_key_t key = k_spin_lock(&tx_lock);
+
+			tx_cur = k_fifo_get(&tx_fifo, K_NO_WAIT);
+			if (!tx_cur) {
+				uart_irq_tx_disable(dev);
+				k_spin_unlock(&tx_lock, key);
+				return;
+			}
+			k_spin_unlock(&tx_lock, key);
+		}
+
+		int n = uart_fifo_fill(dev,
+				       (const uint8_t *)tx_cur->data + tx_cur->pos,
+				       tx_cur->len - tx_cur->pos);
+		if (n <= 0) {
+			return;           /* FIFO full, wait for next IRQ */
+		}
+
+		tx_cur->pos += n;
+		sio_stats.tx_bytes += n;
+		if (tx_cur->pos >= tx_cur->len) {
+			frame_free(tx_cur);
+			tx_cur = NULL;
+			sio_stats.tx_frames++;
+		}
+	}
+}
+
+static void serial_isr(const struct device *dev, void *user_data)
+{
+	ARG_UNUSED(user_data);
+
+	while (uart_irq_update(dev) && uart_irq_is_pending(dev)) {
+		if (uart_irq_rx_ready(dev)) {
+			serial_rx_isr(dev);
+		}
+		if (uart_irq_tx_ready(dev)) {
+			serial_tx_isr(dev);
+		}
+	}
+}
+
+/* --------------------------------------------------------------------
+ * Public API
+ * ------------------------------------------------------------------ */
+
+/**
+ * serial_io_start — Attach to @p dev and enable RX/TX interrupts.
+ *
+ * @return  0 on success, negative errno if the driver has no
+ *          interrupt-driven API.
+ */
+int serial_io_start(const struct device *dev)
+{
+	int ret = uart_irq_callback_user_data_set(dev, serial_isr, NULL);
+
+	if (ret < 0) {
+		printk("[SERIAL] IRQ API unavailable (%d)\n", ret);
+		return ret;
+	}
+
+	serial_dev = dev;
+	uart_irq_rx_enable(dev);
+	printk("[SERIAL] Frame transport up (%d x %d B frames)\n",
+	       FRAME_POOL_COUNT, FRAME_BUF_LEN);
+	return 0;
+}
+
+/**
+ * serial_io_ready — True once serial_io_start() has attached the port;
+ * frames submitted before that are discarded.
+ */
+bool serial_io_ready(void)
+{
+	return serial_dev != NULL;
+}
+
+/**
+ * serial_io_submit — Queue a filled frame for transmission.
+ *
+ * Takes ownership of @p f; the TX interrupt frees it once sent.
+ */
+void serial_io_submit(struct frame_buf *f)
+{
+	serial_io_submit_timeout(f, K_FOREVER);
+}
+
+/**
+ * serial_io_submit_timeout — serial_io_submit() for producers that must
+ * not wait behind a long serial_io_write(), such as a sampling loop.
+ *
+ * @return  0 (frame taken), -ENODEV if the link is not up yet (frame
+ *          freed), or -EBUSY if another writer held the transport past
+ *          @p timeout (frame left with the caller).
+ */
+int serial_io_submit_timeout(struct frame_buf *f, k_timeout_t timeout)
+{
+	if (!serial_dev || f->len == 0) {
+		frame_free(f);
+		return serial_dev ? 0 : -ENODEV;
+	}
+
+	f->pos = 0;
+
+	if (k_mutex_lock(&tx_writer_mutex, timeout) != 0) {
+		return -EBUSY;
+	}
+	k_spinlock_key_t key = k_spin_lock(&tx_lock);
+	k_fifo_put(&tx_fifo, f);
+	uart_irq_tx_enable(serial_dev);
+	k_spin_unlock(&tx_lock, key);
+	k_mutex_unlock(&tx_writer_mutex);
+	return 0;
+}
+
+/**
+ * serial_io_write — Copy a byte string into frames and queue them.
+ *
+ * For callers that do not own a frame (long JSON dumps, legacy sinks,
+ * export chunks).  The whole string goes out contiguously; other
+ * producers wait until it is queued.
+ *
+ * @return  0, or -ENOMEM if the pool stayed empty and the rest of the
+ *          output was lost.
+ */
+int serial_io_write(const char *s, size_t len)
+{
+	k_mutex_lock(&tx_writer_mutex, K_FOREVER);
+
+	while (len > 0) {
+		struct frame_buf *f = frame_alloc(K_MSEC(SERIAL_WRITE_WAIT_MS));
+
+		if (!f) {
+			sio_stats.tx_dropped++;
+			k_mutex_unlock(&tx_writer_mutex);
+			return -ENOMEM;
+		}
+
+		size_t n = MIN(len, (size_t)FRAME_BUF_LEN);
+		memcpy(f->data, s, n);
+		f->len = n;
+		serial_io_submit(f);
+
+		s += n;
+		len -= n;
+	}
+
+	k_mutex_unlock(&tx_writer_mutex);
+	return 0;
+}
+
+/**
+ * serial_io_rx_get — Wait for the next received line.
+ *
+ * The frame holds a NUL-terminated line without its terminator; the
+ * caller owns it and must frame_free() it.
+ */
+struct frame_buf *serial_io_rx_get(k_timeout_t timeout)
+{
+	return k_fifo_get(&rx_fifo, timeout);
+}
+
+void serial_io_get_stats(struct serial_io_stats *out)
+{
+	memcpy(out, &sio_stats, sizeof(*out));
+}
+
+/* --------------------------------------------------------------------
+ * Commands
+ * ------------------------------------------------------------------ */
+
+static int serial_cmd_handler(struct cmd_session *sess,
+			      int argc, struct cmd_arg *argv)
+{
+	ARG_UNUSED(argc); ARG_UNUSED(argv);
+	struct serial_io_stats st;
+
+	serial_io_get_stats(&st);
+
+	cmd_print(sess, "RX: %u lines | dropped %u | truncated %u\n",
+		  st.rx_lines, st.rx_dropped, st.rx_truncated);
+	cmd_print(sess, "TX: %u frames, %u bytes | dropped %u\n",
+		  st.tx_frames, st.tx_bytes, st.tx_dropped);
+	return 0;
+}
+
+/**
+ * serial_io_init — Register the 'serial' command.  Call after cmd_init().
+ */
+void serial_io_init(void)
+{
+	cmd_register("serial", "Show serial transport counters",
+		     "serial", serial_cmd_handler, 0, 0);
+
+	SYSINFO_KOBJ_LABEL(tx_writer_mutex);
+}
@@ -0,0 +1,34 @@
+/*
+ * ShrikeOS Monitor — Interrupt-Driven Serial Transport
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SHRIKE_SERIAL_IO_H
+#define SHRIKE_SERIAL_IO_H
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+
+#include "frame_pool.h"
+
+struct serial_io_stats {
+	uint32_t rx_lines;
+	uint32_t rx_dropped;       /* no frame free for an incoming line */
+	uint32_t rx_truncated;     /* line longer than FRAME_BUF_LEN - 1 */
+	uint32_t tx_frames;
+	uint32_t tx_bytes;
+	uint32_t tx_dropped;       /* no frame free for serial_io_write  */
+};
+
+int               serial_io_start(const struct device *dev);
+bool              serial_io_ready(void);
+void              serial_io_submit(struct frame_buf *f);
+int               serial_io_submit_timeout(struct frame_buf *f,
+					   k_timeout_t timeout);
+int               serial_io_write(const char *s, size_t len);
+struct frame_buf *serial_io_rx_get(k_timeout_t timeout);
+void              serial_io_get_stats(struct serial_io_stats *out);
+void              serial_io_init(void);
+
+#endif /* SHRIKE_SERIAL_IO_H */
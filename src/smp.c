@@ -0,0 +1,200 @@
+/*
+ * ShrikeOS Monitor — SMP Support
+ *
+ * Thread placement and a small scaling harness for multi-core builds.
+ * With CONFIG_SMP and CONFIG_SCHED_CPU_MASK the latency-critical serial
+ * thread and the periodic collectors are pinned to different cores;
+ * on single-core builds every helper degrades to a no-op, so the same
+ * sources run unchanged on the stock RP2040 port.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/util.h>
+#include <string.h>
+
+#include "command.h"
+#include "smp.h"
+#include "sysinfo.h"
+
+/* --------------------------------------------------------------------
+ * Configuration
+ * ------------------------------------------------------------------ */
+
+#define SMP_MAX_PLACED        8
+#define SMP_BENCH_STACK_SIZE  1024
+#define SMP_BENCH_PRIORITY    10     /* below every app thread */
+
+/* --------------------------------------------------------------------
+ * State
+ * ------------------------------------------------------------------ */
+
+static struct {
+	k_tid_t tid;
+	int8_t  cpu;           /* -1: pinning unavailable, runs anywhere */
+} placed[SMP_MAX_PLACED];
+static int placed_count;
+
+K_MUTEX_DEFINE(smp_mutex);
+
+K_THREAD_STACK_ARRAY_DEFINE(smp_bench_stacks, SMP_MAX_CPUS,
+			    SMP_BENCH_STACK_SIZE);
+static struct k_thread smp_bench_threads[SMP_MAX_CPUS];
+
+static atomic_t               bench_busy;
+static atomic_t               bench_stop;
+static struct percpu_counter  bench_ops;
+static smp_work_fn_t          bench_fn;
+static void                  *bench_arg;
+
+/* --------------------------------------------------------------------
+ * Placement
+ * ------------------------------------------------------------------ */
+
+/**
+ * smp_start — Pin a thread defined with SMP_START_DELAY and start it.
+ *
+ * Without CPU masks the thread is only started (a no-op if it already
+ * runs) and recorded for the 'cpus' report.  Calling it again for the
+ * same thread, e.g. after a restart, updates its existing record.
+ *
+ * @return  0 if pinned (or nothing to do), negative errno if the pin
+ *          was refused; the thread is started either way.
+ */
+int smp_start(k_tid_t tid, int cpu)
+{
+	int ret = 0;
+
+	int i;
+
+#ifdef CONFIG_SCHED_CPU_MASK
+	ret = k_thread_cpu_pin(tid, cpu);
+#endif
+	k_thread_start(tid);
+
+	k_mutex_lock(&smp_mutex, K_FOREVER);
+	for (i = 0; i < placed_count; i++) {
+		if (placed[i].tid == tid) {
+			break;
+		}
+	}
+	if (i < SMP_MAX_PLACED) {
+		placed[i].tid = tid;
+#ifdef CONFIG_SCHED_CPU_MASK
+		placed[i].cpu = (ret == 0) ? cpu : -1;
+#else
+		placed[i].cpu = -1;
+#endif
+		placed_count = MAX(placed_count, i + 1);
+	}
+	k_mutex_unlock(&smp_mutex);
+
+	return ret;
+}
+
+/* --------------------------------------------------------------------
+ * Scaling harness
+ * ------------------------------------------------------------------ */
+
+static void smp_bench_worker(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1); ARG_UNUSED(p2); ARG_UNUSED(p3);
+
+	while (!atomic_get(&bench_stop)) {
+		bench_fn(bench_arg);
+		percpu_inc(&bench_ops);
+	}
+}
+
+/**
+ * smp_bench_run — Run @p fn in a tight loop on @p workers threads.
+ *
+ * Worker i is pinned to CPU i when CPU masks are available.  The caller
+ * sleeps for @p ms, then stops and joins the workers.
+ *
+ * @param per_cpu  Optional, receives the iteration count per CPU
+ *                 (SMP_MAX_CPUS entries).
+ * @return         Total iterations, or -EBUSY if a run is in progress.
+ */
+int smp_bench_run(smp_work_fn_t fn, void *arg, int workers, uint32_t ms,
+		  uint32_t *per_cpu)
+{
+	if (!atomic_cas(&bench_busy, 0, 1)) {
+		return -EBUSY;
+	}
+
+	workers = CLAMP(workers, 1, SMP_MAX_CPUS);
+	bench_fn  = fn;
+	bench_arg = arg;
+	percpu_clear(&bench_ops);
+	atomic_clear(&bench_stop);
+
+	for (int i = 0; i < workers; i++) {
+		k_tid_t tid = k_thread_create(&smp_bench_threads[i],
+					      smp_bench_stacks[i],
+					      K_THREAD_STACK_SIZEOF(smp_bench_stacks[i]),
+					      smp_bench_worker, NULL, NULL, NULL,
+					      SMP_BENCH_PRIORITY, 0, K_FOREVER);
+#ifdef CONFIG_SCHED_CPU_MASK
+		k_thread_cpu_pin(tid, i);
+#endif
+		k_thread_start(tid);
+	}
+
+	k_msleep(ms);
+	atomic_set(&bench_stop, 1);
+
+	for (int i = 0; i < workers; i++) {
+		k_thread_join(&smp_bench_threads[i], K_FOREVER);
+	}
+
+	if (per_cpu) {
+		for (int i = 0; i < SMP_MAX_CPUS; i++) {
+			per_cpu[i] = percpu_get(&bench_ops, i);
+		}
+	}
+
+	int total = (int)percpu_sum(&bench_ops);
+	atomic_clear(&bench_busy);
+	return total;
+}
+
+/* --------------------------------------------------------------------
+ * Commands
+ * ------------------------------------------------------------------ */
+
+static int cpus_cmd_handler(struct cmd_session *sess,
+			    int argc, struct cmd_arg *argv)
+{
+	ARG_UNUSED(argc); ARG_UNUSED(argv);
+
+	cmd_print(sess, "CPUs: %d online (build max %d), this command on %d\n",
+		  smp_num_cpus(), SMP_MAX_CPUS, smp_cpu_id());
+
+	k_mutex_lock(&smp_mutex, K_FOREVER);
+	for (int i = 0; i < placed_count; i++) {
+		const char *name = k_thread_name_get(placed[i].tid);
+
+		if (placed[i].cpu < 0) {
+			cmd_print(sess, "  %-16s any\n", name ? name : "?");
+		} else {
+			cmd_print(sess, "  %-16s cpu %d\n", name ? name : "?",
+				  placed[i].cpu);
+		}
+	}
+	k_mutex_unlock(&smp_mutex);
+	return 0;
+}
+
+/**
+ * smp_init — Register SMP commands.  Call after cmd_init().
+ */
+void smp_init(void)
+{
+	cmd_register("cpus", "Show CPU count and thread placement",
+		     "cpus", cpus_cmd_handler, 0, 0);
+
+	SYSINFO_KOBJ_LABEL(smp_mutex);
+}
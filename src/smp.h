@@ -0,0 +1,97 @@
+/*
+ * ShrikeOS Monitor — SMP Support
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SHRIKE_SMP_H
+#define SHRIKE_SMP_H
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+
+#ifdef CONFIG_SMP
+#define SMP_MAX_CPUS      CONFIG_MP_MAX_NUM_CPUS
+#else
+#define SMP_MAX_CPUS      1
+#endif
+
+/* CPU placement: serial I/O gets core 0 to itself, the periodic
+ * collectors (sensor, display, sysinfo) share the other core.
+ */
+#define SMP_CPU_IO        0
+#define SMP_CPU_COLLECT   (SMP_MAX_CPUS > 1 ? 1 : 0)
+
+/* Pinned threads must not be runnable when their mask is set, so with
+ * CPU masks they are defined unstarted and launched by smp_start().
+ */
+#ifdef CONFIG_SCHED_CPU_MASK
+#define SMP_START_DELAY   SYS_FOREVER_MS
+#else
+#define SMP_START_DELAY   0
+#endif
+
+static inline int smp_cpu_id(void)
+{
+#ifdef CONFIG_SMP
+	return arch_curr_cpu()->id;
+#else
+	return 0;
+#endif
+}
+
+static inline int smp_num_cpus(void)
+{
+#ifdef CONFIG_SMP
+	return (int)arch_num_cpus();
+#else
+	return 1;
+#endif
+}
+
+/*
+ * Event counter with one slot per CPU.  Writers only touch the slot of
+ * the CPU they run on, so hot counters stop bouncing between cores;
+ * the slot update is still atomic, which keeps it correct if the
+ * thread migrates between reading the CPU id and the increment.
+ */
+struct percpu_counter {
+	atomic_t slot[SMP_MAX_CPUS];
+};
+
+static inline void percpu_inc(struct percpu_counter *c)
+{
+	atomic_inc(&c->slot[smp_cpu_id()]);
+}
+
+static inline uint32_t percpu_sum(const struct percpu_counter *c)
+{
+	uint32_t sum = 0;
+
+	for (int i = 0; i < SMP_MAX_CPUS; i++) {
+		sum += (uint32_t)atomic_get(&c->slot[i]);
+	}
+	return sum;
+}
+
+static inline uint32_t percpu_get(const struct percpu_counter *c, int cpu)
+{
+	return (uint32_t)atomic_get(&c->slot[cpu]);
+}
+
+static inline void percpu_clear(struct percpu_counter *c)
+{
+	for (int i = 0; i < SMP_MAX_CPUS; i++) {
+		atomic_clear(&c->slot[i]);
+	}
+}
+
+/* One iteration of the workload measured by smp_bench_run() */
+typedef void (*smp_work_fn_t)(void *arg);
+
+int  smp_start(k_tid_t tid, int cpu);
+int  smp_bench_run(smp_work_fn_t fn, void *arg, int workers, uint32_t ms,
+		   uint32_t *per_cpu);
+void smp_init(void);
+
+#endif /* SHRIKE_SMP_H */
@@ -0,0 +1,173 @@
+/*
+ * ShrikeOS Monitor — State Snapshot
+ *
+ * 'snapshot' sends everything the dashboard shows as one JSON line, so
+ * a host that has just connected is fully populated after one round
+ * trip instead of waiting for telemetry, sysinfo and log traffic to
+ * come by:
+ *
+ *   {"snap":<n>,"t":<uptime ms>,"telem":{...},"wdg":{...},"sup":{...},
+ *    "hist":{...},"sys":{...},"log":{...}}
+ *
+ * Each section is rendered by its module's *_format_json() straight into
+ * the line.  A section that does not fit is left out, and the log, which
+ * goes last, keeps only as many entries as there is room for.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+
+#include "command.h"
+#include "history.h"
+#include "json.h"
+#include "logger.h"
+#include "snapshot.h"
+#include "supervisor.h"
+#include "sysinfo.h"
+#include "telemetry.h"
+#include "watchdog.h"
+
+/* --------------------------------------------------------------------
+ * Configuration
+ * ------------------------------------------------------------------ */
+
+#define SNAP_JSON_MAX      4096   /* heap buffer for one snapshot line */
+#define SNAP_MIN_ROOM      32     /* don't start a section in less     */
+#define SNAP_HIST_SAMPLES  60     /* the last minute of temperatures   */
+#define SNAP_LOG_ENTRIES   16
+
+typedef int (*snap_format_fn)(char *buf, size_t buf_len);
+
+static int snap_telem(char *buf, size_t buf_len)
+{
+	struct telemetry_frame f;
+	struct json_writer w;
+
+	if (telem_read(&f) != 0) {
+		return -ENODEV;
+	}
+
+	json_init(&w, buf, buf_len);
+	json_obj_begin(&w);
+	json_fields(&w, telemetry_fields, TELEMETRY_FIELD_COUNT, &f);
+	json_obj_end(&w);
+	return json_finish(&w);
+}
+
+static int snap_hist(char *buf, size_t buf_len)
+{
+	return history_format_json(buf, buf_len, SNAP_HIST_SAMPLES);
+}
+
+static int snap_log(char *buf, size_t buf_len)
+{
+	return shrike_log_format_json(buf, buf_len, SNAP_LOG_ENTRIES);
+}
+
+/* In order of priority: whatever does not fit is left out */
+static const struct {
+	const char     *key;
+	snap_format_fn  format;
+} snap_sections[] = {
+	{ "telem", snap_telem },
+	{ "wdg",   wdg_format_json },
+	{ "sup",   sup_format_json },
+	{ "hist",  snap_hist },
+	{ "sys",   sysinfo_format_json },
+	{ "log",   snap_log },
+};
+
+/* --------------------------------------------------------------------
+ * State
+ * ------------------------------------------------------------------ */
+
+static atomic_t snap_seq;
+
+/* --------------------------------------------------------------------
+ * Public API
+ * ------------------------------------------------------------------ */
+
+/**
+ * snapshot_format_json — Render the consolidated state line, without
+ * the trailing newline.
+ *
+ * @return  Length written, or -ENOMEM if not even the header fits.
+ */
+int snapshot_format_json(char *buf, size_t buf_len)
+{
+	struct json_writer w;
+
+	json_init(&w, buf, buf_len);
+	json_obj_begin(&w);
+	json_key(&w, "snap");
+	json_u32(&w, (uint32_t)atomic_inc(&snap_seq) + 1);
+	json_key(&w, "t");
+	json_u32(&w, k_uptime_get_32());
+
+	/* Keep room for the closing brace */
+	json_reserve(&w, 1);
+	for (size_t i = 0; i < ARRAY_SIZE(snap_sections); i++) {
+		struct json_mark m = json_checkpoint(&w);
+		size_t room;
+
+		json_key(&w, snap_sections[i].key);
+		char *p = json_value_begin(&w, &room);
+
+		if (room < SNAP_MIN_ROOM) {
+			json_rewind(&w, m);
+			continue;
+		}
+		json_value_end(&w, snap_sections[i].format(p, room));
+		if (w.overflow) {
+			json_rewind(&w, m);
+		}
+	}
+	json_release(&w, 1);
+
+	json_obj_end(&w);
+	return json_finish(&w);
+}
+
+/* --------------------------------------------------------------------
+ * Commands
+ * ------------------------------------------------------------------ */
+
+static int snapshot_cmd_handler(struct cmd_session *sess,
+				int argc, struct cmd_arg *argv)
+{
+	ARG_UNUSED(argc); ARG_UNUSED(argv);
+
+	char *buf = k_malloc(SNAP_JSON_MAX);
+
+	if (!buf) {
+		cmd_print(sess, "Out of memory\n");
+		return -1;
+	}
+
+	/* Newline added here so the line goes out in one write */
+	int len = snapshot_format_json(buf, SNAP_JSON_MAX - 1);
+
+	if (len < 0) {
+		k_free(buf);
+		cmd_print(sess, "Snapshot failed: %d\n", len);
+		return -1;
+	}
+	buf[len]     = '\n';
+	buf[len + 1] = '\0';
+	cmd_write(sess, buf);
+
+	k_free(buf);
+	return 0;
+}
+
+/**
+ * snapshot_init — Register the 'snapshot' command.  Call after
+ * cmd_init().
+ */
+void snapshot_init(void)
+{
+	cmd_register("snapshot", "Whole device state as one JSON line",
+		     "snapshot", snapshot_cmd_handler, 0, 0);
+}
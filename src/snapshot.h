@@ -0,0 +1,15 @@
+/*
+ * ShrikeOS Monitor — State Snapshot
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SHRIKE_SNAPSHOT_H
+#define SHRIKE_SNAPSHOT_H
+
+#include <zephyr/kernel.h>
+
+int  snapshot_format_json(char *buf, size_t buf_len);
+void snapshot_init(void);
+
+#endif /* SHRIKE_SNAPSHOT_H */
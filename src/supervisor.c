@@ -0,0 +1,329 @@
+/*
+ * ShrikeOS Monitor — Thread Supervisor
+ *
+ * Turns watchdog timeouts into actual recovery.  Supervised threads are
+ * declared with SUP_CHILD_DEFINE (entry, stack, priority, placement and
+ * restart policy) and started with sup_start(), which also registers
+ * their watchdog slot.  When the watchdog flags one UNRESPONSIVE, the
+ * one-for-one policy aborts just that thread, runs its reinit hook and
+ * re-creates it from the definition, so service comes back without a
+ * board reset that would drop the USB link.  Restarts are rate limited
+ * (max_restarts per window_ms); past that the child is left FAILED.
+ *
+ * Time-to-recover runs from detection to the first heartbeat of the new
+ * incarnation and is reported by 'sup' and sup_format_json().
+ *
+ * A thread aborted while holding a mutex leaves it locked; supervised
+ * loops should keep shared locks short and never block while holding
+ * one.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "command.h"
+#include "json.h"
+#include "logger.h"
+#include "smp.h"
+#include "supervisor.h"
+#include "sysinfo.h"
+#include "watchdog.h"
+
+/* --------------------------------------------------------------------
+ * Configuration
+ * ------------------------------------------------------------------ */
+
+#define SUP_MAX_CHILDREN  6
+
+static const char *const sup_state_names[] = {
+	[SUP_CHILD_STOPPED]    = "stopped",
+	[SUP_CHILD_RUNNING]    = "running",
+	[SUP_CHILD_RESTARTING] = "restarting",
+	[SUP_CHILD_FAILED]     = "failed",
+};
+
+static const char *const sup_policy_names[] = {
+	[SUP_ONE_FOR_ONE] = "one_for_one",
+	[SUP_TEMPORARY]   = "temporary",
+};
+
+/* Structured log events */
+SHRIKE_LOG_EVENT_DEFINE(sup_restart, LOG_EV_SUP_RESTART,
+			LOG_KV("child", STR),
+			LOG_KV("silence_ms", U32),
+			LOG_KV("cost_us", U32));
+SHRIKE_LOG_EVENT_DEFINE(sup_recovered, LOG_EV_SUP_RECOVERED,
+			LOG_KV("child", STR),
+			LOG_KV("ttr_us", U32));
+SHRIKE_LOG_EVENT_DEFINE(sup_gave_up, LOG_EV_SUP_GAVE_UP,
+			LOG_KV("child", STR),
+			LOG_KV("restarts", U32),
+			LOG_KV("window_ms", U32));
+SHRIKE_LOG_EVENT_DEFINE(sup_not_restarted, LOG_EV_SUP_NOT_RESTARTED,
+			LOG_KV("child", STR),
+			LOG_KV("silence_ms", U32));
+
+static const struct json_field sup_stats_fields[] = {
+	JSON_FIELD(struct sup_stats, restarts,        "restarts",   JSON_F_U32),
+	JSON_FIELD(struct sup_stats, recovered,       "recovered",  JSON_F_U32),
+	JSON_FIELD(struct sup_stats, last_restart_us, "restart_us", JSON_F_U32),
+	JSON_FIELD(struct sup_stats, last_ttr_us,     "ttr_us",     JSON_F_U32),
+	JSON_FIELD(struct sup_stats, max_ttr_us,      "ttr_max_us", JSON_F_U32),
+};
+
+/* --------------------------------------------------------------------
+ * State
+ * ------------------------------------------------------------------ */
+
+static struct sup_child *children[SUP_MAX_CHILDREN];
+static int               child_count;
+
+K_MUTEX_DEFINE(sup_mutex);
+
+/* --------------------------------------------------------------------
+ * Lifecycle
+ * ------------------------------------------------------------------ */
+
+static struct sup_child *sup_find(const char *name)
+{
+	for (int i = 0; i < child_count; i++) {
+		if (strcmp(children[i]->name, name) == 0) {
+			return children[i];
+		}
+	}
+	return NULL;
+}
+
+/* Create (or re-create) the thread from its definition */
+/* Created suspended: sup_run() starts it */
+static k_tid_t sup_create(struct sup_child *c)
+{
+	k_tid_t tid = k_thread_create(&c->thread, c->stack, c->stack_size,
+				      c->entry, INT_TO_POINTER(c->wdg_slot),
+				      NULL, NULL, c->prio, 0, K_FOREVER);
+
+	k_thread_name_set(tid, c->name);
+	return tid;
+}
+
+static void sup_run(struct sup_child *c, k_tid_t tid)
+{
+	if (c->cpu >= 0) {
+		smp_start(tid, c->cpu);
+	} else {
+		k_thread_start(tid);
+	}
+}
+
+static void sup_spawn(struct sup_child *c)
+{
+	sup_run(c, sup_create(c));
+}
+
+/* Watchdog revive hook: runs in the restarted thread */
+static void sup_revived(const char *name)
+{
+	k_mutex_lock(&sup_mutex, K_FOREVER);
+
+	struct sup_child *c = sup_find(name);
+
+	if (c && c->state == SUP_CHILD_RESTARTING) {
+		uint32_t ttr = (uint32_t)MIN(k_ticks_to_us_floor64(
+					k_uptime_ticks() - c->detect_ticks),
+					(uint64_t)UINT32_MAX);
+
+		c->state = SUP_CHILD_RUNNING;
+		c->stats.recovered++;
+		c->stats.last_ttr_us = ttr;
+		c->stats.max_ttr_us  = MAX(c->stats.max_ttr_us, ttr);
+		c->stats.sum_ttr_us += ttr;
+		SHRIKE_LOG_KV(LOG_LVL_INFO, "SUP", sup_recovered, name, ttr);
+	}
+
+	k_mutex_unlock(&sup_mutex);
+}
+
+/* Watchdog recovery hook: runs in the watchdog checker thread */
+static void sup_unresponsive(const char *name, uint32_t elapsed_ms)
+{
+	k_mutex_lock(&sup_mutex, K_FOREVER);
+
+	struct sup_child *c = sup_find(name);
+	int64_t now = k_uptime_get();
+
+	if (!c || c->state == SUP_CHILD_FAILED) {
+		k_mutex_unlock(&sup_mutex);
+		return;
+	}
+
+	if (c->policy == SUP_TEMPORARY) {
+		SHRIKE_LOG_KV(LOG_LVL_WARN, "SUP", sup_not_restarted, name,
+			      elapsed_ms);
+		k_mutex_unlock(&sup_mutex);
+		return;
+	}
+
+	if (now - c->window_start > c->window_ms) {
+		c->window_start    = now;
+		c->window_restarts = 0;
+	}
+	if (c->window_restarts >= c->max_restarts) {
+		c->state = SUP_CHILD_FAILED;
+		SHRIKE_LOG_KV(LOG_LVL_ERROR, "SUP", sup_gave_up, name,
+			      (uint32_t)c->max_restarts, c->window_ms);
+		k_mutex_unlock(&sup_mutex);
+		return;
+	}
+	c->window_restarts++;
+
+	c->detect_ticks = k_uptime_ticks();
+	uint32_t t0 = k_cycle_get_32();
+
+	k_thread_abort(&c->thread);
+	if (c->reinit) {
+		c->reinit();
+	}
+	c->state = SUP_CHILD_RESTARTING;
+	c->stats.restarts++;
+	k_tid_t tid = sup_create(c);
+
+	/* Before the start: the child outranks this thread and would run
+	 * its first iteration inside the measurement
+	 */
+	c->stats.last_restart_us = k_cyc_to_us_floor32(k_cycle_get_32() - t0);
+	sup_run(c, tid);
+	SHRIKE_LOG_KV(LOG_LVL_WARN, "SUP", sup_restart, name, elapsed_ms,
+		      c->stats.last_restart_us);
+
+	k_mutex_unlock(&sup_mutex);
+}
+
+/**
+ * sup_start — Register a child with the watchdog and start it.
+ *
+ * @return  0 on success, -ENOMEM if the supervisor or watchdog table is
+ *          full (the thread is not started).
+ */
+int sup_start(struct sup_child *c)
+{
+	k_mutex_lock(&sup_mutex, K_FOREVER);
+
+	if (child_count >= SUP_MAX_CHILDREN) {
+		k_mutex_unlock(&sup_mutex);
+		return -ENOMEM;
+	}
+
+	c->wdg_slot = wdg_register(c->name, c->wdg_timeout_ms,
+				   sup_unresponsive);
+	if (c->wdg_slot < 0) {
+		k_mutex_unlock(&sup_mutex);
+		return -ENOMEM;
+	}
+	wdg_set_revive_cb(c->wdg_slot, sup_revived);
+
+	children[child_count++] = c;
+	c->state        = SUP_CHILD_RUNNING;
+	c->window_start = k_uptime_get();
+	sup_spawn(c);
+
+	k_mutex_unlock(&sup_mutex);
+	return 0;
+}
+
+/* --------------------------------------------------------------------
+ * Export
+ * ------------------------------------------------------------------ */
+
+/**
+ * sup_format_json — Serialise per-child state and recovery times.
+ *
+ * @return  Length written, or -ENOMEM if @p buf was too small.
+ */
+int sup_format_json(char *buf, size_t buf_len)
+{
+	struct json_writer w;
+
+	json_init(&w, buf, buf_len);
+	json_obj_begin(&w);
+	json_key(&w, "children");
+	json_arr_begin(&w);
+
+	k_mutex_lock(&sup_mutex, K_FOREVER);
+	for (int i = 0; i < child_count; i++) {
+		const struct sup_child *c = children[i];
+
+		json_obj_begin(&w);
+		json_key(&w, "name");
+		json_str(&w, c->name);
+		json_key(&w, "state");
+		json_str(&w, sup_state_names[c->state]);
+		json_fields(&w, sup_stats_fields, ARRAY_SIZE(sup_stats_fields),
+			    &c->stats);
+		json_obj_end(&w);
+	}
+	k_mutex_unlock(&sup_mutex);
+
+	json_arr_end(&w);
+	json_obj_end(&w);
+	return json_finish(&w);
+}
+
+/* --------------------------------------------------------------------
+ * Commands
+ * ------------------------------------------------------------------ */
+
+static int sup_cmd_handler(struct cmd_session *sess,
+			   int argc, struct cmd_arg *argv)
+{
+	if (argc == 1 && argv[0].type == CMD_ARG_STRING &&
+	    strcmp(argv[0].sval, "json") == 0) {
+		char buf[384];
+
+		if (sup_format_json(buf, sizeof(buf)) < 0) {
+			cmd_print(sess, "(truncated) ");
+		}
+		cmd_print(sess, "%s\n", buf);
+		return 0;
+	}
+	if (argc != 0) {
+		cmd_print(sess, "Usage: sup [json]\n");
+		return -1;
+	}
+
+	k_mutex_lock(&sup_mutex, K_FOREVER);
+	cmd_print(sess, "\n=== Supervisor ===\n");
+	cmd_print(sess, "%-10s %-10s %-11s %5s %8s %9s %9s %9s\n",
+		  "Child", "State", "Policy", "Rst", "Limit",
+		  "Rst us", "TTR us", "Max TTR");
+
+	for (int i = 0; i < child_count; i++) {
+		const struct sup_child *c = children[i];
+		char limit[12];
+
+		snprintf(limit, sizeof(limit), "%u/%us", c->max_restarts,
+			 c->window_ms / 1000);
+		cmd_print(sess, "%-10s %-10s %-11s %5u %8s %9u %9u %9u\n",
+			  c->name, sup_state_names[c->state],
+			  sup_policy_names[c->policy], c->stats.restarts,
+			  limit, c->stats.last_restart_us,
+			  c->stats.last_ttr_us, c->stats.max_ttr_us);
+	}
+	cmd_print(sess, "==================\n\n");
+	k_mutex_unlock(&sup_mutex);
+	return 0;
+}
+
+/**
+ * sup_init — Register supervisor commands.  Call after cmd_init().
+ */
+void sup_init(void)
+{
+	cmd_register("sup", "Supervised threads, restarts, recovery times",
+		     "sup [json]", sup_cmd_handler, 0, 1);
+
+	SYSINFO_KOBJ_LABEL(sup_mutex);
+}
@@ -0,0 +1,71 @@
+/*
+ * ShrikeOS Monitor — Thread Supervisor
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SHRIKE_SUPERVISOR_H
+#define SHRIKE_SUPERVISOR_H
+
+#include <zephyr/kernel.h>
+
+enum sup_policy {
+	SUP_ONE_FOR_ONE = 0,   /* restart only the failed thread        */
+	SUP_TEMPORARY,         /* report, never restart                 */
+};
+
+enum sup_child_state {
+	SUP_CHILD_STOPPED = 0,
+	SUP_CHILD_RUNNING,
+	SUP_CHILD_RESTARTING,  /* re-created, not yet reported in       */
+	SUP_CHILD_FAILED,      /* restart intensity exceeded, given up  */
+};
+
+struct sup_stats {
+	uint32_t restarts;
+	uint32_t last_restart_us;   /* abort + reinit + re-create        */
+	uint32_t last_ttr_us;       /* detection -> first heartbeat      */
+	uint32_t max_ttr_us;
+	uint64_t sum_ttr_us;
+	uint32_t recovered;         /* restarts that reported in again   */
+};
+
+/* A supervised thread: static definition plus run-time state.  The
+ * entry receives its watchdog slot in p1 (POINTER_TO_INT) and must
+ * heartbeat it, or wrap its iterations in wdg_begin()/wdg_end().
+ */
+struct sup_child {
+	const char        *name;
+	k_thread_entry_t   entry;
+	k_thread_stack_t  *stack;
+	size_t             stack_size;
+	int                prio;
+	int                cpu;            /* -1: no placement          */
+	uint32_t           wdg_timeout_ms;
+	enum sup_policy    policy;
+	uint8_t            max_restarts;   /* ...within window_ms       */
+	uint32_t           window_ms;
+	void             (*reinit)(void);  /* reset module state, opt.  */
+
+	struct k_thread      thread;
+	int                  wdg_slot;
+	enum sup_child_state state;
+	int64_t              window_start;
+	uint8_t              window_restarts;
+	int64_t              detect_ticks;
+	struct sup_stats     stats;
+};
+
+#define SUP_CHILD_DEFINE(_var, _stack_size, ...)                        \
+	K_THREAD_STACK_DEFINE(_var##_stack, _stack_size);               \
+	static struct sup_child _var = {                                \
+		.stack      = _var##_stack,                             \
+		.stack_size = K_THREAD_STACK_SIZEOF(_var##_stack),      \
+		__VA_ARGS__                                             \
+	}
+
+int  sup_start(struct sup_child *c);
+int  sup_format_json(char *buf, size_t buf_len);
+void sup_init(void);
+
+#endif /* SHRIKE_SUPERVISOR_H */
@@ -5,6 +5,22 @@
  * dashboard including memory statistics, thread enumeration, CPU load
  * estimation, and build/version information.
  *
+ * Two latency probes feed the snapshot as well.  A k_timer is armed for
+ * an absolute tick and its expiry handler measures how late it entered
+ * (interrupt latency).  It then gives a semaphore to a priority 1
+ * thread, which measures how long it took to run (wake-up latency).
+ * 'lat run' takes a burst of samples 10 ms apart; 'lat on' samples
+ * continuously at a low rate and logs spikes with the current CPU
+ * load, so they can be matched against what else was running.
+ *
+ * With CONFIG_OBJ_CORE the refresh also walks the kernel's semaphores,
+ * mutexes, message queues and memory slabs, re-reading at most
+ * SYSINFO_KOBJ_PER_REFRESH of them per pass and carrying on from there
+ * next time, so a refresh costs the same however many objects exist.
+ * Each object keeps its wait-queue length, level (count, lock depth,
+ * messages, blocks) and the peaks of both across passes.  Peaks are
+ * sampled, so a burst shorter than a full walk can be missed.
+ *
  * SPDX-License-Identifier: Apache-2.0
  */
 
@@ -14,61 +30,66 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "command.h"
+#include "json.h"
+#include "logger.h"
+#include "periodic.h"
+#include "smp.h"
+#include "sysinfo.h"
+
 /* --------------------------------------------------------------------
  * Configuration
  * ------------------------------------------------------------------ */
 
-#define SYSINFO_MAX_THREADS       16
 #define SYSINFO_UPDATE_INTERVAL   2000   /* ms between metric refreshes   */
 #define SYSINFO_STACK_SIZE        1536
 #define SYSINFO_PRIORITY          9
 
+#define SYSINFO_LAT_STACK_SIZE    768
+#define SYSINFO_LAT_PRIORITY      1      /* above everything it measures */
+#define SYSINFO_LAT_RUN_MS        10     /* 'lat run' sample spacing      */
+#define SYSINFO_LAT_PERIOD_MS     1000   /* 'lat on' default              */
+#define SYSINFO_LAT_SPIKE_US      500    /* logged while continuous       */
+
+#define SYSINFO_KOBJ_PER_REFRESH  8      /* objects re-read per refresh   */
+#define SYSINFO_KOBJ_WAIT_CAP     255    /* bounds each wait-queue walk   */
+#define SYSINFO_MAX_KOBJ_LABELS   24
+
+SHRIKE_LOG_EVENT_DEFINE(lat_spike, LOG_EV_LAT_SPIKE,
+			LOG_KV("irq_us", U32),
+			LOG_KV("wake_us", U32),
+			LOG_KV("cpu_pct", U32));
+
 /* Build metadata embedded at compile time */
 #define SHRIKE_FW_VERSION_MAJOR   1
 #define SHRIKE_FW_VERSION_MINOR   2
 #define SHRIKE_FW_VERSION_PATCH   0
 #define SHRIKE_BOARD_NAME         "Shrike-lite (RP2040 + SLG47910)"
-
-/* --------------------------------------------------------------------
- * Data Structures
- * ------------------------------------------------------------------ */
-
-/* Per-thread diagnostic snapshot */
-struct sysinfo_thread {
-	char     name[20];
-	uint32_t stack_size;
-	uint32_t stack_used;
-	uint8_t  priority;
-	uint8_t  state;          /* 0 = ready, 1 = running, 2 = waiting */
-	bool     valid;
+#define SHRIKE_FW_VERSION_STR     STRINGIFY(SHRIKE_FW_VERSION_MAJOR) "." \
+				  STRINGIFY(SHRIKE_FW_VERSION_MINOR) "." \
+				  STRINGIFY(SHRIKE_FW_VERSION_PATCH)
+
+/* JSON frame layout (after the constant "board" and "fw" members) */
+static const struct json_field sysinfo_json_fields[] = {
+	JSON_FIELD(struct sysinfo_snapshot, uptime_secs,  "up",         JSON_F_U32),
+	JSON_FIELD(struct sysinfo_snapshot, cpu_load_pct, "cpu",        JSON_F_U8),
+	JSON_FIELD(struct sysinfo_snapshot, heap_total,   "heap_total", JSON_F_U32),
+	JSON_FIELD(struct sysinfo_snapshot, heap_used,    "heap_used",  JSON_F_U32),
+	JSON_FIELD(struct sysinfo_snapshot, heap_free,    "heap_free",  JSON_F_U32),
+	JSON_FIELD(struct sysinfo_snapshot, thread_count, "threads",    JSON_F_U8),
+	JSON_FIELD(struct sysinfo_snapshot, boot_count,   "boots",      JSON_F_U32),
+	JSON_FIELD(struct sysinfo_snapshot, irq_lat.win_max_us,  "irq_us",  JSON_F_U32),
+	JSON_FIELD(struct sysinfo_snapshot, wake_lat.win_max_us, "wake_us", JSON_F_U32),
+	JSON_FIELD(struct sysinfo_snapshot, kobj_waiters,   "waiters",  JSON_F_U16),
+	JSON_FIELD(struct sysinfo_snapshot, wq_backlog,     "wq",       JSON_F_U16),
+	JSON_FIELD(struct sysinfo_snapshot, wq_backlog_max, "wq_max",   JSON_F_U16),
 };
 
-/* Aggregate system metrics */
-struct sysinfo_snapshot {
-	/* Timing */
-	uint32_t uptime_secs;
-	uint32_t uptime_ms;
-
-	/* Memory */
-	uint32_t heap_total;
-	uint32_t heap_used;
-	uint32_t heap_free;
-	uint32_t heap_max_used;
-
-	/* Threads */
-	uint8_t  thread_count;
-	struct sysinfo_thread threads[SYSINFO_MAX_THREADS];
-
-	/* CPU estimate (simple busy/idle ratio) */
-	uint8_t  cpu_load_pct;
-
-	/* Boot counter (persisted in RAM across soft resets if supported) */
-	uint32_t boot_count;
-
-	/* Firmware version */
-	uint8_t  fw_major;
-	uint8_t  fw_minor;
-	uint8_t  fw_patch;
+static const char *const kobj_kind_names[SYSINFO_KOBJ_KINDS] = {
+	[SYSINFO_KOBJ_SEM]   = "sem",
+	[SYSINFO_KOBJ_MUTEX] = "mutex",
+	[SYSINFO_KOBJ_MSGQ]  = "msgq",
+	[SYSINFO_KOBJ_SLAB]  = "slab",
 };
 
 /* The latest snapshot (protected by mutex) */
@@ -80,6 +101,28 @@ static volatile uint64_t idle_ticks_prev;
 static volatile uint64_t total_ticks_prev;
 static uint32_t boot_counter;
 
+/* Latency probes; live statistics under lat_lock */
+static struct k_spinlock      lat_lock;
+static struct sysinfo_latency lat_irq;
+static struct sysinfo_latency lat_wake;
+static uint32_t               lat_expected_cyc;  /* programmed expiry */
+static uint32_t               lat_give_cyc;
+static uint32_t               lat_irq_last_us;
+static uint32_t               lat_remaining;     /* 'lat run' samples */
+static uint32_t               lat_period_ms;     /* 0: not continuous */
+
+static K_SEM_DEFINE(lat_sem, 0, 1);
+
+/* Kernel object names and walk position; under sysinfo_mutex */
+static struct {
+	const void *obj;
+	const char *name;
+} kobj_labels[SYSINFO_MAX_KOBJ_LABELS];
+static uint8_t  kobj_label_count;
+static uint8_t  kobj_walk_kind;
+static uint16_t kobj_walk_pos;       /* objects of that kind done      */
+static uint8_t  kobj_untracked;      /* in the pass so far             */
+
 /* --------------------------------------------------------------------
  * Internal Helpers
  * ------------------------------------------------------------------ */
@@ -223,6 +266,408 @@ static void sysinfo_update_cpu(struct sysinfo_snapshot *s)
 #endif
 }
 
+/* --------------------------------------------------------------------
+ * Latency probes
+ * ------------------------------------------------------------------ */
+
+static void lat_record(struct sysinfo_latency *l, uint32_t us)
+{
+	int bucket = us ? 32 - __builtin_clz(us) : 0;
+
+	k_spinlock_key_t key = k_spin_lock(&lat_lock);
+	l->min_us     = l->samples ? MIN(l->min_us, us) : us;
+	l->max_us     = MAX(l->max_us, us);
+	l->win_max_us = MAX(l->win_max_us, us);
+	l->sum_us    += us;
+	l->samples++;
+	l->hist[MIN(bucket, SYSINFO_LAT_BUCKETS - 1)]++;
+	k_spin_unlock(&lat_lock, key);
+}
+
+/* Timer expiry, in interrupt context */
+static void lat_timer_fn(struct k_timer *timer)
+{
+	ARG_UNUSED(timer);
+
+	int32_t late = (int32_t)(k_cycle_get_32() - lat_expected_cyc);
+
+	lat_irq_last_us = k_cyc_to_us_floor32(MAX(late, 0));
+	lat_record(&lat_irq, lat_irq_last_us);
+
+	lat_give_cyc = k_cycle_get_32();
+	k_sem_give(&lat_sem);
+}
+
+K_TIMER_DEFINE(lat_timer, lat_timer_fn, NULL);
+
+/* Arm for an absolute tick so the exact expiry is known */
+static void lat_arm(uint32_t delay_ms)
+{
+	int64_t target = k_uptime_ticks() + k_ms_to_ticks_ceil64(delay_ms);
+
+	lat_expected_cyc = (uint32_t)k_ticks_to_cyc_floor64(target);
+	k_timer_start(&lat_timer, K_TIMEOUT_ABS_TICKS(target), K_NO_WAIT);
+}
+
+static void lat_thread_fn(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1); ARG_UNUSED(p2); ARG_UNUSED(p3);
+
+	while (1) {
+		k_sem_take(&lat_sem, K_FOREVER);
+
+		uint32_t wake_us = k_cyc_to_us_floor32(k_cycle_get_32() -
+						       lat_give_cyc);
+		lat_record(&lat_wake, wake_us);
+
+		k_spinlock_key_t key = k_spin_lock(&lat_lock);
+		uint32_t irq_us = lat_irq_last_us;
+		uint32_t delay  = 0;
+		bool     burst  = lat_remaining > 0;
+
+		if (burst && --lat_remaining > 0) {
+			delay = SYSINFO_LAT_RUN_MS;
+		} else if (lat_period_ms) {
+			delay = lat_period_ms;
+		}
+		k_spin_unlock(&lat_lock, key);
+
+		if (!burst && lat_period_ms &&
+		    (wake_us > SYSINFO_LAT_SPIKE_US ||
+		     irq_us > SYSINFO_LAT_SPIKE_US)) {
+			SHRIKE_LOG_KV(LOG_LVL_WARN, "LAT", lat_spike, irq_us,
+				      wake_us,
+				      (uint32_t)sysinfo_get_cpu_load());
+		}
+
+		if (delay) {
+			lat_arm(delay);
+		}
+	}
+}
+
+K_THREAD_DEFINE(sysinfo_lat_tid, SYSINFO_LAT_STACK_SIZE, lat_thread_fn,
+		NULL, NULL, NULL, SYSINFO_LAT_PRIORITY, 0, 0);
+
+/**
+ * sysinfo_lat_run — Take @p samples probe samples, SYSINFO_LAT_RUN_MS
+ * apart, then return to continuous sampling if it is on.
+ */
+void sysinfo_lat_run(uint32_t samples)
+{
+	if (samples == 0) {
+		return;
+	}
+
+	k_spinlock_key_t key = k_spin_lock(&lat_lock);
+	lat_remaining = samples;
+	k_spin_unlock(&lat_lock, key);
+
+	lat_arm(SYSINFO_LAT_RUN_MS);
+}
+
+/**
+ * sysinfo_lat_continuous — Sample every @p period_ms; 0 stops.
+ */
+void sysinfo_lat_continuous(uint32_t period_ms)
+{
+	k_spinlock_key_t key = k_spin_lock(&lat_lock);
+	bool burst = lat_remaining > 0;
+
+	lat_period_ms = period_ms;
+	k_spin_unlock(&lat_lock, key);
+
+	if (burst) {
+		return;              /* picks up the new period when done */
+	}
+	if (period_ms) {
+		lat_arm(period_ms);
+	} else {
+		k_timer_stop(&lat_timer);
+	}
+}
+
+/**
+ * sysinfo_lat_reset — Clear both probe distributions.
+ */
+void sysinfo_lat_reset(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&lat_lock);
+	memset(&lat_irq, 0, sizeof(lat_irq));
+	memset(&lat_wake, 0, sizeof(lat_wake));
+	k_spin_unlock(&lat_lock, key);
+}
+
+/* --------------------------------------------------------------------
+ * Kernel objects
+ * ------------------------------------------------------------------ */
+
+#ifdef CONFIG_OBJ_CORE
+
+static const uint32_t kobj_type_ids[SYSINFO_KOBJ_KINDS] = {
+	[SYSINFO_KOBJ_SEM]   = K_OBJ_TYPE_SEM_ID,
+	[SYSINFO_KOBJ_MUTEX] = K_OBJ_TYPE_MUTEX_ID,
+	[SYSINFO_KOBJ_MSGQ]  = K_OBJ_TYPE_MSGQ_ID,
+	[SYSINFO_KOBJ_SLAB]  = K_OBJ_TYPE_MEM_SLAB_ID,
+};
+
+struct kobj_walk {
+	struct sysinfo_snapshot *s;
+	uint8_t  kind;
+	uint16_t skip;
+	uint16_t budget;
+	uint16_t visited;
+};
+
+/*
+ * Threads pending on @p wq.  Called with interrupts off from the locked
+ * object walk, which makes the read consistent on one CPU; on SMP the
+ * scheduler may be changing the list on the other core, so the count
+ * can be off by one and the walk is capped.
+ */
+static uint8_t kobj_wait_len(_wait_q_t *wq)
+{
+#ifdef CONFIG_WAITQ_SCALABLE
+	/* Scalable wait queues are trees; report only whether anyone waits */
+	return rb_get_min(&wq->waitq.tree) != NULL;
+#else
+	/* CONFIG_WAITQ_SIMPLE, the default: a list in priority order */
+	sys_dnode_t *node;
+	uint8_t n = 0;
+
+	SYS_DLIST_FOR_EACH_NODE(&wq->waitq, node) {
+		if (++n == SYSINFO_KOBJ_WAIT_CAP) {
+			break;
+		}
+	}
+	return n;
+#endif
+}
+
+static const char *kobj_label_find(const void *obj)
+{
+	for (int i = 0; i < kobj_label_count; i++) {
+		if (kobj_labels[i].obj == obj) {
+			return kobj_labels[i].name;
+		}
+	}
+	return NULL;
+}
+
+static struct sysinfo_kobj *kobj_slot(struct sysinfo_snapshot *s,
+				      const void *obj, uint8_t kind)
+{
+	for (int i = 0; i < s->kobj_count; i++) {
+		if (s->kobjs[i].obj == obj) {
+			return &s->kobjs[i];
+		}
+	}
+	if (s->kobj_count == SYSINFO_MAX_KOBJS) {
+		return NULL;
+	}
+
+	struct sysinfo_kobj *k = &s->kobjs[s->kobj_count++];
+
+	memset(k, 0, sizeof(*k));
+	k->obj  = obj;
+	k->kind = kind;
+	return k;
+}
+
+static int kobj_visit(struct k_obj_core *oc, void *data)
+{
+	struct kobj_walk *wk = data;
+	const struct k_thread *owner = NULL;
+	uint32_t level, limit;
+	_wait_q_t *wq;
+	void *obj;
+
+	if (wk->skip) {
+		wk->skip--;
+		return 0;
+	}
+
+	switch (wk->kind) {
+	case SYSINFO_KOBJ_SEM: {
+		struct k_sem *sem = CONTAINER_OF(oc, struct k_sem, obj_core);
+
+		obj   = sem;
+		wq    = &sem->wait_q;
+		level = sem->count;
+		limit = sem->limit;
+		break;
+	}
+	case SYSINFO_KOBJ_MUTEX: {
+		struct k_mutex *m = CONTAINER_OF(oc, struct k_mutex, obj_core);
+
+		obj   = m;
+		wq    = &m->wait_q;
+		level = m->lock_count;
+		limit = 0;
+		owner = m->owner;
+		break;
+	}
+	case SYSINFO_KOBJ_MSGQ: {
+		struct k_msgq *q = CONTAINER_OF(oc, struct k_msgq, obj_core);
+
+		obj   = q;
+		wq    = &q->wait_q;
+		level = q->used_msgs;
+		limit = q->max_msgs;
+		break;
+	}
+	default: {
+		struct k_mem_slab *slab =
+			CONTAINER_OF(oc, struct k_mem_slab, obj_core);
+
+		obj   = slab;
+		wq    = &slab->wait_q;
+		level = slab->info.num_used;
+		limit = slab->info.num_blocks;
+		break;
+	}
+	}
+
+	struct sysinfo_kobj *k = kobj_slot(wk->s, obj, wk->kind);
+
+	if (k) {
+		k->waiters     = kobj_wait_len(wq);
+		k->max_waiters = MAX(k->max_waiters, k->waiters);
+		k->level       = level;
+		k->limit       = limit;
+		k->peak        = MAX(k->peak, level);
+		k->owner       = owner;
+	} else if (kobj_untracked < UINT8_MAX) {
+		kobj_untracked++;
+	}
+
+	wk->visited++;
+	return wk->visited == wk->budget;    /* non-zero ends the walk */
+}
+
+/*
+ * Re-read the next SYSINFO_KOBJ_PER_REFRESH objects, moving through the
+ * kinds in turn.  Positions are list indices: objects are only ever
+ * added, at the tail, so an index still names the same object on the
+ * next pass.
+ */
+static void sysinfo_update_kobjs(struct sysinfo_snapshot *s)
+{
+	uint16_t budget = SYSINFO_KOBJ_PER_REFRESH;
+
+	while (budget) {
+		struct k_obj_type *type =
+			k_obj_type_find(kobj_type_ids[kobj_walk_kind]);
+		struct kobj_walk wk = {
+			.s      = s,
+			.kind   = kobj_walk_kind,
+			.skip   = kobj_walk_pos,
+			.budget = budget,
+		};
+
+		if (type) {
+			k_obj_type_walk_locked(type, kobj_visit, &wk);
+		}
+		kobj_walk_pos += wk.visited;
+		budget        -= wk.visited;
+		if (!budget) {
+			break;
+		}
+
+		/* This kind is done; the next pass starts over */
+		kobj_walk_pos = 0;
+		if (++kobj_walk_kind == SYSINFO_KOBJ_KINDS) {
+			kobj_walk_kind    = 0;
+			s->kobj_untracked = kobj_untracked;
+			kobj_untracked    = 0;
+			s->kobj_passes++;
+			break;
+		}
+	}
+
+	for (int i = 0; i < s->kobj_count; i++) {
+		if (s->kobjs[i].label == NULL) {
+			s->kobjs[i].label = kobj_label_find(s->kobjs[i].obj);
+		}
+	}
+}
+
+#else
+
+static void sysinfo_update_kobjs(struct sysinfo_snapshot *s)
+{
+	ARG_UNUSED(s);
+}
+
+#endif /* CONFIG_OBJ_CORE */
+
+/*
+ * Items waiting on the system work queue.  Read without the work
+ * queue's lock, so the walk is capped in case an item is taken
+ * meanwhile; the maximum is only as good as the refresh rate.
+ */
+static void sysinfo_update_workq(struct sysinfo_snapshot *s)
+{
+	sys_snode_t *node;
+	uint16_t n = 0;
+	unsigned int key = irq_lock();
+
+	SYS_SLIST_FOR_EACH_NODE(&k_sys_work_q.pending, node) {
+		if (++n == UINT16_MAX) {
+			break;
+		}
+	}
+	irq_unlock(key);
+
+	s->wq_backlog     = n;
+	s->wq_backlog_max = MAX(s->wq_backlog_max, n);
+
+	s->kobj_waiters = 0;
+	for (int i = 0; i < s->kobj_count; i++) {
+		s->kobj_waiters += s->kobjs[i].waiters;
+	}
+}
+
+static const char *kobj_name(const struct sysinfo_kobj *k,
+			     char *buf, size_t len)
+{
+	if (k->label) {
+		return k->label;
+	}
+	snprintf(buf, len, "%s@%08lx", kobj_kind_names[k->kind],
+		 (unsigned long)(uintptr_t)k->obj);
+	return buf;
+}
+
+static const char *kobj_owner_name(const struct sysinfo_kobj *k)
+{
+	const char *name;
+
+	if (!k->owner) {
+		return "-";
+	}
+	name = k_thread_name_get((k_tid_t)k->owner);
+	return name && name[0] ? name : "?";
+}
+
+/**
+ * sysinfo_kobj_label — Show @p obj as @p name in kernel object output.
+ *
+ * @p name must stay valid; SYSINFO_KOBJ_LABEL() passes the symbol name.
+ */
+void sysinfo_kobj_label(const void *obj, const char *name)
+{
+	k_mutex_lock(&sysinfo_mutex, K_FOREVER);
+	if (kobj_label_count < SYSINFO_MAX_KOBJ_LABELS) {
+		kobj_labels[kobj_label_count].obj  = obj;
+		kobj_labels[kobj_label_count].name = name;
+		kobj_label_count++;
+	} else {
+		printk("[SYSINFO] No room to label %s\n", name);
+	}
+	k_mutex_unlock(&sysinfo_mutex);
+}
+
 /* --------------------------------------------------------------------
  * Public API
  * ------------------------------------------------------------------ */
@@ -281,6 +726,39 @@ uint8_t sysinfo_get_cpu_load(void)
 	return load;
 }
 
+/**
+ * sysinfo_get_thread — Copy entry @p idx of the latest thread table.
+ *
+ * @return  0, or -ENOENT past the last thread.
+ */
+int sysinfo_get_thread(int idx, struct sysinfo_thread *out)
+{
+	int ret = -ENOENT;
+
+	k_mutex_lock(&sysinfo_mutex, K_FOREVER);
+	if (idx >= 0 && idx < snapshot.thread_count) {
+		*out = snapshot.threads[idx];
+		ret  = 0;
+	}
+	k_mutex_unlock(&sysinfo_mutex);
+
+	return ret;
+}
+
+/**
+ * sysinfo_get_heap — Return heap usage from the latest snapshot.
+ *
+ * Any of the output pointers may be NULL.
+ */
+void sysinfo_get_heap(uint32_t *used, uint32_t *total, uint32_t *peak)
+{
+	k_mutex_lock(&sysinfo_mutex, K_FOREVER);
+	if (used)  *used  = snapshot.heap_used;
+	if (total) *total = snapshot.heap_total;
+	if (peak)  *peak  = snapshot.heap_max_used;
+	k_mutex_unlock(&sysinfo_mutex);
+}
+
 /**
  * sysinfo_get_fw_version — Write the firmware version string into buf.
  *
@@ -326,6 +804,12 @@ void sysinfo_dump(void)
 	       snapshot.heap_total, snapshot.heap_used,
 	       snapshot.heap_free, snapshot.heap_max_used);
 
+	printk("IRQ lat   : max %u us | wake lat: max %u us (%u samples)\n",
+	       snapshot.irq_lat.max_us, snapshot.wake_lat.max_us,
+	       snapshot.wake_lat.samples);
+	printk("Work queue: %u pending (max %u)\n",
+	       snapshot.wq_backlog, snapshot.wq_backlog_max);
+
 	printk("Threads   : %u\n", snapshot.thread_count);
 	printk("%-4s %-18s %-6s %-10s %-10s\n",
 	       "#", "Name", "Prio", "Stack", "Used");
@@ -341,6 +825,25 @@ void sysinfo_dump(void)
 		       t->stack_size, t->stack_used);
 	}
 
+	printk("Kernel objs: %u (%u passes, %u untracked) | %u waiting\n",
+	       snapshot.kobj_count, snapshot.kobj_passes,
+	       snapshot.kobj_untracked, snapshot.kobj_waiters);
+	if (snapshot.kobj_count) {
+		printk("%-18s %-5s %4s %4s %6s %6s %6s %s\n", "Object",
+		       "Type", "Wait", "Max", "Level", "Limit", "Peak",
+		       "Owner");
+	}
+
+	for (int i = 0; i < snapshot.kobj_count; i++) {
+		const struct sysinfo_kobj *k = &snapshot.kobjs[i];
+		char name[24];
+
+		printk("%-18s %-5s %4u %4u %6u %6u %6u %s\n",
+		       kobj_name(k, name, sizeof(name)),
+		       kobj_kind_names[k->kind], k->waiters, k->max_waiters,
+		       k->level, k->limit, k->peak, kobj_owner_name(k));
+	}
+
 	printk("===========================\n\n");
 
 	k_mutex_unlock(&sysinfo_mutex);
@@ -356,40 +859,227 @@ void sysinfo_dump(void)
  */
 int sysinfo_format_json(char *buf, size_t buf_len)
 {
-	int written;
+	struct json_writer w;
+
+	json_init(&w, buf, buf_len);
+	json_obj_begin(&w);
+	json_key(&w, "board");
+	json_str(&w, SHRIKE_BOARD_NAME);
+	json_key(&w, "fw");
+	json_str(&w, SHRIKE_FW_VERSION_STR);
 
 	k_mutex_lock(&sysinfo_mutex, K_FOREVER);
+	json_fields(&w, sysinfo_json_fields, ARRAY_SIZE(sysinfo_json_fields),
+		    &snapshot);
+
+	json_key(&w, "kobj");
+	json_arr_begin(&w);
+	for (int i = 0; i < snapshot.kobj_count; i++) {
+		const struct sysinfo_kobj *k = &snapshot.kobjs[i];
+		char name[24];
+
+		json_obj_begin(&w);
+		json_key(&w, "n");
+		json_str(&w, kobj_name(k, name, sizeof(name)));
+		json_key(&w, "t");
+		json_str(&w, kobj_kind_names[k->kind]);
+		json_key(&w, "w");
+		json_u32(&w, k->waiters);
+		json_key(&w, "w_max");
+		json_u32(&w, k->max_waiters);
+		json_key(&w, "v");
+		json_u32(&w, k->level);
+		json_key(&w, "lim");
+		json_u32(&w, k->limit);
+		json_key(&w, "peak");
+		json_u32(&w, k->peak);
+		json_obj_end(&w);
+	}
+	json_arr_end(&w);
+	k_mutex_unlock(&sysinfo_mutex);
+
+	json_obj_end(&w);
+	return json_finish(&w);
+}
+
+/* --------------------------------------------------------------------
+ * Commands
+ * ------------------------------------------------------------------ */
+
+static int stacks_cmd_handler(struct cmd_session *sess,
+			      int argc, struct cmd_arg *argv)
+{
+	ARG_UNUSED(argc); ARG_UNUSED(argv);
+
+	k_mutex_lock(&sysinfo_mutex, K_FOREVER);
+
+	cmd_print(sess, "\n=== Thread Stacks (high-water) ===\n");
+	cmd_print(sess, "%-18s %6s %6s %6s %5s\n",
+		  "Name", "Size", "Peak", "Free", "Use%");
+
+	for (int i = 0; i < snapshot.thread_count; i++) {
+		const struct sysinfo_thread *t = &snapshot.threads[i];
+		if (!t->valid) {
+			continue;
+		}
+		uint32_t pct = t->stack_size ?
+			       t->stack_used * 100 / t->stack_size : 0;
+		cmd_print(sess, "%-18s %6u %6u %6u %4u%%\n",
+			  t->name, t->stack_size, t->stack_used,
+			  t->stack_size - t->stack_used, pct);
+	}
 
-	written = snprintf(buf, buf_len,
-		"{\"board\":\"%s\","
-		"\"fw\":\"%u.%u.%u\","
-		"\"up\":%u,"
-		"\"cpu\":%u,"
-		"\"heap_total\":%u,"
-		"\"heap_used\":%u,"
-		"\"heap_free\":%u,"
-		"\"threads\":%u,"
-		"\"boots\":%u}",
-		SHRIKE_BOARD_NAME,
-		SHRIKE_FW_VERSION_MAJOR,
-		SHRIKE_FW_VERSION_MINOR,
-		SHRIKE_FW_VERSION_PATCH,
-		snapshot.uptime_secs,
-		snapshot.cpu_load_pct,
-		snapshot.heap_total,
-		snapshot.heap_used,
-		snapshot.heap_free,
-		snapshot.thread_count,
-		snapshot.boot_count);
+#ifndef CONFIG_INIT_STACKS
+	cmd_print(sess, "(peak needs CONFIG_INIT_STACKS)\n");
+#endif
+	cmd_print(sess, "Refreshed every %d ms\n", SYSINFO_UPDATE_INTERVAL);
 
 	k_mutex_unlock(&sysinfo_mutex);
-	return written;
+	return 0;
+}
+
+static int kobj_cmd_handler(struct cmd_session *sess,
+			    int argc, struct cmd_arg *argv)
+{
+	ARG_UNUSED(argc); ARG_UNUSED(argv);
+
+	k_mutex_lock(&sysinfo_mutex, K_FOREVER);
+
+	cmd_print(sess, "\n=== Kernel Objects ===\n");
+	cmd_print(sess, "%-18s %-5s %4s %4s %6s %6s %6s %s\n", "Object",
+		  "Type", "Wait", "Max", "Level", "Limit", "Peak", "Owner");
+
+	for (int i = 0; i < snapshot.kobj_count; i++) {
+		const struct sysinfo_kobj *k = &snapshot.kobjs[i];
+		char name[24];
+
+		cmd_print(sess, "%-18s %-5s %4u %4u %6u %6u %6u %s\n",
+			  kobj_name(k, name, sizeof(name)),
+			  kobj_kind_names[k->kind], k->waiters,
+			  k->max_waiters, k->level, k->limit, k->peak,
+			  kobj_owner_name(k));
+	}
+
+#ifdef CONFIG_OBJ_CORE
+	cmd_print(sess, "%u passes, %u per refresh, %u untracked\n",
+		  snapshot.kobj_passes, SYSINFO_KOBJ_PER_REFRESH,
+		  snapshot.kobj_untracked);
+#else
+	cmd_print(sess, "(objects need CONFIG_OBJ_CORE)\n");
+#endif
+	cmd_print(sess, "Work queue: %u pending (max %u)\n",
+		  snapshot.wq_backlog, snapshot.wq_backlog_max);
+
+	k_mutex_unlock(&sysinfo_mutex);
+	return 0;
+}
+
+static void lat_print(struct cmd_session *sess, const char *name,
+		      const struct sysinfo_latency *l)
+{
+	cmd_print(sess, "%-5s %8u %8u %8u %8u\n", name, l->samples,
+		  l->samples ? l->min_us : 0,
+		  l->samples ? (uint32_t)(l->sum_us / l->samples) : 0,
+		  l->max_us);
+}
+
+static int lat_cmd_handler(struct cmd_session *sess,
+			   int argc, struct cmd_arg *argv)
+{
+	if (argc >= 1) {
+		const char *op = argv[0].type == CMD_ARG_STRING ?
+				 argv[0].sval : "";
+		int n = (argc == 2 && argv[1].type == CMD_ARG_INT) ?
+			argv[1].ival : -1;
+
+		if (strcmp(op, "run") == 0 && (argc == 1 || n > 0)) {
+			n = n > 0 ? n : 100;
+			sysinfo_lat_run((uint32_t)n);
+			cmd_print(sess, "Sampling %d x %d ms; 'lat' for results\n",
+				  n, SYSINFO_LAT_RUN_MS);
+			return 0;
+		}
+		if (strcmp(op, "on") == 0 && (argc == 1 || n > 0)) {
+			n = n > 0 ? n : SYSINFO_LAT_PERIOD_MS;
+			sysinfo_lat_continuous((uint32_t)n);
+			cmd_print(sess, "Sampling every %d ms\n", n);
+			return 0;
+		}
+		if (strcmp(op, "off") == 0 && argc == 1) {
+			sysinfo_lat_continuous(0);
+			cmd_print(sess, "Continuous sampling off\n");
+			return 0;
+		}
+		if (strcmp(op, "reset") == 0 && argc == 1) {
+			sysinfo_lat_reset();
+			cmd_print(sess, "Latency statistics cleared\n");
+			return 0;
+		}
+		cmd_print(sess, "Usage: lat [run [n] | on [ms] | off | reset]\n");
+		return -1;
+	}
+
+	struct sysinfo_latency irq, wake;
+
+	k_spinlock_key_t key = k_spin_lock(&lat_lock);
+	irq  = lat_irq;
+	wake = lat_wake;
+	k_spin_unlock(&lat_lock, key);
+
+	cmd_print(sess, "\n=== Latency (us) ===\n");
+	cmd_print(sess, "%-5s %8s %8s %8s %8s\n",
+		  "Probe", "Samples", "Min", "Avg", "Max");
+	lat_print(sess, "irq", &irq);
+	lat_print(sess, "wake", &wake);
+
+	cmd_print(sess, "%-13s %8s %8s\n", "Bucket", "irq", "wake");
+	for (int b = 0; b < SYSINFO_LAT_BUCKETS; b++) {
+		if (!irq.hist[b] && !wake.hist[b]) {
+			continue;
+		}
+		if (b == 0) {
+			cmd_print(sess, "%-13s", "0");
+		} else if (b == SYSINFO_LAT_BUCKETS - 1) {
+			cmd_print(sess, ">= %-10u", (uint32_t)BIT(b - 1));
+		} else {
+			cmd_print(sess, "%5u..%-6u", (uint32_t)BIT(b - 1),
+				  (uint32_t)BIT(b) - 1);
+		}
+		cmd_print(sess, " %8u %8u\n", irq.hist[b], wake.hist[b]);
+	}
+	if (lat_period_ms) {
+		cmd_print(sess, "Continuous: every %u ms\n", lat_period_ms);
+	} else {
+		cmd_print(sess, "Continuous: off\n");
+	}
+	cmd_print(sess, "====================\n\n");
+	return 0;
+}
+
+/**
+ * sysinfo_init — Register diagnostics commands.  Call after cmd_init().
+ */
+void sysinfo_init(void)
+{
+	cmd_register("stacks", "Show per-thread stack high-water marks",
+		     "stacks", stacks_cmd_handler, 0, 0);
+	cmd_register("lat", "Interrupt and wake-up latency probes",
+		     "lat [run [n] | on [ms] | off | reset]",
+		     lat_cmd_handler, 0, 2);
+	cmd_register("kobj", "Kernel object waiters, levels and peaks",
+		     "kobj", kobj_cmd_handler, 0, 0);
+
+	SYSINFO_KOBJ_LABEL(sysinfo_mutex);
+	SYSINFO_KOBJ_LABEL(lat_sem);
 }
 
 /* --------------------------------------------------------------------
  * Background refresh thread
  * ------------------------------------------------------------------ */
 
+static struct periodic_task sysinfo_task =
+	PERIODIC_TASK_INIT("sysinfo", SYSINFO_UPDATE_INTERVAL);
+
 static void sysinfo_thread_fn(void *p1, void *p2, void *p3)
 {
 	ARG_UNUSED(p1);
@@ -402,6 +1092,8 @@ static void sysinfo_thread_fn(void *p1, void *p2, void *p3)
 	       "(interval %d ms, boot #%u)\n",
 	       SYSINFO_UPDATE_INTERVAL, boot_counter);
 
+	periodic_start(&sysinfo_task);
+
 	while (1) {
 		k_mutex_lock(&sysinfo_mutex, K_FOREVER);
 
@@ -415,13 +1107,23 @@ static void sysinfo_thread_fn(void *p1, void *p2, void *p3)
 		sysinfo_update_heap(&snapshot);
 		sysinfo_update_threads(&snapshot);
 		sysinfo_update_cpu(&snapshot);
+		sysinfo_update_kobjs(&snapshot);
+		sysinfo_update_workq(&snapshot);
+
+		k_spinlock_key_t key = k_spin_lock(&lat_lock);
+		snapshot.irq_lat  = lat_irq;
+		snapshot.wake_lat = lat_wake;
+		lat_irq.win_max_us  = 0;
+		lat_wake.win_max_us = 0;
+		k_spin_unlock(&lat_lock, key);
 
 		k_mutex_unlock(&sysinfo_mutex);
 
-		k_msleep(SYSINFO_UPDATE_INTERVAL);
+		periodic_next(&sysinfo_task);
 	}
 }
 
+/* Started by main() via smp_start() when CPU masks are enabled */
 K_THREAD_DEFINE(sysinfo_tid, SYSINFO_STACK_SIZE,
 		sysinfo_thread_fn, NULL, NULL, NULL,
-		SYSINFO_PRIORITY, 0, 0);
+		SYSINFO_PRIORITY, 0, SMP_START_DELAY);
@@ -0,0 +1,130 @@
+/*
+ * ShrikeOS Monitor — System Information & Diagnostics Module
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SHRIKE_SYSINFO_H
+#define SHRIKE_SYSINFO_H
+
+#include <zephyr/kernel.h>
+
+#define SYSINFO_MAX_THREADS       16
+#define SYSINFO_LAT_BUCKETS       16   /* log2(us); the last is open-ended */
+#define SYSINFO_MAX_KOBJS         32
+
+/* Per-thread diagnostic snapshot */
+struct sysinfo_thread {
+	char     name[20];
+	uint32_t stack_size;
+	uint32_t stack_used;
+	uint8_t  priority;
+	uint8_t  state;          /* 0 = ready, 1 = running, 2 = waiting */
+	bool     valid;
+};
+
+/* Latency distribution in microseconds.  Bucket b counts samples with a
+ * bit length of b, i.e. [2^(b-1), 2^b) us, and bucket 0 counts zeros.
+ */
+struct sysinfo_latency {
+	uint32_t samples;
+	uint32_t min_us;
+	uint32_t max_us;
+	uint32_t win_max_us;     /* worst since the previous refresh */
+	uint64_t sum_us;
+	uint32_t hist[SYSINFO_LAT_BUCKETS];
+};
+
+/* Kernel object kinds walked through CONFIG_OBJ_CORE */
+enum sysinfo_kobj_kind {
+	SYSINFO_KOBJ_SEM = 0,
+	SYSINFO_KOBJ_MUTEX,
+	SYSINFO_KOBJ_MSGQ,
+	SYSINFO_KOBJ_SLAB,
+	SYSINFO_KOBJ_KINDS,
+};
+
+/* Per-object snapshot.  level/limit are count/limit for a semaphore,
+ * lock depth for a mutex, used/max messages for a message queue and
+ * used/total blocks for a memory slab; peak is the highest level seen.
+ */
+struct sysinfo_kobj {
+	const void             *obj;
+	const char             *label;        /* NULL: shown by address */
+	const struct k_thread  *owner;        /* mutexes only */
+	uint32_t                level;
+	uint32_t                limit;
+	uint32_t                peak;
+	uint8_t                 kind;
+	uint8_t                 waiters;      /* threads pending now */
+	uint8_t                 max_waiters;
+};
+
+/* Aggregate system metrics */
+struct sysinfo_snapshot {
+	/* Timing */
+	uint32_t uptime_secs;
+	uint32_t uptime_ms;
+
+	/* Memory */
+	uint32_t heap_total;
+	uint32_t heap_used;
+	uint32_t heap_free;
+	uint32_t heap_max_used;
+
+	/* Threads */
+	uint8_t  thread_count;
+	struct sysinfo_thread threads[SYSINFO_MAX_THREADS];
+
+	/* CPU estimate (simple busy/idle ratio) */
+	uint8_t  cpu_load_pct;
+
+	/* Latency probes: timer ISR entry vs. programmed expiry, and
+	 * semaphore give -> high-priority thread running
+	 */
+	struct sysinfo_latency irq_lat;
+	struct sysinfo_latency wake_lat;
+
+	/* Kernel objects, a few re-read per refresh (see sysinfo.c) */
+	uint8_t  kobj_count;
+	uint8_t  kobj_untracked;  /* seen in the last pass without a slot */
+	uint16_t kobj_waiters;    /* threads pending across all objects */
+	uint32_t kobj_passes;     /* completed walks */
+	struct sysinfo_kobj kobjs[SYSINFO_MAX_KOBJS];
+
+	/* System work queue items waiting, sampled at each refresh */
+	uint16_t wq_backlog;
+	uint16_t wq_backlog_max;
+
+	/* Boot counter (persisted in RAM across soft resets if supported) */
+	uint32_t boot_count;
+
+	/* Firmware version */
+	uint8_t  fw_major;
+	uint8_t  fw_minor;
+	uint8_t  fw_patch;
+};
+
+void        sysinfo_get(struct sysinfo_snapshot *out);
+uint32_t    sysinfo_get_uptime_secs(void);
+uint8_t     sysinfo_get_thread_count(void);
+int         sysinfo_get_thread(int idx, struct sysinfo_thread *out);
+uint8_t     sysinfo_get_cpu_load(void);
+void        sysinfo_get_heap(uint32_t *used, uint32_t *total,
+			     uint32_t *peak);
+int         sysinfo_get_fw_version(char *buf, size_t buf_len);
+const char *sysinfo_get_board_name(void);
+void        sysinfo_lat_run(uint32_t samples);
+void        sysinfo_lat_continuous(uint32_t period_ms);
+void        sysinfo_lat_reset(void);
+void        sysinfo_kobj_label(const void *obj, const char *name);
+void        sysinfo_dump(void);
+int         sysinfo_format_json(char *buf, size_t buf_len);
+void        sysinfo_init(void);
+
+/* Name a kernel object after its symbol in kobj output */
+#define SYSINFO_KOBJ_LABEL(obj)   sysinfo_kobj_label(&(obj), #obj)
+
+extern const k_tid_t sysinfo_tid;
+
+#endif /* SHRIKE_SYSINFO_H */
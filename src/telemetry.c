@@ -0,0 +1,409 @@
+/*
+ * ShrikeOS Monitor — Send-on-Delta Telemetry
+ *
+ * Decides when a telemetry frame is worth sending.  Producers offer the
+ * state as soon as they change it (the sensor loop after each sample,
+ * the command parser after a setting), and a frame goes out at once if
+ * any field has moved past its deadband since the last frame sent.  The
+ * serial thread's periodic tick only covers the maximum silent
+ * interval, so a stable board costs one frame every few seconds instead
+ * of one per tick, while an excursion is reported without waiting for
+ * the next tick.
+ *
+ * Deadbands start from schema/telemetry.json and are changed at run
+ * time with 'deadband'.  Frames stay whole, so the decoders on the host
+ * need no change.
+ *
+ * Producers never block here: if a send is already in progress, or the
+ * transport is busy with a long write, their offer is skipped and the
+ * next tick compares against the same baseline.  A failed send forces
+ * the next offer through.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+#include <string.h>
+
+#include "command.h"
+#include "sysinfo.h"
+#include "telemetry.h"
+
+/* --------------------------------------------------------------------
+ * Configuration
+ * ------------------------------------------------------------------ */
+
+#define TELEM_SILENT_MIN_MS  TELEMETRY_PERIOD_MS
+#define TELEM_SILENT_MAX_MS  60000
+
+static const char *const telem_reason_names[] = {
+	[TELEM_SENT_DELTA]  = "delta",
+	[TELEM_SENT_SILENT] = "silent",
+	[TELEM_SENT_FORCED] = "forced",
+};
+
+/* --------------------------------------------------------------------
+ * State
+ * ------------------------------------------------------------------ */
+
+static telem_snapshot_fn telem_snapshot;
+static telem_send_fn     telem_send;
+
+/* Under telem_mutex */
+static uint32_t               telem_bands[TELEMETRY_FIELD_COUNT];
+static uint32_t               telem_silent_ms = TELEMETRY_MAX_SILENT_MS;
+static bool                   telem_enabled = true;
+static bool                   telem_resync = true;
+static struct telemetry_frame telem_last;        /* last frame sent */
+static int64_t                telem_last_ms;
+static struct telem_stats     telem_st;
+
+K_MUTEX_DEFINE(telem_mutex);
+
+/* --------------------------------------------------------------------
+ * Public API
+ * ------------------------------------------------------------------ */
+
+/**
+ * telem_offer — Send a frame if the current state calls for one.
+ *
+ * @param tick  true from the periodic tick, which may wait for the
+ *              transport and also sends after the max silent interval;
+ *              false from a producer that has just changed the state.
+ */
+void telem_offer(bool tick)
+{
+	k_timeout_t wait = tick ? K_FOREVER : K_NO_WAIT;
+	struct telemetry_frame f;
+	uint32_t moved = 0;
+	int reason = -1;
+
+	if (!telem_send || k_mutex_lock(&telem_mutex, wait) != 0) {
+		return;
+	}
+
+	if (tick) {
+		telem_st.ticks++;
+	} else {
+		telem_st.samples++;
+	}
+
+	telem_snapshot(&f);
+	int64_t now = k_uptime_get();
+
+	if (telem_resync) {
+		reason = TELEM_SENT_FORCED;
+	} else if (!telem_enabled) {
+		/* Filter off: one frame per tick, as before */
+		reason = tick ? TELEM_SENT_FORCED : -1;
+	} else {
+		for (int i = 0; i < TELEMETRY_FIELD_COUNT; i++) {
+			if (telem_bands[i] != TELEMETRY_NO_DEADBAND &&
+			    telemetry_field_delta(&f, &telem_last, i) >
+			    telem_bands[i]) {
+				moved |= BIT(i);
+			}
+		}
+		if (moved) {
+			reason = TELEM_SENT_DELTA;
+		} else if (tick && now - telem_last_ms >= telem_silent_ms) {
+			reason = TELEM_SENT_SILENT;
+		}
+	}
+
+	if (reason >= 0) {
+		if (telem_send(&f, wait) == 0) {
+			telem_last    = f;
+			telem_last_ms = now;
+			telem_resync  = false;
+			telem_st.sent[reason]++;
+			for (int i = 0; i < TELEMETRY_FIELD_COUNT; i++) {
+				if (moved & BIT(i)) {
+					telem_st.triggers[i]++;
+				}
+			}
+		} else {
+			telem_resync = true;
+			telem_st.failed++;
+		}
+	}
+
+	k_mutex_unlock(&telem_mutex);
+}
+
+/**
+ * telem_force — Send the next offer whatever it holds, e.g. after the
+ * wire format changed.
+ */
+void telem_force(void)
+{
+	k_mutex_lock(&telem_mutex, K_FOREVER);
+	telem_resync = true;
+	k_mutex_unlock(&telem_mutex);
+}
+
+/**
+ * telem_set_deadband — Set how far field @p field (schema order) must
+ * move, in wire units, before it triggers a frame.
+ *
+ * @param band  TELEMETRY_NO_DEADBAND: the field never triggers one.
+ * @return      0, or -EINVAL for an unknown field.
+ */
+int telem_set_deadband(int field, uint32_t band)
+{
+	if (field < 0 || field >= TELEMETRY_FIELD_COUNT) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&telem_mutex, K_FOREVER);
+	telem_bands[field] = band;
+	k_mutex_unlock(&telem_mutex);
+	return 0;
+}
+
+/**
+ * telem_read — Copy the current values, whether or not a frame is due.
+ *
+ * @return  0, or -ENODEV before telem_init().
+ */
+int telem_read(struct telemetry_frame *f)
+{
+	if (!telem_snapshot) {
+		return -ENODEV;
+	}
+	telem_snapshot(f);
+	return 0;
+}
+
+void telem_get_stats(struct telem_stats *out)
+{
+	k_mutex_lock(&telem_mutex, K_FOREVER);
+	memcpy(out, &telem_st, sizeof(*out));
+	k_mutex_unlock(&telem_mutex);
+}
+
+/* --------------------------------------------------------------------
+ * Commands
+ * ------------------------------------------------------------------ */
+
+static uint32_t telem_pow10(uint8_t decimals)
+{
+	uint32_t p = 1;
+
+	while (decimals--) {
+		p *= 10;
+	}
+	return p;
+}
+
+static int telem_find_field(const char *name)
+{
+	for (int i = 0; i < TELEMETRY_FIELD_COUNT; i++) {
+		if (strcmp(telemetry_fields[i].key, name) == 0) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+/*
+ * A deadband in the field's own units ("5", "0.5") to wire units, or
+ * "off" for none.  At most @p decimals digits after the point.
+ */
+static int telem_parse_band(const struct cmd_arg *a, uint8_t decimals,
+			    uint32_t *out)
+{
+	uint32_t v = 0;
+	int frac = -1;
+
+	if (a->type == CMD_ARG_BOOL && !a->bval) {
+		*out = TELEMETRY_NO_DEADBAND;
+		return 0;
+	}
+	if (a->type == CMD_ARG_INT) {
+		if (a->ival < 0 || a->ival > 100000) {
+			return -EINVAL;
+		}
+		*out = (uint32_t)a->ival * telem_pow10(decimals);
+		return 0;
+	}
+	if (a->type != CMD_ARG_STRING) {
+		return -EINVAL;
+	}
+
+	for (const char *p = a->sval; *p; p++) {
+		if (*p == '.' && frac < 0) {
+			frac = 0;
+			continue;
+		}
+		if (*p < '0' || *p > '9' || frac >= decimals ||
+		    v > 100000) {
+			return -EINVAL;
+		}
+		v = v * 10 + (uint32_t)(*p - '0');
+		if (frac >= 0) {
+			frac++;
+		}
+	}
+	if (frac <= 0) {
+		return -EINVAL;        /* no digits after the point */
+	}
+	*out = v * telem_pow10(decimals - frac);
+	return 0;
+}
+
+static void telem_print(struct cmd_session *sess)
+{
+	uint32_t bands[TELEMETRY_FIELD_COUNT];
+	struct telem_stats st;
+	uint32_t silent_ms;
+	bool enabled;
+
+	k_mutex_lock(&telem_mutex, K_FOREVER);
+	memcpy(bands, telem_bands, sizeof(bands));
+	memcpy(&st, &telem_st, sizeof(st));
+	silent_ms = telem_silent_ms;
+	enabled   = telem_enabled;
+	k_mutex_unlock(&telem_mutex);
+
+	cmd_print(sess, "Send-on-delta: %s | max silent %u ms | tick %d ms\n",
+		  enabled ? "on" : "off", silent_ms, TELEMETRY_PERIOD_MS);
+	cmd_print(sess, "%-8s %10s %8s\n", "Field", "Deadband", "Triggers");
+	for (int i = 0; i < TELEMETRY_FIELD_COUNT; i++) {
+		const struct json_field *jf = &telemetry_fields[i];
+		uint32_t p = telem_pow10(jf->decimals);
+
+		if (bands[i] == TELEMETRY_NO_DEADBAND) {
+			cmd_print(sess, "%-8s %10s %8u\n", jf->key, "off",
+				  st.triggers[i]);
+		} else if (p > 1) {
+			cmd_print(sess, "%-8s %*u.%0*u %8u\n", jf->key,
+				  9 - jf->decimals, bands[i] / p,
+				  jf->decimals, bands[i] % p, st.triggers[i]);
+		} else {
+			cmd_print(sess, "%-8s %10u %8u\n", jf->key, bands[i],
+				  st.triggers[i]);
+		}
+	}
+
+	uint32_t sent = 0;
+
+	for (int i = 0; i < TELEM_REASON_COUNT; i++) {
+		sent += st.sent[i];
+	}
+	cmd_print(sess, "Offers: %u samples, %u ticks | failed %u\n",
+		  st.samples, st.ticks, st.failed);
+	cmd_print(sess, "Sent  : %u (%s %u, %s %u, %s %u), %u%% of ticks\n",
+		  sent, telem_reason_names[TELEM_SENT_DELTA],
+		  st.sent[TELEM_SENT_DELTA],
+		  telem_reason_names[TELEM_SENT_SILENT],
+		  st.sent[TELEM_SENT_SILENT],
+		  telem_reason_names[TELEM_SENT_FORCED],
+		  st.sent[TELEM_SENT_FORCED],
+		  st.ticks ? sent * 100 / st.ticks : 0);
+}
+
+/*
+ * 'deadband'                       settings and counters
+ * 'deadband <field> <value|off>'   in the field's units, e.g. temp 0.5
+ * 'deadband silent <ms>'           max interval between frames
+ * 'deadband on|off'                off: a frame every tick
+ * 'deadband reset'                 schema defaults
+ */
+static int telem_cmd_handler(struct cmd_session *sess,
+			     int argc, struct cmd_arg *argv)
+{
+	if (argc == 0) {
+		telem_print(sess);
+		return 0;
+	}
+
+	if (argc == 1 && argv[0].type == CMD_ARG_BOOL) {
+		k_mutex_lock(&telem_mutex, K_FOREVER);
+		telem_enabled = argv[0].bval;
+		telem_resync  = true;
+		k_mutex_unlock(&telem_mutex);
+		cmd_print(sess, "Send-on-delta %s\n",
+			  argv[0].bval ? "on" : "off");
+		return 0;
+	}
+
+	if (argv[0].type != CMD_ARG_STRING) {
+		goto usage;
+	}
+
+	if (argc == 1 && strcmp(argv[0].sval, "reset") == 0) {
+		k_mutex_lock(&telem_mutex, K_FOREVER);
+		memcpy(telem_bands, telemetry_deadbands, sizeof(telem_bands));
+		telem_silent_ms = TELEMETRY_MAX_SILENT_MS;
+		k_mutex_unlock(&telem_mutex);
+		cmd_print(sess, "Deadbands reset to schema defaults\n");
+		return 0;
+	}
+
+	if (argc != 2) {
+		goto usage;
+	}
+
+	if (strcmp(argv[0].sval, "silent") == 0) {
+		if (argv[1].type != CMD_ARG_INT ||
+		    argv[1].ival < TELEM_SILENT_MIN_MS ||
+		    argv[1].ival > TELEM_SILENT_MAX_MS) {
+			cmd_print(sess, "Max silent interval must be %d..%d ms\n",
+				  TELEM_SILENT_MIN_MS, TELEM_SILENT_MAX_MS);
+			return -1;
+		}
+		k_mutex_lock(&telem_mutex, K_FOREVER);
+		telem_silent_ms = (uint32_t)argv[1].ival;
+		k_mutex_unlock(&telem_mutex);
+		cmd_print(sess, "Max silent interval %d ms\n", argv[1].ival);
+		return 0;
+	}
+
+	int field = telem_find_field(argv[0].sval);
+	uint32_t band;
+
+	if (field < 0) {
+		cmd_print(sess, "Unknown field '%s'\n", argv[0].sval);
+		return -1;
+	}
+	if (telem_parse_band(&argv[1], telemetry_fields[field].decimals,
+			     &band) < 0) {
+		cmd_print(sess, "Bad deadband for %s (at most %u decimals)\n",
+			  argv[0].sval, telemetry_fields[field].decimals);
+		return -1;
+	}
+	telem_set_deadband(field, band);
+	telem_print(sess);
+	return 0;
+
+usage:
+	cmd_print(sess, "Usage: deadband [<field> <value|off> | silent <ms> "
+		  "| on | off | reset]\n");
+	return -1;
+}
+
+/**
+ * telem_init — Start filtering with the schema's deadbands and register
+ * the 'deadband' command.  Call after cmd_init(), before any producer
+ * offers a sample.
+ *
+ * @param snapshot  Copies the current state into a frame.
+ * @param send      Encodes and queues a frame.
+ */
+void telem_init(telem_snapshot_fn snapshot, telem_send_fn send)
+{
+	memcpy(telem_bands, telemetry_deadbands, sizeof(telem_bands));
+	telem_snapshot = snapshot;
+	telem_send     = send;
+
+	if (cmd_register("deadband", "Send-on-delta telemetry deadbands",
+			 "deadband [<field> <value|off> | silent <ms> | on | "
+			 "off | reset]", telem_cmd_handler, 0, 2) != 0) {
+		printk("[TELEM] No 'deadband' command, schema deadbands "
+		       "are fixed\n");
+	}
+
+	SYSINFO_KOBJ_LABEL(telem_mutex);
+}
@@ -0,0 +1,44 @@
+/*
+ * ShrikeOS Monitor — Send-on-Delta Telemetry
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SHRIKE_TELEMETRY_H
+#define SHRIKE_TELEMETRY_H
+
+#include <zephyr/kernel.h>
+
+#include "telemetry_schema.h"
+
+/* Why a frame was sent */
+enum telem_reason {
+	TELEM_SENT_DELTA = 0,    /* a field moved past its deadband     */
+	TELEM_SENT_SILENT,       /* max silent interval reached         */
+	TELEM_SENT_FORCED,       /* first frame, resync or filter off   */
+	TELEM_REASON_COUNT,
+};
+
+struct telem_stats {
+	uint32_t samples;                       /* offered by producers   */
+	uint32_t ticks;                         /* periodic checks        */
+	uint32_t sent[TELEM_REASON_COUNT];
+	uint32_t failed;                        /* no frame or no link    */
+	uint32_t triggers[TELEMETRY_FIELD_COUNT];
+};
+
+/* Copy the current values; encode and queue a frame, waiting at most
+ * @p timeout for the transport (0 or -errno)
+ */
+typedef void (*telem_snapshot_fn)(struct telemetry_frame *f);
+typedef int  (*telem_send_fn)(const struct telemetry_frame *f,
+			      k_timeout_t timeout);
+
+void telem_offer(bool tick);
+void telem_force(void);
+int  telem_set_deadband(int field, uint32_t band);
+int  telem_read(struct telemetry_frame *f);
+void telem_get_stats(struct telem_stats *out);
+void telem_init(telem_snapshot_fn snapshot, telem_send_fn send);
+
+#endif /* SHRIKE_TELEMETRY_H */
@@ -6,6 +6,18 @@
  * timeout, the watchdog flags it as unresponsive and invokes the
  * registered recovery callback.
  *
+ * Threads can also bracket each loop iteration with wdg_begin() and
+ * wdg_end().  The execution time is then tracked per slot (last, max,
+ * average and a log2 histogram) and checked against an optional budget,
+ * so a loop that still heartbeats but has slowed down shows up as
+ * BUDGET_EXCEEDED long before it would time out.
+ *
+ * In adaptive mode a slot's warning and timeout thresholds are derived
+ * from the observed heartbeat intervals instead of the fixed timeout:
+ * intervals go into a log histogram with four sub-buckets per octave,
+ * and once enough samples are in, warning and timeout become fixed
+ * multiples of the estimated p99, clamped to the slot's bounds.
+ *
  * SPDX-License-Identifier: Apache-2.0
  */
 
@@ -14,24 +26,31 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "command.h"
+#include "json.h"
+#include "logger.h"
+#include "periodic.h"
+#include "sysinfo.h"
+#include "watchdog.h"
+
 /* --------------------------------------------------------------------
  * Configuration
  * ------------------------------------------------------------------ */
 
 #define WDG_MAX_THREADS        8
-#define WDG_CHECK_INTERVAL_MS  1000
+#define WDG_CHECK_INTERVAL_MS  250
+#define WDG_WARN_PCT           75     /* fixed mode: warning at 75%   */
+
+/* Adaptive mode */
+#define WDG_ADAPT_SUB_BITS     2      /* 4 sub-buckets per octave     */
+#define WDG_ADAPT_BUCKETS      52     /* up to ~16 s, rest clamped    */
+#define WDG_ADAPT_MIN_SAMPLES  32     /* fixed timeout until then     */
+#define WDG_ADAPT_WINDOW       1024   /* halve counts when reached    */
+#define WDG_ADAPT_WARN_X4      6      /* warning  = 1.5 x p99         */
+#define WDG_ADAPT_TIMEOUT_X4   8      /* timeout  = 2.0 x p99         */
 #define WDG_STACK_SIZE         1024
 #define WDG_PRIORITY           8
 
-/* Thread health states reported by the watchdog */
-enum wdg_thread_state {
-	WDG_STATE_IDLE = 0,    /* Registered, not yet started        */
-	WDG_STATE_HEALTHY,     /* Heartbeat received within timeout   */
-	WDG_STATE_WARNING,     /* Approaching timeout (>75% elapsed)  */
-	WDG_STATE_UNRESPONSIVE,/* Timed out — recovery pending        */
-	WDG_STATE_RECOVERED,   /* Recovery callback executed           */
-};
-
 /* Human-readable names for each state (used by status dump) */
 static const char *const wdg_state_names[] = {
 	[WDG_STATE_IDLE]         = "IDLE",
@@ -39,14 +58,19 @@ static const char *const wdg_state_names[] = {
 	[WDG_STATE_WARNING]      = "WARNING",
 	[WDG_STATE_UNRESPONSIVE] = "UNRESPONSIVE",
 	[WDG_STATE_RECOVERED]    = "RECOVERED",
+	[WDG_STATE_BUDGET_EXCEEDED] = "OVER_BUDGET",
 };
 
-/* Callback invoked when a thread becomes unresponsive.
- * The callback receives the thread name and the elapsed time in ms
- * since the last heartbeat was received.
- */
-typedef void (*wdg_recovery_cb_t)(const char *thread_name,
-				  uint32_t elapsed_ms);
+/* Structured log events */
+SHRIKE_LOG_EVENT_DEFINE(wdg_warning, LOG_EV_WDG_WARNING,
+			LOG_KV("thread", STR));
+SHRIKE_LOG_EVENT_DEFINE(wdg_timeout, LOG_EV_WDG_TIMEOUT,
+			LOG_KV("thread", STR),
+			LOG_KV("elapsed_ms", U32));
+SHRIKE_LOG_EVENT_DEFINE(wdg_over_budget, LOG_EV_WDG_OVER_BUDGET,
+			LOG_KV("thread", STR),
+			LOG_KV("us", U32),
+			LOG_KV("budget_us", U32));
 
 /* Internal bookkeeping for a single monitored thread */
 struct wdg_entry {
@@ -56,9 +80,25 @@ struct wdg_entry {
 	int64_t       last_heartbeat;
 	enum wdg_thread_state state;
 	wdg_recovery_cb_t     recovery_cb;
+	wdg_revive_cb_t       revive_cb;
 	uint32_t      heartbeat_count;
 	uint32_t      timeout_count;
 	uint32_t      recovery_count;
+	bool          in_iteration;
+	uint32_t      begin_cyc;
+	struct wdg_exec_stats exec;
+
+	/* Adaptive thresholds; warn_ms/eff_timeout_ms are what the checker
+	 * uses in either mode.
+	 */
+	bool          adaptive;
+	uint32_t      adapt_min_ms;
+	uint32_t      adapt_max_ms;
+	uint32_t      warn_ms;
+	uint32_t      eff_timeout_ms;
+	uint32_t      p99_ms;
+	uint16_t      interval_count;
+	uint16_t      interval_hist[WDG_ADAPT_BUCKETS];
 };
 
 /* Registry of all monitored threads */
@@ -76,9 +116,108 @@ static struct wdg_stats {
 	uint32_t total_heartbeats;
 	uint32_t total_timeouts;
 	uint32_t total_recoveries;
+	uint32_t total_overruns;
 	uint32_t checks_performed;
 } wdg_stats;
 
+/* --------------------------------------------------------------------
+ * Adaptive thresholds
+ * ------------------------------------------------------------------ */
+
+/* Log-linear bucket: exact below 4 ms, then 4 steps per octave */
+static int wdg_interval_bucket(uint32_t ms)
+{
+	const uint32_t sub = BIT(WDG_ADAPT_SUB_BITS);
+
+	if (ms < sub) {
+		return (int)ms;
+	}
+
+	int msb = 31 - __builtin_clz(ms);
+	int idx = (msb - WDG_ADAPT_SUB_BITS + 1) * sub +
+		  ((ms >> (msb - WDG_ADAPT_SUB_BITS)) & (sub - 1));
+
+	return MIN(idx, WDG_ADAPT_BUCKETS - 1);
+}
+
+/* Exclusive upper bound of a bucket, in ms */
+static uint32_t wdg_bucket_upper(int idx)
+{
+	const uint32_t sub = BIT(WDG_ADAPT_SUB_BITS);
+
+	if (idx < (int)sub) {
+		return (uint32_t)idx + 1;
+	}
+
+	int shift = idx / sub - 1;
+
+	return (sub + idx % sub + 1) << shift;
+}
+
+/* Caller holds wdg_mutex */
+static void wdg_record_interval(struct wdg_entry *e, uint32_t ms)
+{
+	e->interval_hist[wdg_interval_bucket(ms)]++;
+
+	/* Halve the history so the estimate follows slow drifts */
+	if (++e->interval_count >= WDG_ADAPT_WINDOW) {
+		e->interval_count = 0;
+		for (int b = 0; b < WDG_ADAPT_BUCKETS; b++) {
+			e->interval_hist[b] /= 2;
+			e->interval_count += e->interval_hist[b];
+		}
+	}
+}
+
+/* Caller holds wdg_mutex.  Recompute warn/timeout from the p99. */
+static void wdg_update_thresholds(struct wdg_entry *e)
+{
+	if (!e->adaptive || e->interval_count < WDG_ADAPT_MIN_SAMPLES) {
+		return;
+	}
+
+	uint32_t need = e->interval_count -
+			e->interval_count / 100;  /* ceil(99%) */
+	uint32_t cum = 0;
+	int b;
+
+	for (b = 0; b < WDG_ADAPT_BUCKETS - 1; b++) {
+		cum += e->interval_hist[b];
+		if (cum >= need) {
+			break;
+		}
+	}
+
+	e->p99_ms = wdg_bucket_upper(b);
+	e->eff_timeout_ms = CLAMP(e->p99_ms * WDG_ADAPT_TIMEOUT_X4 / 4,
+				  e->adapt_min_ms, e->adapt_max_ms);
+	e->warn_ms = MIN(e->p99_ms * WDG_ADAPT_WARN_X4 / 4,
+			 e->eff_timeout_ms * WDG_WARN_PCT / 100);
+}
+
+/* Caller holds wdg_mutex.  Common part of every liveness signal;
+ * returns true if the slot had been declared unresponsive.
+ */
+static bool wdg_beat(struct wdg_entry *e)
+{
+	int64_t now = k_uptime_get();
+	bool revived = (e->state == WDG_STATE_UNRESPONSIVE ||
+			e->state == WDG_STATE_RECOVERED);
+
+	/* A gap that already tripped the timeout is a fault, not a sample */
+	if (e->adaptive && e->heartbeat_count > 0 &&
+	    e->state != WDG_STATE_UNRESPONSIVE &&
+	    e->state != WDG_STATE_RECOVERED) {
+		wdg_record_interval(e, (uint32_t)MIN(now - e->last_heartbeat,
+						     (int64_t)UINT32_MAX));
+	}
+
+	e->last_heartbeat = now;
+	e->heartbeat_count++;
+	wdg_stats.total_heartbeats++;
+	return revived;
+}
+
 /* --------------------------------------------------------------------
  * Public API
  * ------------------------------------------------------------------ */
@@ -118,6 +257,8 @@ int wdg_register(const char *name, uint32_t timeout_ms,
 	e->heartbeat_count  = 0;
 	e->timeout_count    = 0;
 	e->recovery_count   = 0;
+	e->eff_timeout_ms   = timeout_ms;
+	e->warn_ms          = timeout_ms * WDG_WARN_PCT / 100;
 
 	printk("[WDG] Registered '%s' (slot %d, timeout %u ms)\n",
 	       name, slot, timeout_ms);
@@ -137,19 +278,205 @@ void wdg_heartbeat(int slot)
 		return;
 	}
 
+	wdg_revive_cb_t revive = NULL;
+
 	k_mutex_lock(&wdg_mutex, K_FOREVER);
 
 	struct wdg_entry *e = &wdg_table[slot];
 	if (e->active) {
-		e->last_heartbeat  = k_uptime_get();
-		e->state           = WDG_STATE_HEALTHY;
-		e->heartbeat_count++;
-		wdg_stats.total_heartbeats++;
+		if (wdg_beat(e)) {
+			revive = e->revive_cb;
+		}
+		e->state = WDG_STATE_HEALTHY;
+	}
+
+	k_mutex_unlock(&wdg_mutex);
+
+	if (revive) {
+		revive(e->name);
+	}
+}
+
+/**
+ * wdg_set_revive_cb — Get notified when an unresponsive slot reports
+ * again (e.g. to time a restart).
+ */
+void wdg_set_revive_cb(int slot, wdg_revive_cb_t cb)
+{
+	if (slot < 0 || slot >= WDG_MAX_THREADS) {
+		return;
 	}
 
+	k_mutex_lock(&wdg_mutex, K_FOREVER);
+	wdg_table[slot].revive_cb = cb;
+	k_mutex_unlock(&wdg_mutex);
+}
+
+/**
+ * wdg_set_budget — Set the per-iteration execution budget of a slot.
+ *
+ * @param slot       Slot index returned by wdg_register().
+ * @param budget_us  Longest acceptable wdg_begin()..wdg_end() time;
+ *                   0 disables the check (times are still recorded).
+ */
+void wdg_set_budget(int slot, uint32_t budget_us)
+{
+	if (slot < 0 || slot >= WDG_MAX_THREADS) {
+		return;
+	}
+
+	k_mutex_lock(&wdg_mutex, K_FOREVER);
+	wdg_table[slot].exec.budget_us = budget_us;
+	k_mutex_unlock(&wdg_mutex);
+}
+
+/**
+ * wdg_set_adaptive — Derive a slot's thresholds from its heartbeat
+ * intervals.
+ *
+ * Until WDG_ADAPT_MIN_SAMPLES intervals are seen the registered timeout
+ * applies; after that timeout = 2 x p99 and warning = 1.5 x p99, with
+ * the timeout clamped to [@p min_ms, @p max_ms].
+ */
+void wdg_set_adaptive(int slot, uint32_t min_ms, uint32_t max_ms)
+{
+	if (slot < 0 || slot >= WDG_MAX_THREADS || min_ms > max_ms) {
+		return;
+	}
+
+	k_mutex_lock(&wdg_mutex, K_FOREVER);
+	struct wdg_entry *e = &wdg_table[slot];
+
+	e->adaptive     = true;
+	e->adapt_min_ms = min_ms;
+	e->adapt_max_ms = max_ms;
+	k_mutex_unlock(&wdg_mutex);
+}
+
+/**
+ * wdg_adaptive_reset — Forget the learned interval distribution.
+ *
+ * Call when the loop's period is changed on purpose (e.g. a new blink
+ * rate); the slot falls back to its bound until it has re-learned.
+ */
+void wdg_adaptive_reset(int slot)
+{
+	if (slot < 0 || slot >= WDG_MAX_THREADS) {
+		return;
+	}
+
+	k_mutex_lock(&wdg_mutex, K_FOREVER);
+	struct wdg_entry *e = &wdg_table[slot];
+
+	if (e->adaptive) {
+		memset(e->interval_hist, 0, sizeof(e->interval_hist));
+		e->interval_count = 0;
+		e->p99_ms         = 0;
+		e->eff_timeout_ms = MAX(e->timeout_ms, e->adapt_max_ms);
+		e->warn_ms        = e->eff_timeout_ms * WDG_WARN_PCT / 100;
+	}
 	k_mutex_unlock(&wdg_mutex);
 }
 
+/**
+ * wdg_begin — Mark the start of one loop iteration.
+ *
+ * Only the owning thread touches the start stamp, so no lock is taken.
+ */
+void wdg_begin(int slot)
+{
+	if (slot < 0 || slot >= WDG_MAX_THREADS) {
+		return;
+	}
+
+	wdg_table[slot].begin_cyc    = k_cycle_get_32();
+	wdg_table[slot].in_iteration = true;
+}
+
+/**
+ * wdg_end — Mark the end of an iteration started by wdg_begin().
+ *
+ * Records the execution time and counts as a heartbeat.  An iteration
+ * longer than the slot's budget moves it to BUDGET_EXCEEDED; the next
+ * iteration within budget returns it to HEALTHY.
+ */
+void wdg_end(int slot)
+{
+	if (slot < 0 || slot >= WDG_MAX_THREADS) {
+		return;
+	}
+
+	struct wdg_entry *e = &wdg_table[slot];
+	wdg_revive_cb_t revive = NULL;
+
+	if (!e->in_iteration) {
+		return;
+	}
+
+	uint32_t us = k_cyc_to_us_floor32(k_cycle_get_32() - e->begin_cyc);
+	int bucket = MIN(31 - __builtin_clz(us | 1), WDG_HIST_BUCKETS - 1);
+
+	e->in_iteration = false;
+
+	k_mutex_lock(&wdg_mutex, K_FOREVER);
+
+	if (e->active) {
+		struct wdg_exec_stats *x = &e->exec;
+
+		x->iterations++;
+		x->last_us = us;
+		x->max_us  = MAX(x->max_us, us);
+		x->sum_us += us;
+		x->hist[bucket]++;
+
+		if (wdg_beat(e)) {
+			revive = e->revive_cb;
+		}
+
+		if (x->budget_us && us > x->budget_us) {
+			x->overruns++;
+			wdg_stats.total_overruns++;
+			if (e->state != WDG_STATE_BUDGET_EXCEEDED) {
+				SHRIKE_LOG_KV(LOG_LVL_WARN, "WDG",
+					      wdg_over_budget, e->name, us,
+					      x->budget_us);
+			}
+			e->state = WDG_STATE_BUDGET_EXCEEDED;
+		} else {
+			e->state = WDG_STATE_HEALTHY;
+		}
+	}
+
+	k_mutex_unlock(&wdg_mutex);
+
+	if (revive) {
+		revive(e->name);
+	}
+}
+
+/**
+ * wdg_get_exec_stats — Copy the execution-time statistics of a slot.
+ *
+ * @return  0 on success, -EINVAL for an unused slot.
+ */
+int wdg_get_exec_stats(int slot, struct wdg_exec_stats *out)
+{
+	int ret = -EINVAL;
+
+	if (slot < 0 || slot >= WDG_MAX_THREADS) {
+		return ret;
+	}
+
+	k_mutex_lock(&wdg_mutex, K_FOREVER);
+	if (wdg_table[slot].active) {
+		memcpy(out, &wdg_table[slot].exec, sizeof(*out));
+		ret = 0;
+	}
+	k_mutex_unlock(&wdg_mutex);
+
+	return ret;
+}
+
 /**
  * wdg_unregister — Remove a thread from monitoring.
  *
@@ -234,6 +561,24 @@ int wdg_get_healthy_count(void)
 	return count;
 }
 
+/**
+ * wdg_get_active_count — Return how many threads are being monitored.
+ */
+int wdg_get_active_count(void)
+{
+	int count = 0;
+
+	k_mutex_lock(&wdg_mutex, K_FOREVER);
+	for (int i = 0; i < wdg_count; i++) {
+		if (wdg_table[i].active) {
+			count++;
+		}
+	}
+	k_mutex_unlock(&wdg_mutex);
+
+	return count;
+}
+
 /**
  * wdg_dump_status — Print the full watchdog status table to the console.
  */
@@ -243,29 +588,32 @@ void wdg_dump_status(void)
 
 	printk("\n=== Watchdog Status ===\n");
 	printk("Global: %s | Checks: %u | Heartbeats: %u | "
-	       "Timeouts: %u | Recoveries: %u\n",
+	       "Timeouts: %u | Recoveries: %u | Overruns: %u\n",
 	       wdg_enabled ? "ENABLED" : "DISABLED",
 	       wdg_stats.checks_performed,
 	       wdg_stats.total_heartbeats,
 	       wdg_stats.total_timeouts,
-	       wdg_stats.total_recoveries);
-	printk("%-4s %-20s %-14s %-10s %-6s %-6s\n",
+	       wdg_stats.total_recoveries,
+	       wdg_stats.total_overruns);
+	printk("%-4s %-20s %-14s %-10s %-6s %-6s %-10s %-6s\n",
 	       "Slot", "Name", "State", "Timeout",
-	       "Beats", "Fails");
+	       "Beats", "Fails", "Budget us", "Over");
 	printk("---- -------------------- -------------- "
-	       "---------- ------ ------\n");
+	       "---------- ------ ------ ---------- ------\n");
 
 	for (int i = 0; i < wdg_count; i++) {
 		const struct wdg_entry *e = &wdg_table[i];
 		if (!e->active) {
 			continue;
 		}
-		printk("%-4d %-20s %-14s %-10u %-6u %-6u\n",
+		printk("%-4d %-20s %-14s %-10u %-6u %-6u %-10u %-6u\n",
 		       i, e->name,
 		       wdg_get_state_name(e->state),
-		       e->timeout_ms,
+		       e->eff_timeout_ms,
 		       e->heartbeat_count,
-		       e->timeout_count);
+		       e->timeout_count,
+		       e->exec.budget_us,
+		       e->exec.overruns);
 	}
 
 	printk("=======================\n\n");
@@ -273,6 +621,58 @@ void wdg_dump_status(void)
 	k_mutex_unlock(&wdg_mutex);
 }
 
+/**
+ * wdg_format_json — Serialise the global counters and each slot's state.
+ *
+ * @return  Length written, or -ENOMEM if @p buf was too small.
+ */
+int wdg_format_json(char *buf, size_t buf_len)
+{
+	struct json_writer w;
+
+	json_init(&w, buf, buf_len);
+	json_obj_begin(&w);
+
+	k_mutex_lock(&wdg_mutex, K_FOREVER);
+	json_key(&w, "enabled");
+	json_bool(&w, wdg_enabled);
+	json_key(&w, "timeouts");
+	json_u32(&w, wdg_stats.total_timeouts);
+	json_key(&w, "recoveries");
+	json_u32(&w, wdg_stats.total_recoveries);
+	json_key(&w, "overruns");
+	json_u32(&w, wdg_stats.total_overruns);
+
+	json_key(&w, "slots");
+	json_arr_begin(&w);
+	for (int i = 0; i < wdg_count; i++) {
+		const struct wdg_entry *e = &wdg_table[i];
+
+		if (!e->active) {
+			continue;
+		}
+		json_obj_begin(&w);
+		json_key(&w, "name");
+		json_str(&w, e->name);
+		json_key(&w, "state");
+		json_str(&w, wdg_get_state_name(e->state));
+		json_key(&w, "timeout_ms");
+		json_u32(&w, e->eff_timeout_ms);
+		json_key(&w, "beats");
+		json_u32(&w, e->heartbeat_count);
+		json_key(&w, "fails");
+		json_u32(&w, e->timeout_count);
+		json_key(&w, "over");
+		json_u32(&w, e->exec.overruns);
+		json_obj_end(&w);
+	}
+	k_mutex_unlock(&wdg_mutex);
+
+	json_arr_end(&w);
+	json_obj_end(&w);
+	return json_finish(&w);
+}
+
 /* Default recovery handler used when no callback is provided */
 static void wdg_default_recovery(const char *name, uint32_t elapsed_ms)
 {
@@ -298,11 +698,16 @@ static void wdg_checker_fn(void *p1, void *p2, void *p3)
 	ARG_UNUSED(p2);
 	ARG_UNUSED(p3);
 
+	static struct periodic_task wdg_task =
+		PERIODIC_TASK_INIT("watchdog", WDG_CHECK_INTERVAL_MS);
+
 	printk("[WDG] Watchdog checker thread started "
 	       "(interval %d ms)\n", WDG_CHECK_INTERVAL_MS);
 
+	periodic_start(&wdg_task);
+
 	while (1) {
-		k_msleep(WDG_CHECK_INTERVAL_MS);
+		periodic_next(&wdg_task);
 
 		k_mutex_lock(&wdg_mutex, K_FOREVER);
 
@@ -320,9 +725,11 @@ static void wdg_checker_fn(void *p1, void *p2, void *p3)
 				continue;
 			}
 
+			wdg_update_thresholds(e);
+
 			int64_t elapsed = now - e->last_heartbeat;
 
-			if (elapsed > (int64_t)e->timeout_ms) {
+			if (elapsed > (int64_t)e->eff_timeout_ms) {
 				/* Full timeout reached */
 				if (e->state != WDG_STATE_UNRESPONSIVE &&
 				    e->state != WDG_STATE_RECOVERED) {
@@ -330,9 +737,9 @@ static void wdg_checker_fn(void *p1, void *p2, void *p3)
 					e->timeout_count++;
 					wdg_stats.total_timeouts++;
 
-					printk("[WDG] '%s' UNRESPONSIVE "
-					       "(%lld ms elapsed)\n",
-					       e->name, elapsed);
+					SHRIKE_LOG_KV(LOG_LVL_ERROR, "WDG",
+						      wdg_timeout, e->name,
+						      (uint32_t)elapsed);
 
 					wdg_recovery_cb_t cb = e->recovery_cb;
 					const char *ename = e->name;
@@ -350,17 +757,21 @@ static void wdg_checker_fn(void *p1, void *p2, void *p3)
 
 					k_mutex_lock(&wdg_mutex, K_FOREVER);
 
-					e->state = WDG_STATE_RECOVERED;
+					/* A restarted thread may already have
+					 * reported in during the callback
+					 */
+					if (e->state == WDG_STATE_UNRESPONSIVE) {
+						e->state = WDG_STATE_RECOVERED;
+					}
 					e->recovery_count++;
 					wdg_stats.total_recoveries++;
 				}
-			} else if (elapsed >
-				   (int64_t)(e->timeout_ms * 3 / 4)) {
-				/* 75% threshold → warning zone */
+			} else if (elapsed > (int64_t)e->warn_ms) {
+				/* 75% of the timeout, or 1.5 x p99 → warning */
 				if (e->state == WDG_STATE_HEALTHY) {
 					e->state = WDG_STATE_WARNING;
-					printk("[WDG] '%s' entering "
-					       "WARNING zone\n", e->name);
+					SHRIKE_LOG_KV(LOG_LVL_WARN, "WDG",
+						      wdg_warning, e->name);
 				}
 			}
 		}
@@ -372,3 +783,112 @@ static void wdg_checker_fn(void *p1, void *p2, void *p3)
 K_THREAD_DEFINE(wdg_checker_tid, WDG_STACK_SIZE,
 		wdg_checker_fn, NULL, NULL, NULL,
 		WDG_PRIORITY, 0, 0);
+
+/* --------------------------------------------------------------------
+ * Commands
+ * ------------------------------------------------------------------ */
+
+static void wdg_print_hist(struct cmd_session *sess,
+			   const struct wdg_exec_stats *x)
+{
+	uint32_t peak = 1;
+
+	for (int b = 0; b < WDG_HIST_BUCKETS; b++) {
+		peak = MAX(peak, x->hist[b]);
+	}
+
+	for (int b = 0; b < WDG_HIST_BUCKETS; b++) {
+		char bar[33];
+		int n;
+
+		if (!x->hist[b]) {
+			continue;
+		}
+		n = (int)((uint64_t)x->hist[b] * 32 / peak);
+		memset(bar, '#', n);
+		bar[n] = '\0';
+
+		if (b == WDG_HIST_BUCKETS - 1) {
+			cmd_print(sess, "  >=%-7u us %8u %s\n",
+				  (uint32_t)BIT(b), x->hist[b], bar);
+		} else {
+			cmd_print(sess, "  <%-8u us %8u %s\n",
+				  (uint32_t)BIT(b + 1), x->hist[b], bar);
+		}
+	}
+}
+
+static int wdg_cmd_handler(struct cmd_session *sess,
+			   int argc, struct cmd_arg *argv)
+{
+	if (argc == 1) {
+		struct wdg_exec_stats x;
+		int slot = argv[0].ival;
+
+		if (argv[0].type != CMD_ARG_INT ||
+		    wdg_get_exec_stats(slot, &x) != 0) {
+			cmd_print(sess, "No such slot\n");
+			return -1;
+		}
+
+		cmd_print(sess, "\n'%s': %u iterations, budget %u us, "
+			  "%u overruns\n", wdg_table[slot].name,
+			  x.iterations, x.budget_us, x.overruns);
+		cmd_print(sess, "last %u us | max %u us | avg %u us\n",
+			  x.last_us, x.max_us,
+			  x.iterations ? (uint32_t)(x.sum_us / x.iterations) : 0);
+		k_mutex_lock(&wdg_mutex, K_FOREVER);
+		const struct wdg_entry *e = &wdg_table[slot];
+		if (e->adaptive) {
+			cmd_print(sess, "adaptive: p99 %u ms (%u samples) -> "
+				  "warn %u / timeout %u ms, bounds %u..%u\n",
+				  e->p99_ms, e->interval_count, e->warn_ms,
+				  e->eff_timeout_ms, e->adapt_min_ms,
+				  e->adapt_max_ms);
+		} else {
+			cmd_print(sess, "fixed: warn %u / timeout %u ms\n",
+				  e->warn_ms, e->eff_timeout_ms);
+		}
+		k_mutex_unlock(&wdg_mutex);
+		wdg_print_hist(sess, &x);
+		return 0;
+	}
+
+	k_mutex_lock(&wdg_mutex, K_FOREVER);
+	cmd_print(sess, "\n=== Watchdog (%s) ===\n",
+		  wdg_enabled ? "enabled" : "disabled");
+	cmd_print(sess, "%-4s %-12s %-12s %7s %6s %5s %9s %9s %9s %5s\n",
+		  "Slot", "Name", "State", "Tmo ms", "p99", "Fail",
+		  "Budget", "Max us", "Avg us", "Over");
+
+	for (int i = 0; i < wdg_count; i++) {
+		const struct wdg_entry *e = &wdg_table[i];
+		const struct wdg_exec_stats *x = &e->exec;
+
+		if (!e->active) {
+			continue;
+		}
+		cmd_print(sess, "%-4d %-12s %-12s %7u %6u %5u %9u %9u %9u %5u\n",
+			  i, e->name, wdg_get_state_name(e->state),
+			  e->eff_timeout_ms, e->p99_ms, e->timeout_count,
+			  x->budget_us,
+			  x->max_us,
+			  x->iterations ?
+				(uint32_t)(x->sum_us / x->iterations) : 0,
+			  x->overruns);
+	}
+	cmd_print(sess, "======================\n\n");
+	k_mutex_unlock(&wdg_mutex);
+	return 0;
+}
+
+/**
+ * wdg_init — Register watchdog commands.  Call after cmd_init().
+ */
+void wdg_init(void)
+{
+	cmd_register("wdg", "Watchdog status, budgets and iteration times",
+		     "wdg [slot]", wdg_cmd_handler, 0, 1);
+
+	SYSINFO_KOBJ_LABEL(wdg_mutex);
+}
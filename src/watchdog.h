@@ -0,0 +1,71 @@
+/*
+ * ShrikeOS Monitor — Software Watchdog Manager
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SHRIKE_WATCHDOG_H
+#define SHRIKE_WATCHDOG_H
+
+#include <zephyr/kernel.h>
+
+/* Thread health states reported by the watchdog */
+enum wdg_thread_state {
+	WDG_STATE_IDLE = 0,    /* Registered, not yet started        */
+	WDG_STATE_HEALTHY,     /* Heartbeat received within timeout   */
+	WDG_STATE_WARNING,     /* Approaching timeout (>75% elapsed)  */
+	WDG_STATE_UNRESPONSIVE,/* Timed out — recovery pending        */
+	WDG_STATE_RECOVERED,   /* Recovery callback executed           */
+	WDG_STATE_BUDGET_EXCEEDED, /* Alive, but last iteration overran */
+};
+
+/* Iteration-time histogram: bucket i counts times in [2^i, 2^(i+1)) us,
+ * bucket 0 also takes 0 us and the last bucket everything above.
+ */
+#define WDG_HIST_BUCKETS  20
+
+struct wdg_exec_stats {
+	uint32_t budget_us;        /* 0 = no budget configured  */
+	uint32_t iterations;
+	uint32_t overruns;
+	uint32_t last_us;
+	uint32_t max_us;
+	uint64_t sum_us;
+	uint32_t hist[WDG_HIST_BUCKETS];
+};
+
+/* Callback invoked when a thread becomes unresponsive.
+ * The callback receives the thread name and the elapsed time in ms
+ * since the last heartbeat was received.
+ */
+typedef void (*wdg_recovery_cb_t)(const char *thread_name,
+				  uint32_t elapsed_ms);
+
+/* Callback invoked from the thread's own context when a slot that was
+ * UNRESPONSIVE/RECOVERED reports again.
+ */
+typedef void (*wdg_revive_cb_t)(const char *thread_name);
+
+int                   wdg_register(const char *name, uint32_t timeout_ms,
+				   wdg_recovery_cb_t cb);
+void                  wdg_heartbeat(int slot);
+void                  wdg_set_revive_cb(int slot, wdg_revive_cb_t cb);
+void                  wdg_set_budget(int slot, uint32_t budget_us);
+void                  wdg_set_adaptive(int slot, uint32_t min_ms,
+				       uint32_t max_ms);
+void                  wdg_adaptive_reset(int slot);
+void                  wdg_begin(int slot);
+void                  wdg_end(int slot);
+int                   wdg_get_exec_stats(int slot,
+					 struct wdg_exec_stats *out);
+void                  wdg_unregister(int slot);
+void                  wdg_enable(bool enable);
+enum wdg_thread_state wdg_get_state(int slot);
+const char           *wdg_get_state_name(enum wdg_thread_state st);
+int                   wdg_get_healthy_count(void);
+int                   wdg_get_active_count(void);
+void                  wdg_dump_status(void);
+int                   wdg_format_json(char *buf, size_t buf_len);
+void                  wdg_init(void);
+
+#endif /* SHRIKE_WATCHDOG_H */
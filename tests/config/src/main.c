@@ -0,0 +1,208 @@
+/*
+ * ShrikeOS Monitor — Persistent Config Tests
+ *
+ * Runs config.c against the settings subsystem on native_sim's
+ * simulated flash (NVS backend), as the firmware does on the board's
+ * storage partition:
+ *
+ *   - a burst of changes is written once, after the quiet period, and
+ *     a change that never settles is still written by the max deferral;
+ *   - 'config reset' cancels a pending save, so erased keys stay erased;
+ *   - config_load() restores what an earlier boot saved.
+ *
+ *   west twister -T tests/config -p native_sim
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/ztest.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "config.h"
+#include "stubs.h"
+
+/* config.c's CFG_SAVE_QUIET_MS and CFG_SAVE_MAX_DEFER_MS */
+#define QUIET_MS      2000
+#define MAX_DEFER_MS  10000
+#define SLACK_MS      200
+
+/* --------------------------------------------------------------------
+ * Helpers
+ * ------------------------------------------------------------------ */
+
+struct stored {
+	void   *buf;
+	size_t  len;
+	ssize_t got;
+};
+
+static int stored_cb(const char *key, size_t len, settings_read_cb read_cb,
+		     void *cb_arg, void *param)
+{
+	struct stored *s = param;
+
+	/* NULL: the key itself, not one below it */
+	if (key == NULL) {
+		s->got = read_cb(cb_arg, s->buf, MIN(len, s->len));
+	}
+	return 0;
+}
+
+/* Bytes saved under @p name, or -ENOENT */
+static ssize_t stored_read(const char *name, void *buf, size_t len)
+{
+	struct stored s = { .buf = buf, .len = len, .got = -ENOENT };
+
+	zassert_ok(settings_load_subtree_direct(name, stored_cb, &s));
+	return s.got;
+}
+
+static bool stored_has(const char *name)
+{
+	uint8_t b;
+
+	return stored_read(name, &b, sizeof(b)) != -ENOENT;
+}
+
+static uint16_t stored_blink(void)
+{
+	uint16_t ms = 0;
+
+	zassert_equal(stored_read("shrike/blink", &ms, sizeof(ms)),
+		      sizeof(ms), "blink not saved");
+	return ms;
+}
+
+static int config_cmd(const char *arg)
+{
+	struct cmd_arg a = { .type = CMD_ARG_STRING, .sval = arg };
+
+	return stub_cmd_run("config", arg ? 1 : 0, &a);
+}
+
+/* A number from the 'config' report, after its label, e.g. "Writes:" */
+static int config_stat(const char *label)
+{
+	int v;
+
+	zassert_ok(config_cmd(NULL));
+
+	const char *p = strstr(stub_cmd_output(), label);
+
+	zassert_not_null(p, "no '%s' in the config report", label);
+	zassert_equal(sscanf(p + strlen(label), " %i", &v), 1);
+	return v;
+}
+
+/* --------------------------------------------------------------------
+ * Fixture
+ * ------------------------------------------------------------------ */
+
+static void *config_setup(void)
+{
+	struct shrike_config out;
+
+	config_init();
+	zassert_ok(config_load(&out), "settings backend not up");
+	return NULL;
+}
+
+/* Every test starts from erased keys and nothing pending */
+static void config_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	zassert_ok(config_cmd("reset"));
+	zassert_false(stored_has("shrike/blink"));
+}
+
+ZTEST_SUITE(config, NULL, config_setup, config_before, NULL, NULL);
+
+/* --------------------------------------------------------------------
+ * Tests
+ * ------------------------------------------------------------------ */
+
+ZTEST(config, test_burst_is_written_once)
+{
+	int writes = config_stat("Writes:");
+
+	/* Ten slider steps, each inside the quiet period of the last */
+	for (int i = 0; i < 10; i++) {
+		config_set_blink(100 + i * 10);
+		k_sleep(K_MSEC(QUIET_MS / 10));
+	}
+	zassert_false(stored_has("shrike/blink"),
+		      "written before the quiet period");
+
+	k_sleep(K_MSEC(QUIET_MS + SLACK_MS));
+	zassert_equal(stored_blink(), 190);
+	zassert_equal(config_stat("Writes:") - writes, 1,
+		      "burst not coalesced into one write");
+}
+
+ZTEST(config, test_unsettled_change_is_written_by_max_deferral)
+{
+	int i = 0;
+
+	/* Never quiet for QUIET_MS: only the deferral cap gets it out */
+	while (i * (QUIET_MS / 2) < MAX_DEFER_MS + QUIET_MS) {
+		config_set_blink(200 + i++);
+		k_sleep(K_MSEC(QUIET_MS / 2));
+	}
+	zassert_true(stored_blink() >= 200, "nothing written within %d ms",
+		     MAX_DEFER_MS);
+}
+
+ZTEST(config, test_reset_cancels_pending_save)
+{
+	int writes = config_stat("Writes:");
+
+	config_set_blink(333);
+	config_set_msg("unsaved");
+	zassert_ok(config_cmd("reset"));
+
+	k_sleep(K_MSEC(QUIET_MS + SLACK_MS));
+	zassert_false(stored_has("shrike/blink"),
+		      "pending save wrote an erased key back");
+	zassert_false(stored_has("shrike/msg"));
+	zassert_equal(config_stat("Writes:"), writes);
+	zassert_equal(config_stat("Pending :"), 0);
+}
+
+ZTEST(config, test_load_restores_saved_values)
+{
+	uint16_t blink = 777;
+	bool     led   = false;
+	struct shrike_config out;
+
+	/* As an earlier boot would have left them */
+	zassert_ok(settings_save_one("shrike/blink", &blink, sizeof(blink)));
+	zassert_ok(settings_save_one("shrike/led", &led, sizeof(led)));
+	zassert_ok(settings_save_one("shrike/msg", "booted", 6));
+
+	zassert_ok(config_load(&out));
+	zassert_equal(out.blink_ms, 777);
+	zassert_false(out.led_on);
+	zassert_str_equal(out.custom_msg, "booted");
+}
+
+ZTEST(config, test_flush_round_trips)
+{
+	struct shrike_config out;
+	char msg[16] = "";
+
+	config_set_msg("persist");
+	config_set_blink(640);
+	config_flush();
+	k_sleep(K_MSEC(SLACK_MS));
+
+	zassert_equal(stored_read("shrike/msg", msg, sizeof(msg) - 1), 7);
+	zassert_str_equal(msg, "persist");
+
+	zassert_ok(config_load(&out));
+	zassert_equal(out.blink_ms, 640);
+	zassert_str_equal(out.custom_msg, "persist");
+}
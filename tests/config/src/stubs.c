@@ -0,0 +1,97 @@
+/*
+ * ShrikeOS Monitor — Config Test Stubs
+ *
+ * Stand-ins for the modules config.c calls into.  Registered commands
+ * are kept so a test can run them, and their output is collected in
+ * one buffer instead of going to a transport.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "command.h"
+#include "logger.h"
+#include "sysinfo.h"
+#include "stubs.h"
+
+#define STUB_MAX_COMMANDS  4
+#define STUB_OUT_LEN       512
+
+static struct {
+	const char    *name;
+	cmd_handler_t  handler;
+} stub_cmds[STUB_MAX_COMMANDS];
+static int stub_cmd_count;
+
+static struct cmd_session stub_sess;
+static char   stub_out[STUB_OUT_LEN];
+static size_t stub_out_len;
+
+int cmd_register(const char *name, const char *help,
+		 const char *usage, cmd_handler_t handler,
+		 uint8_t min_args, uint8_t max_args)
+{
+	ARG_UNUSED(help); ARG_UNUSED(usage);
+	ARG_UNUSED(min_args); ARG_UNUSED(max_args);
+
+	if (stub_cmd_count == STUB_MAX_COMMANDS) {
+		return -1;
+	}
+	stub_cmds[stub_cmd_count].name    = name;
+	stub_cmds[stub_cmd_count].handler = handler;
+	stub_cmd_count++;
+	return 0;
+}
+
+void cmd_print(struct cmd_session *sess, const char *fmt, ...)
+{
+	ARG_UNUSED(sess);
+	va_list ap;
+
+	va_start(ap, fmt);
+	int n = vsnprintf(&stub_out[stub_out_len],
+			  sizeof(stub_out) - stub_out_len, fmt, ap);
+	va_end(ap);
+
+	if (n > 0) {
+		stub_out_len = MIN(stub_out_len + n, sizeof(stub_out) - 1);
+	}
+}
+
+void shrike_log_set_level(enum log_level min)
+{
+	ARG_UNUSED(min);
+}
+
+void sysinfo_kobj_label(const void *obj, const char *name)
+{
+	ARG_UNUSED(obj); ARG_UNUSED(name);
+}
+
+/**
+ * stub_cmd_run — Run a command registered by the module under test.
+ *
+ * @return  The handler's result, or -ENOENT if it was never registered.
+ *          Its output is in stub_cmd_output() until the next run.
+ */
+int stub_cmd_run(const char *name, int argc, struct cmd_arg *argv)
+{
+	stub_out[0]  = '\0';
+	stub_out_len = 0;
+
+	for (int i = 0; i < stub_cmd_count; i++) {
+		if (strcmp(stub_cmds[i].name, name) == 0) {
+			return stub_cmds[i].handler(&stub_sess, argc, argv);
+		}
+	}
+	return -ENOENT;
+}
+
+const char *stub_cmd_output(void)
+{
+	return stub_out;
+}
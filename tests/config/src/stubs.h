@@ -0,0 +1,15 @@
+/*
+ * ShrikeOS Monitor — Config Test Stubs
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SHRIKE_TEST_STUBS_H
+#define SHRIKE_TEST_STUBS_H
+
+#include "command.h"
+
+int         stub_cmd_run(const char *name, int argc, struct cmd_arg *argv);
+const char *stub_cmd_output(void);
+
+#endif /* SHRIKE_TEST_STUBS_H */